@@ -0,0 +1,6 @@
+#! /usr/bin/env python
+# encoding: utf-8
+# WARNING! Do not edit! http://waf.googlecode.com/git/docs/wafbook/single.html#_obtaining_the_waf_file
+
+from waflib import Logs
+Logs.warn('This tool has been merged to the main library, remove the references to "add_objects"')
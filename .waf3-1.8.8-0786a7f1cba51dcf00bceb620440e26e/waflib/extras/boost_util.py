@@ -0,0 +1,107 @@
+#! /usr/bin/env python
+# encoding: utf-8
+# WARNING! Do not edit! http://waf.googlecode.com/git/docs/wafbook/single.html#_obtaining_the_waf_file
+
+import os
+import shutil
+import tarfile
+from waflib import Utils
+from waflib.Configure import conf
+@conf
+def boost_version(conf,**kw):
+	if not conf.env.BOOST_VERSION:
+		if not conf.env['CXX']:
+			conf.fatal('load a c++ compiler first, conf.load("compiler_cxx")')
+		params={}
+		for key,value in conf.options.__dict__.items():
+			if not key.startswith('boost_'):
+				continue
+			key=key[len('boost_'):]
+			params[key]=value and value or kw.get(key,'')
+		inc=conf.boost_get_includes(**params)
+		conf.env.BOOST_VERSION=conf.boost_get_version(inc)
+	if conf.env.BOOST_VERSION:
+		return tuple(int(x)for x in conf.env.BOOST_VERSION.split('_'))
+	else:
+		return None
+@conf
+def boost_load_libs(conf,boost_libs=[],ignore_includes=[],ignore_libpaths=[]):
+	conf.check_boost(lib=boost_libs)
+	ignore_includes=[os.path.normpath(p.strip())for p in ignore_includes]
+	ignore_libpaths=[os.path.normpath(p.strip())for p in ignore_libpaths]
+	if isinstance(conf.env['INCLUDES_BOOST'],str):
+		conf.env['INCLUDES_BOOST']=[conf.env['INCLUDES_BOOST']]
+	conf.env.append_unique('DEFINES_BOOST','NDEBUG')
+	remove_includes=[]
+	for include in conf.env['INCLUDES_BOOST']:
+		if os.path.normpath(include)in ignore_includes:
+			remove_includes.append(include)
+	for include in remove_includes:
+		conf.env['INCLUDES_BOOST'].remove(include)
+	for prefix in['LIB','STLIB']:
+		remove_libpaths=[]
+		for libpath in conf.env[prefix+'PATH_BOOST']:
+			if os.path.normpath(libpath)in ignore_libpaths:
+				remove_libpaths.append(libpath)
+		for libpath in remove_libpaths:
+			conf.env[prefix+'PATH_BOOST'].remove(libpath)
+		for lib in conf.env[prefix+'_BOOST']:
+			for lname in boost_libs:
+				libname=lib.split('boost_')[-1].split('.')[0]
+				if lname==libname:
+					conf.env.append_unique(prefix+'_boost_'+lname,lib)
+		conf.env[prefix+'_BOOST']=[]
+@conf
+def boost_libinfo(ctx,libnames):
+	libs=['boost_'+l for l in libnames]
+	stlib_ptrn=ctx.env['cxxstlib_PATTERN']
+	stlibs=[stlib_ptrn%l for l in libs]
+	stlibdir='boost/stage/lib'
+	stlibpaths=[os.path.join(stlibdir,l)for l in stlibs]
+	stlibnodes=[ctx.path.find_or_declare(l)for l in stlibpaths]
+	return libs,stlibdir,stlibnodes
+def __boost_decompress(task):
+	bldnode=task.generator.path.get_bld()
+	fname=task.inputs[0].abspath()
+	tar=tarfile.open(fname)
+	tar.extractall(path=bldnode.abspath())
+	tar.close()
+	task.set_outputs(bldnode.ant_glob('boost/boost/**/*.h*'))
+def __boost_bootstrap(task):
+	abspath=task.inputs[0].abspath()
+	wd,cmd=os.path.split(abspath)
+	cmd=os.path.join('.',cmd)
+	return task.exec_command(cmd,cwd=wd,stdout=None,stderr=None)
+def __boost_build(task):
+	opts=task.generator.bld.options
+	abspath=task.inputs[0].abspath()
+	wd,cmd=os.path.split(abspath)
+	cmd=os.path.join('.',cmd)
+	jobs=max(1,opts.jobs-1)
+	cmd+=' -j{} --layout=system link=static'.format(jobs)
+	return task.exec_command(cmd,cwd=wd,stdout=None,stderr=None)
+@conf
+def boost_included_libs(conf,boost_libs,includes=['#ext/boost']):
+	libs,stlibdir,stlibnodes=conf.boost_libinfo(boost_libs)
+	conf.env.DEFINES_BOOST=['NDEBUG']
+	conf.env.INCLUDES_BOOST=includes
+	conf.env.STLIBPATH_BOOST=[stlibdir]
+	for lib in libs:
+		conf.env['STLIB_'+lib]=[lib]
+	conf.env['BOOST_INCLUDED_LIBS']=boost_libs
+@conf
+def boost_build(bld,incdir='',libdir=''):
+	libs,stlibdir,stlibnodes=bld.boost_libinfo(bld.env['BOOST_INCLUDED_LIBS'])
+	if stlibnodes:
+		bld(rule=__boost_decompress,target='boost/bootstrap.sh',source='boost.tar.gz',update_outputs=True)
+		bld(rule=__boost_bootstrap,target='boost/b2',source='boost/bootstrap.sh')
+		bld(rule=__boost_build,target=stlibnodes,source='boost/b2',cwd='boost')
+		bld.add_group()
+		if bld.cmd=='install':
+			if incdir:
+				start_dir=bld.path.get_bld().find_dir('boost')
+				headers=start_dir.ant_glob('boost/**/*.h*')
+				bld.install_files(incdir,headers,cwd=start_dir,relative_trick=True)
+			if libdir:
+				bld.install_files(libdir,stlibnodes)
+		bld.add_group()
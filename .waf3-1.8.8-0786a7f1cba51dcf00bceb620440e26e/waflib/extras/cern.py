@@ -0,0 +1,12 @@
+#! /usr/bin/env python
+# encoding: utf-8
+# WARNING! Do not edit! http://waf.googlecode.com/git/docs/wafbook/single.html#_obtaining_the_waf_file
+
+import os
+from waflib.Configure import conf
+def configure(conf):
+	conf.check_cfg(uselib_store='ROOT',path='root-config',args=['--cflags','--glibs'],package='')
+@conf
+def root_dict(bld,target,source,**kwargs):
+	target_header=os.path.splitext(target)[0]+'.h'
+	return bld(rule='rootcint -f ${TGT[0]} -c ${SRC}',target=[target,target_header],source=source,name='root_dict',**kwargs)
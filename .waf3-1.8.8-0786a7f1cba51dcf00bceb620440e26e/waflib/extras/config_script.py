@@ -0,0 +1,157 @@
+#! /usr/bin/env python
+# encoding: utf-8
+# WARNING! Do not edit! http://waf.googlecode.com/git/docs/wafbook/single.html#_obtaining_the_waf_file
+
+CONFIG_SCRIPT_TEMPLATE=r"""#!/usr/bin/env python
+
+import sys
+from argparse import ArgumentParser
+
+if __name__ == '__main__':
+
+    parser = ArgumentParser(description = '''\
+{appname} package configuration information.
+
+{brief}
+
+{description}''')
+
+    parser.add_argument('--version', action='store_true',
+        help = 'prints the installed version number of this package.')
+
+    parser.add_argument('--cflags', action='store_true',
+        help='prints the pre-processor and compiler flags.')
+    parser.add_argument('--include', action='store_true',
+        help='prints header file include directory compiler flags.')
+    parser.add_argument('--libs', action='store_true',
+        help='prints the library linker flags.')
+
+    parser.add_argument('--incdir', action='store_true',
+        help='prints include directory.')
+    parser.add_argument('--libdir', action='store_true',
+        help='prints library directory.')
+    parser.add_argument('--libs-only', dest='libsonly', action='store_true',
+        help='prints library names to be linked.')
+
+    if len(sys.argv) < 2:
+        sys.argv += ['--cflags','--include','--libs']
+
+    args = parser.parse_args()
+
+    if args.version:
+        parser.parse_args(['-h'])
+        print('version: {version}')
+        sys.exit(0)
+
+    output = []
+
+    if args.cflags:
+        output += ['{DEFINES_ST}' % d for d in {defines}]
+        output += {cflags}
+        if len({lib}) > 0:
+            output += set({CFLAGS_cshlib} + {CXXFLAGS_cxxshlib})
+    if args.include:
+        output += ['{CPPPATH_ST}' % d for d in {includes}]
+
+    if args.libs:
+        if len({stlib}) > 0:
+            output += ['{STLIB_MARKER}']
+            output += ['{STLIBPATH_ST}' % d for d in {stlibpath}]
+            output += ['{STLIB_ST}' % l for l in {stlib}]
+            output += ['{SHLIB_MARKER}']
+        if len({lib}) > 0:
+            output += ['{LIBPATH_ST}' % d for d in {libpath}]
+            output += ['{LIB_ST}' % l for l in {lib}]
+
+    if args.incdir:
+        output += {includes}
+    if args.libdir:
+        output += {stlibpath}
+        output += {libpath}
+    if args.libsonly:
+        output += ['{cxxstlib_PATTERN}' % l for l in {stlib}]
+        output += ['{cxxshlib_PATTERN}' % l for l in {lib}]
+
+    print(' '.join(output))
+
+"""
+import os
+import stat
+from copy import copy
+from waflib.Configure import conf
+from waflib import Utils
+def __config_script(task):
+	gen=task.generator
+	bld=task.generator.bld
+	env=task.generator.bld.env
+	def subst(s,env=env):
+		return Utils.subst_vars(s,env)
+	opts=dict(env)
+	opts.update(appname=getattr(gen,'appname',env['APPNAME']or''),brief=getattr(gen,'breif',env['BREIF']or''),description=getattr(gen,'description',env['DESC']or''),version=getattr(gen,'version',env['VERSION']or''),)
+	attrs='''
+        defines
+        cflags
+        includes
+        lib
+        libpath
+        stlib
+        stlibpath
+    '''.strip().split()
+	for attr in attrs:
+		x=getattr(gen,attr,[])
+		if not hasattr(x,'__iter__'):
+			x=[x]
+		x=[subst(p)for p in x]
+		if x or(attr not in opts):
+			opts[attr]=x
+	def filter_paths(paths):
+		paths_to_remove=[]
+		for p in paths:
+			remove=False
+			if str(p).startswith('#'):
+				remove=True
+			else:
+				bldpath=bld.path.get_bld().abspath()
+				srcpath=bld.path.get_src().abspath()
+				rp_src=os.path.relpath(subst(str(p)),srcpath)
+				rp_bld=os.path.relpath(subst(str(p)),bldpath)
+				if not rp_src.startswith('..'):
+					remove=True
+				elif not rp_bld.startswith('..'):
+					remove=True
+			if remove:
+				paths_to_remove+=[p]
+		ret=copy(paths)
+		for p in paths_to_remove:
+			ret.remove(p)
+		return ret
+	for u in getattr(gen,'use',[]):
+		opts['defines']+=env['DEFINES_'+u]
+		opts['cflags']+=env['CPPFLAGS_'+u]
+		opts['cflags']+=env['CFLAGS_'+u]
+		opts['cflags']+=env['CXXFLAGS_'+u]
+		opts['includes']+=filter_paths(env['INCLUDES_'+u])
+		opts['stlib']+=env['STLIB_'+u]
+		opts['stlibpath']+=filter_paths(env['STLIBPATH_'+u])
+		opts['lib']+=env['LIB_'+u]
+		opts['libpath']+=filter_paths(env['LIBPATH_'+u])
+	for x in['defines','cflags','includes']:
+		unique_list=[]
+		for item in opts[x]:
+			if item not in unique_list:
+				unique_list.append(item)
+		opts[x]=unique_list
+	fname=task.outputs[0].abspath()
+	with open(fname,"w")as fout:
+		fout.write(CONFIG_SCRIPT_TEMPLATE.format(**opts))
+	os.chmod(fname,stat.S_IRUSR|stat.S_IWUSR|stat.S_IXUSR|stat.S_IRGRP|stat.S_IXGRP|stat.S_IROTH|stat.S_IXOTH)
+	return 0
+@conf
+def config_script(bld,**kwargs):
+	if'run_always'not in kwargs:
+		kwargs['run_always']=True
+	installdir=kwargs.get('install_path',None)
+	ret=bld(rule=__config_script,**kwargs)
+	if installdir is not None:
+		bld.install_files(installdir,kwargs['target'],chmod=Utils.O755)
+	return ret
@@ -0,0 +1,134 @@
+#! /usr/bin/env python
+# encoding: utf-8
+# WARNING! Do not edit! http://waf.googlecode.com/git/docs/wafbook/single.html#_obtaining_the_waf_file
+
+import os
+import sys
+import re
+from subprocess import Popen,PIPE
+from waflib import Utils
+from waflib.Configure import conf
+def __get_system_includes(compiler):
+	pathlist=[]
+	if hasattr(compiler,'__iter__'):
+		compiler=compiler[0]
+	if os.path.basename(compiler)in['gcc','g++','clang','clang++']:
+		preprocessor=Popen(compiler+' -print-prog-name=cpp',shell=True,env=os.environ,executable=os.environ.get('SHELL','/bin/bash'),stdout=PIPE,stderr=PIPE).communicate()[0].split('\n')[0]
+		output=Popen(preprocessor+' -v',shell=True,env=os.environ,executable=os.environ.get('SHELL','/bin/bash'),stdout=PIPE,stderr=PIPE,stdin=PIPE).communicate(input='')[1].split('\n')
+		in_search_list=False
+		for line in output:
+			if line.startswith('#include')and line.endswith('search starts here:'):
+				in_search_list=True
+			elif line.startswith('End of search list'):
+				in_search_list=False
+			elif in_search_list:
+				pathlist.append(os.path.normpath(line.strip()))
+	return set(pathlist)
+@conf
+def system_includes_cxx(conf):
+	return __get_system_includes(conf.env['CXX'])
+@conf
+def system_includes_c(conf):
+	return __get_system_includes(conf.env['CC'])
+@conf
+def system_includes(conf):
+	includes=[]
+	for ccenv in['CC','CXX']:
+		if ccenv in conf.env:
+			includes+=list(__get_system_includes(conf.env[ccenv]))
+	return set(includes)
+def __get_system_libpaths(compiler):
+	pathlist=[]
+	if hasattr(compiler,'__iter__'):
+		compiler=compiler[0]
+	if os.path.basename(compiler)in['gcc','g++','clang','clang++']:
+		output=Popen(compiler+' -print-search-dirs',shell=True,env=os.environ,executable=os.environ.get('SHELL','/bin/bash'),stdout=PIPE,stderr=PIPE).communicate()[0]
+		for line in output.split('\n'):
+			if line.startswith('libraries:'):
+				for p in line.split('=')[-1].split(':'):
+					pathlist.append(os.path.normpath(p))
+	return set(pathlist)
+@conf
+def system_libpaths_cxx(conf):
+	return __get_system_libpaths(conf.env['CXX'])
+@conf
+def system_libpaths_c(conf):
+	return __get_system_libpaths(conf.env['CC'])
+@conf
+def system_libpaths(conf):
+	libpaths=[]
+	for ccenv in['CC','CXX']:
+		if ccenv in conf.env:
+			libpaths+=list(__get_system_libpaths(conf.env[ccenv]))
+	return set(libpaths)
+@conf
+def check_cxx11(conf):
+	try:
+		cxx11_code='#include <array>\nint main() {}\n'
+		cxx11env=conf.env.derive()
+		conf.parse_flags('-std=c++11','C++11',env=cxx11env)
+		conf.check_cxx(fragment=cxx11_code,env=cxx11env,use='C++11',msg='C++11 support')
+		conf.parse_flags('-std=c++11','C++11')
+	except conf.errors.ConfigurationError:
+		cxx11env=conf.env.derive()
+		conf.parse_flags('-std=c++0x','C++11',env=cxx11env)
+		conf.check_cxx(fragment=cxx11_code,env=cxx11env,use='C++11',msg='C++0x support')
+		conf.parse_flags('-std=c++0x','C++11')
+def __remove_flags(conf,package_name,*list_of_flags):
+	flagtypes='CXXFLAGS CFLAGS LINKFLAGS'.split(' ')
+	cenvlist=[]
+	for ft in flagtypes:
+		cenvlist+=[conf.env[ft+'_'+package_name]]
+	for f in list_of_flags:
+		for cenv in cenvlist:
+			if f in cenv:
+				cenv.remove(f)
+@conf
+def check_mysql(conf):
+	conf.check_cfg(uselib_store='MYSQL',path='mysql_config',args=['--cflags','--libs'],package='')
+	def remove_flags(conf,package_name,*list_of_flags):
+		flagtypes='CXXFLAGS CFLAGS LINKFLAGS'.split(' ')
+		cenvlist=[]
+		for ft in flagtypes:
+			cenvlist+=[conf.env[ft+'_'+package_name]]
+		for f in list_of_flags:
+			for cenv in cenvlist:
+				if f in cenv:
+					cenv.remove(f)
+	__remove_flags(conf,'MYSQL','-fstack-protector-strong')
+def options(opt):
+	cfg_opts=opt.exec_dict['opt'].get_option_group('configure options')
+	cfg_opts.add_option('--bindir',dest='bindir',action='store',default='${PREFIX}/bin',help='install path for binary executables, default: %default')
+	cfg_opts.add_option('--libdir',dest='libdir',action='store',default='${PREFIX}/lib',help='install path for library object files, default: %default')
+	cfg_opts.add_option('--incdir',dest='incdir',action='store',default='${PREFIX}/include',help='install path for library header files, default: %default')
+	cfg_opts.add_option('--debug',dest='debug',action='store_true',default=False,help='Build in debug mode. default: %default')
+	if'win32'in sys.platform:
+		ldlibpathenv='PATH'
+	elif'darwin'in sys.platform:
+		ldlibpathenv='DYLD_LIBRARY_PATH'
+	else:
+		ldlibpathenv='LD_LIBRARY_PATH'
+	default_libpath=os.environ.get(ldlibpathenv,None)
+	cfg_opts.add_option('--includes',dest='includes',default=None,help='list of include paths applied to all targets, separated by colons (:) or commas (,). default: %default')
+	cfg_opts.add_option('--libpath',dest='libpath',default=default_libpath,help='list of include paths applied to all targets, separated by colons (:) or commas (,). default: %default')
+	bld_opts=opt.exec_dict['opt'].get_option_group('build and install options')
+	bld_opts.add_option('--all',dest='all',action='store_true',default=False,help='Build everything. default: %default')
+	bld_opts.add_option('--test',dest='test',action='store_true',default=False,help='Build tests. default: %default')
+def configure(conf):
+	conf.options.bindir=Utils.subst_vars(conf.options.bindir,conf.env)
+	conf.options.libdir=Utils.subst_vars(conf.options.libdir,conf.env)
+	conf.options.incdir=Utils.subst_vars(conf.options.incdir,conf.env)
+	conf.parse_flags('-fPIC','PIC')
+	if conf.options.debug:
+		for v in['CFLAGS','CXXFLAGS','LINKFLAGS']:
+			conf.env.append_unique(v,['-g'])
+	system_libpath=conf.system_libpaths()
+	system_includes=conf.system_includes()
+	if conf.options.libpath is not None:
+		for libpath in re.split('[:,]+',conf.options.libpath):
+			if libpath and(libpath not in system_libpath):
+				conf.env.append_unique('LIBPATH',libpath)
+	if conf.options.includes is not None:
+		for incpath in re.split('[:,]+',conf.options.includes):
+			if incpath and(incpath not in system_includes):
+				conf.env.append_unique('INCLUDES',incpath)
@@ -0,0 +1,121 @@
+#! /usr/bin/env python
+# encoding: utf-8
+# WARNING! Do not edit! http://waf.googlecode.com/git/docs/wafbook/single.html#_obtaining_the_waf_file
+
+import os
+import numpy as np
+from waflib.Configure import conf
+try:
+	from graph_tool.all import*
+	HAVE_GRAPH_TOOL=True
+except ImportError:
+	HAVE_GRAPH_TOOL=False
+def options(opt):
+	bld_opts=opt.exec_dict['opt'].get_option_group('build and install options')
+	bld_opts.add_option('--depgraph',dest='depgraph',action='store_true',default=False,help='Show (interactive) dependency graph.')
+@conf
+def generate_full_depgraph(bld,*args,**kwargs):
+	if not HAVE_GRAPH_TOOL:
+		raise ImportError('Could not find the python module: graph_tool')
+	g=Graph(*args,**kwargs)
+	vname=g.new_vertex_property('string')
+	vdetail=g.new_vertex_property('string')
+	vshape=g.new_vertex_property('string')
+	vcolor=g.new_vertex_property('string')
+	vtype=g.new_vertex_property('string')
+	rev_vname={}
+	for group in bld.groups:
+		for taskgen in group:
+			if taskgen.post():
+				for task in taskgen.tasks:
+					task_type='task'
+					task_name=str(getattr(task,'name',str(task))).strip()
+					task_detail=repr(task).strip()
+					task_shape='square'
+					task_color='orange'
+					uid=task.uid()
+					inputs=[('input',task.inputs,'circle','blue'),('input dependency',bld.node_deps.get(uid,[]),'square','blue'),('input raw',bld.raw_deps.get(uid,[]),'square','pink'),]
+					out_type='output'
+					outputs=[(task.outputs,'hexagon','green'),]
+					inter_type='intermediate'
+					inter_shape='hexagon'
+					inter_color='lightgreen'
+					vtask=g.add_vertex()
+					vname[vtask]=task_name[:24]
+					vdetail[vtask]=task_name+': '+task_detail
+					vshape[vtask]=task_shape
+					vcolor[vtask]=task_color
+					vtype[vtask]=task_type
+					for intype,names,shape,color in inputs:
+						for name in names:
+							if name not in rev_vname.keys():
+								vtx=g.add_vertex()
+								vname[vtx]=os.path.basename(str(name))[-24:]
+								vdetail[vtx]=str(name).strip()
+								vshape[vtx]=shape
+								vcolor[vtx]=color
+								vtype[vtx]=intype
+								rev_vname[name]=vtx
+							else:
+								vtx=g.vertex(rev_vname[name])
+								if vtype[vtx]==out_type:
+									vtype[vtx]=inter_type
+									vshape[vtx]=inter_shape
+									vcolor[vtx]=inter_color
+							g.add_edge(vtx,vtask)
+					for names,shape,color in outputs:
+						for name in names:
+							if name not in rev_vname.keys():
+								vtx=g.add_vertex()
+								vname[vtx]=os.path.basename(str(name))[-24:]
+								vdetail[vtx]=str(name).strip()
+								vshape[vtx]=shape
+								vcolor[vtx]=color
+								vtype[vtx]=out_type
+								rev_vname[name]=vtx
+							else:
+								vtx=g.vertex(rev_vname[name])
+								if vtype[vtx].startswith('input'):
+									vtype[vtx]=inter_type
+									vshape[vtx]=inter_shape
+									vcolor[vtx]=inter_color
+							e=g.add_edge(vtask,vtx)
+	return g,(vname,vdetail,vshape,vcolor,vtype)
+@conf
+def merge_full_depgraph(bld,g,vprops):
+	if not HAVE_GRAPH_TOOL:
+		raise ImportError('Could not find the python module: graph_tool')
+	vname,vdetail,vshape,vcolor,vtype=vprops
+	vf_nodes=~(vtype.get_2d_array((0,))=='task')
+	vf_merged=np.zeros((g.num_vertices(),),dtype=bool)
+	gnodes=GraphView(g,vfilt=vf_nodes)
+	for v in gnodes.vertices():
+		if not vf_merged[v]:
+			vparents=sorted(g.vertex(v).in_neighbours())
+			vchildren=sorted(g.vertex(v).out_neighbours())
+			for vm in gnodes.vertices():
+				if(v<vm)and(vtype[v]==vtype[vm]):
+					vmparents=sorted(g.vertex(vm).in_neighbours())
+					vmchildren=sorted(g.vertex(vm).out_neighbours())
+					if(vparents==vmparents)and(vchildren==vmchildren):
+						if not str(vname[v]).endswith('...'):
+							vname[v]+='...'
+						vdetail[v]+=', '+vdetail[vm]
+						vf_merged[vm]=True
+	return GraphView(g,vfilt=~vf_merged),vprops
+@conf
+def generate_depgraph(bld,*args,**kwargs):
+	if not HAVE_GRAPH_TOOL:
+		raise ImportError('Could not find the python module: graph_tool')
+	g,vprops=bld.generate_full_depgraph(*args,**kwargs)
+	gmerged,vprops=bld.merge_full_depgraph(g,vprops)
+	vname,vdetail,vshape,vcolor,vtype=vprops
+	return gmerged,(vname,vdetail,vshape,vcolor,vtype)
+@conf
+def draw_depgraph(bld,**kwargs):
+	if not HAVE_GRAPH_TOOL:
+		raise ImportError('Could not find the python module: graph_tool')
+	g,(vname,vdetail,vshape,vcolor,vtype)=bld.generate_depgraph()
+	kw=dict(vertex_text=vname,display_props=[vdetail],vertex_shape=vshape,vertex_color=vcolor,vertex_fill_color=vcolor)
+	kw.update(**kwargs)
+	return graph_draw(g,**kw)
@@ -4,10 +4,13 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <memory>
 #include <time.h>
 
 #include "CCDB/Globals.h"
+#include "CCDB/Model/Assignment.h"
 #include "CCDB/Providers/DataProvider.h"
+#include "CCDB/Providers/DataProviderPool.h"
 #include "CCDB/PthreadMutex.h"
 #include "CCDB/PthreadSyncObject.h"
 
@@ -52,6 +55,9 @@ public:
      * @see SQLiteCalibration
      * sqlite://<path to sqlite file>
      *
+     * @see FileCalibration
+     * file://<path to the root directory of table files>
+     *
      * @param connectionString the Connection String
      * @return true if connected
      */
@@ -180,6 +186,40 @@ public:
     virtual bool GetCalib(double &value, const string & namepath);
     virtual bool GetCalib(int &value, const string & namepath);
 
+    /** @brief Get constants by namepath as one flat vector of numbers
+     *
+     * The cells are converted straight from the data blob, no string is made
+     * for a cell. This is the fastest way to read a table in an event loop.
+     * T may be int, unsigned int, long, unsigned long, long long,
+     * unsigned long long, float, double or bool. @see Assignment::GetFlatData
+     *
+     * @parameter [out] values - all cells, row by row or column by column
+     * @parameter [out] columnsCount - number of columns. Rows are values.size()/columnsCount
+     * @parameter [in]  namepath - data path
+     * @parameter [in]  layout - Assignment::cRowMajor or Assignment::cColumnMajor
+     * @return true if constants were found and filled. false if namepath was not found.
+     */
+    template<class T>
+    bool GetCalib(vector<T> &values, size_t &columnsCount, const string & namepath, Assignment::DataLayout layout = Assignment::cRowMajor)
+    {
+        //no auto_ptr in a header, it is deprecated or gone for the C++11 and later users
+        Assignment *assignment = GetAssignment(namepath, false);
+        if(assignment == NULL) return false;
+
+        try
+        {
+            columnsCount = assignment->GetTypeTable()->GetColumnsCount();
+            assignment->GetFlatData(values, layout);
+        }
+        catch (...)
+        {
+            delete assignment;
+            throw;
+        }
+        delete assignment;
+        return true;
+    }
+
     /** @brief gets connection string which is used for current provider
     *@return mConnectionString
     */
@@ -231,7 +271,7 @@ public:
       * @parameter [in] vector<string> & namepaths
       * @return   void
       */
-     void GetListOfNamepaths(vector<string> &namepaths);
+     virtual void GetListOfNamepaths(vector<string> &namepaths);
 
 	/** @brief Returns UNIX timestamp of the last successful connection 
 	 * 
@@ -250,6 +290,10 @@ public:
 	/** @brief Gets the assignment from provider using namepath
 	* namepath is the common ccdb request; @see GetCalib
 	*
+	* Loaded assignments are cached together with the runs they are valid for. Requests that
+	* hit the cache only take a shared read lock and never wait for the provider, so many
+	* threads can read constants at once. The returned assignment is owned by the caller.
+	*
 	* @remark the function is thread safe
 	*
 	* @parameter [in] namepath -  full namepath is /path/to/data:run:variation:time but usually it is only /path/to/data
@@ -257,6 +301,80 @@ public:
 	*/
 	virtual Assignment * GetAssignment(const string& namepath, bool loadColumns = true);
 
+	/** @brief Gets assignments of many tables at once
+	*
+	* Namepaths are the same as for @see GetAssignment. Namepaths with the same run, variation
+	* and time are resolved together by one provider request. For SQL providers it is a fixed
+	* number of queries, instead of several queries for each table.
+	*
+	* @remark the function is thread safe
+	*
+	* @parameter [out] assignments - assignments by namepath. Namepaths without data are not added.
+	*                                The caller owns the assignments
+	* @parameter [in]  namepaths - /path/to/data:run:variation:time namepaths
+	* @return   false if there was an error in the provider
+	*/
+	virtual bool GetAssignments(map<string, Assignment *> &assignments, const vector<string>& namepaths);
+
+	/** @brief Gets assignments of all tables in the directory and its subdirectories at once
+	*
+	* Default run, variation and time are used. @see GetAssignments
+	*
+	* @parameter [out] assignments - assignments by absolute table path. The caller owns the assignments
+	* @parameter [in]  directoryPath - path to the directory, i.e. "/calibration/ftof"
+	* @return   false if there was an error in the provider
+	*/
+	virtual bool GetDirectoryAssignments(map<string, Assignment *> &assignments, const string& directoryPath);
+
+	/** @brief Adds constants of many tables to the database in one transaction
+	*
+	* @see DataProvider::CreateAssignments. Assignments cached by this calibration and by
+	* the providers of its pool are dropped, so the next requests see the new data.
+	*
+	* @remark the function is thread safe
+	*
+	* @parameter [in,out] assignments - assignments to add, their ids are set. The caller owns them
+	* @return   false if nothing was added, the errors are reported by GetProvider()
+	*/
+	virtual bool CreateAssignments(const vector<Assignment *>& assignments);
+
+	/** @brief Drops all cached assignments, so they are loaded from the provider again
+	*
+	* Assignments that are cached for the latest data (time=0) don't see data added to the
+	* database after they were loaded. The provider caches are not dropped.
+	*
+	* @remark the function is thread safe
+	*/
+	void ClearAssignmentsCache();
+
+	/** @brief Number of cached assignments */
+	size_t GetAssignmentsCacheSize();
+
+	/** @brief Number of pooled connections that load assignments, 0 if there is no pool
+	*
+	* The pool is made by Connect when the connection string ends with "?pool=N", N>1.
+	* Then GetAssignment and GetAssignments of different threads query the database at
+	* the same time, each through its own connection. Without a pool they wait for each other.
+	*/
+	size_t GetProviderPoolSize() const { return mProviderPool ? mProviderPool->GetSize() : 0; }
+
+	/** @brief Removes "?pool=N" from the end of the connection string
+	*
+	* @parameter [in,out] connectionString - connection string without the pool option after the call
+	* @return   N or 1 if there is no pool option
+	*/
+	static int ExtractPoolSize(string& connectionString);
+
+	/** @brief Sets the time zone the `created` times of the database are written in
+	*
+	* @see DataProvider::SetTimeZone. It is set to the provider and to the providers of the
+	* pool, now and when they connect. The cached assignments are dropped.
+	*
+	* @remark the function is thread safe
+	*/
+	void SetTimeZone(DataProvider::TimeZones timeZone);
+	DataProvider::TimeZones GetTimeZone() const { return mTimeZone; }   ///@see SetTimeZone
+
 protected:
 
 
@@ -264,6 +382,28 @@ protected:
     virtual void Unlock(); ///Thread mutex Unlock lock for multi threaded operations
 
 
+    /** @brief Creates a not connected provider for the pool
+     *
+     * @return new provider or NULL if the calibration doesn't support pools
+     */
+    virtual DataProvider * CreatePoolProvider() { return NULL; }
+
+    /** @brief Creates the provider pool on the first call and connects its providers
+     *
+     * @parameter [in] connectionString - connection string without the pool option
+     * @parameter [in] size - number of providers. No pool is created if it is less than 2
+     * @return   false if a provider could not connect
+     */
+    bool ConnectProviderPool(const string& connectionString, int size);
+
+    /** @brief Checks out a provider for a query. The pooled one or mProvider after locking mReadMutex
+     * @throw std::logic_error if the pooled provider could not reconnect, @see DataProviderPool::Acquire
+     */
+    DataProvider * AcquireProvider();
+
+    /** @brief Gives back the provider taken by AcquireProvider() */
+    void ReleaseProvider(DataProvider * provider);
+
     /**@brief Try to auto-reconnect if possible 
      *
      */
@@ -284,6 +424,8 @@ protected:
      */
     void UpdateActivityTime();
 
+    void CheckConnection(); /// Check if is connected and reconnect if needed (and allowed)
+
     DataProvider *mProvider;         /// Underlaid DataProvider object
     bool mProviderIsLocked;          /// If provider
     int mDefaultRun;                 /// Default run number
@@ -295,10 +437,33 @@ protected:
     
 
     PthreadMutex * mReadMutex;
+    DataProviderPool * mProviderPool;    /// Connections to load assignments in parallel, NULL if not pooled
+    DataProvider::TimeZones mTimeZone;   /// Time zone of `created` times. @see SetTimeZone
+
+    /** @brief Immutable copy of an assignment, valid for runs [RunMin, RunMax] */
+    struct CachedAssignment
+    {
+        int Id;
+        string RawData;
+        int RunMin;
+        int RunMax;
+        ConstantsTypeTable *TypeTable;   ///Owned by the provider
+    };
+    typedef map<int, CachedAssignment *> CachedAssignmentsByRun;  ///by RunMin
+
+    /** @brief Makes a new assignment for the run from the cache
+     * @return new assignment owned by the caller or NULL if it is not cached
+     */
+    Assignment * FindCachedAssignment(const string& key, int run);
+
+    /** @brief Copies the assignment loaded for the run to the cache */
+    void CacheAssignment(const string& key, int run, Assignment * assignment);
+
+    map<string, CachedAssignmentsByRun> mAssignmentsCache;   ///by "time:variation:path"
+    pthread_rwlock_t mAssignmentsCacheLock;                  ///Shared for lookups, exclusive for inserts
 private:
     Calibration(const Calibration& rhs);
     Calibration& operator=(const Calibration& rhs);
-    void CheckConnection(); /// Check if is connected and reconnect if needed (and allowed)
 };
 
 }
@@ -0,0 +1,76 @@
+#ifndef FileCalibration_h
+#define FileCalibration_h
+
+#include <string>
+#include "CCDB/Calibration.h"
+
+using namespace std;
+
+namespace ccdb
+{
+
+/** @brief Calibration that reads constants from a directory of table files
+ *
+ * The connection string is file://<root directory>, @see FileDataProvider
+ */
+class FileCalibration: public Calibration
+{
+    
+public:
+    /** @brief Ctor takes default run number and default variation
+	 *
+	 *  The default run number and default variation are used when no run or variation
+	 *  is explicitly defined in user request. 
+	 *
+	 * @param defaultRun       [in] Sets default run number
+	 * @param defaultVariation [in] Sets default variation
+	 */
+    FileCalibration(int defaultRun, string defaultVariation="default", time_t defaultTime=0);
+
+	/** @brief Just a default ctor 
+	 */
+	FileCalibration();
+
+	/** @brief    ~FileCalibration
+	 *
+	 * @return   
+	 */
+	virtual ~FileCalibration();
+
+	/**
+     * @brief Indexes the directory of table files
+     *
+     * @param connectionString file://<root directory>
+     * "?pool=N" at the end makes a pool of N providers, @see SQLiteCalibration::Connect
+     * @return true if connected
+     */
+	virtual bool Connect(std::string connectionString);
+
+	/**
+	 * @brief closes connection to data
+	 * Closes connection to data. 
+	 * If underlayed @see DProvider* object is "locked"
+	 * (user could check this by 
+	 * 
+	 */
+	virtual void Disconnect();
+
+	/** @brief indicates ether the connection is open or not
+	 * 
+	 * @return true if  connection is open
+	 */
+	virtual bool IsConnected();
+
+protected:
+	/** @brief Creates a provider for a pool of connections, @see Calibration::ConnectProviderPool
+	 */
+	virtual DataProvider * CreatePoolProvider();
+
+private:
+    FileCalibration(const FileCalibration& rhs);
+    FileCalibration& operator=(const FileCalibration& rhs);
+};
+
+}
+
+#endif // FileCalibration_h
@@ -0,0 +1,102 @@
+#ifndef _BinaryBlob_
+#define _BinaryBlob_
+
+#include <string>
+#include <vector>
+
+#include "CCDB/Model/ConstantsTypeColumn.h"
+
+using namespace std;
+
+namespace ccdb
+{
+
+/** @brief Typed binary form of the constantSets.vault data
+ *
+ * The text vault keeps all cells as one '|' separated string, so every
+ * number is formatted on write and parsed again on every read. The binary
+ * form stores the columns already typed:
+ *
+ *   uint32 rows, uint32 columns,
+ *   one byte per column with its ConstantsTypeColumn::ColumnTypes value,
+ *   then each column packed, all values little endian:
+ *     int, uint     - 4 bytes
+ *     long, ulong   - 8 bytes
+ *     double        - 8 bytes IEEE 754
+ *     bool          - 1 byte
+ *     string        - uint32 length followed by the characters
+ *
+ * The vault is a text column, so the bytes are stored base64 encoded after
+ * the "@ccdb-bin1@" prefix, readers use IsBinary() to tell the two forms
+ * apart. Writers choose the form, text stays the default.
+ */
+class BinaryBlob
+{
+public:
+
+	/** @brief One decoded column. Only the vector of Type is filled */
+	struct Column
+	{
+		ConstantsTypeColumn::ColumnTypes Type;
+		vector<int>           Ints;
+		vector<unsigned int>  UInts;
+		vector<long>          Longs;
+		vector<unsigned long> ULongs;
+		vector<double>        Doubles;
+		vector<bool>          Bools;
+		vector<string>        Strings;
+	};
+
+	static const char* Prefix;   ///"@ccdb-bin1@", the start of every binary vault
+
+	/** @brief Tells if the vault holds the binary form */
+	static bool IsBinary(const string& blob);
+
+	/** @brief Encodes the cells of a table to the binary form
+	 *
+	 * @param [in]  values - cells, row by row, as returned by Assignment::GetVectorData()
+	 * @param [in]  types  - type of each column
+	 * @param [out] blob   - the encoded vault
+	 * @return false if the number of cells is not a multiple of the number of columns
+	 *         or a cell can not be read as the type of its column. Such tables should
+	 *         be stored with Assignment::VectorToBlob()
+	 */
+	static bool Encode(const vector<string>& values, const vector<ConstantsTypeColumn::ColumnTypes>& types, string& blob);
+
+	/** @brief Encodes the cells like Encode, but gives the bytes without prefix and base64 */
+	static bool EncodeBytes(const vector<string>& values, const vector<ConstantsTypeColumn::ColumnTypes>& types, string& bytes);
+
+	/** @brief Encodes typed columns of rows values each to bytes */
+	static void EncodeBytes(const vector<Column>& columns, size_t rows, string& bytes);
+
+	/** @brief Makes the vault text, prefix and base64, of encoded bytes */
+	static string BytesToBlob(const string& bytes);
+
+	/** @brief Decodes the binary form to typed columns
+	 *
+	 * @param [in]  blob    - the vault, starting with Prefix
+	 * @param [out] columns - the columns
+	 * @param [out] rows    - number of rows
+	 * @return false if the blob is not a valid binary vault
+	 */
+	static bool Decode(const string& blob, vector<Column>& columns, size_t& rows);
+
+	/** @brief Decodes the bytes [first, last) of EncodeBytes to typed columns
+	 * @return false if the bytes are not a valid encoded table
+	 */
+	static bool DecodeBytes(const char* first, const char* last, vector<Column>& columns, size_t& rows);
+
+	/** @brief Formats decoded columns to cells, row by row, like the text vault holds them */
+	static void ToVector(const vector<Column>& columns, size_t rows, vector<string>& values);
+
+	/** @brief Formats one double so that it reads back as the same value */
+	static string FormatDouble(double value);
+
+private:
+	static string Base64Encode(const string& bytes);
+	static bool Base64Decode(const char* first, const char* last, string& bytes);
+};
+
+}
+
+#endif // _BinaryBlob_
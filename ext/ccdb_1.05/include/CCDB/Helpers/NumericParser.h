@@ -0,0 +1,97 @@
+#ifndef _NumericParser_
+#define _NumericParser_
+
+#include <string>
+
+using namespace std;
+
+namespace ccdb
+{
+
+/** @brief Locale independent conversion of text to numbers
+ *
+ * The functions are modeled after std::from_chars: they read a number
+ * from the characters [first, last), store it in value and return a
+ * pointer to the first character that is not part of the number.
+ * If no number could be read, or it is out of range for the type,
+ * first is returned and value is left untouched.
+ *
+ * Unlike strtol/strtod (and stringstream) the result never depends on
+ * the current C locale and no temporary objects are created. Leading
+ * blanks are NOT skipped. Integers accept an optional sign ('-' only
+ * for signed types), floating point numbers accept the usual
+ * [sign]digits[.digits][(e|E)[sign]digits] form as well as nan and
+ * inf/infinity. Booleans are "true", "false" or any integer.
+ *
+ * ParseExact requires the whole text (apart from surrounding blanks)
+ * to be the number.
+ */
+class NumericParser
+{
+public:
+    static const char* Parse(const char* first, const char* last, int& value);
+    static const char* Parse(const char* first, const char* last, unsigned int& value);
+    static const char* Parse(const char* first, const char* last, long& value);
+    static const char* Parse(const char* first, const char* last, unsigned long& value);
+    static const char* Parse(const char* first, const char* last, long long& value);
+    static const char* Parse(const char* first, const char* last, unsigned long long& value);
+    static const char* Parse(const char* first, const char* last, double& value);
+    static const char* Parse(const char* first, const char* last, float& value);
+    static const char* Parse(const char* first, const char* last, bool& value);
+
+    /** @brief Parses the whole text as a number of type T
+     *
+     * @param [in]  first, last - the text, blanks around the number are ignored
+     * @param [out] value - the number, untouched if false is returned
+     * @return true if the text is exactly one number which fits in T
+     */
+    template<class T>
+    static bool ParseExact(const char* first, const char* last, T& value)
+    {
+        while(first<last && IsBlank(*first)) first++;
+        while(last>first && IsBlank(*(last-1))) last--;
+        if(first==last) return false;
+
+        T tmp;
+        if(Parse(first, last, tmp) != last) return false;
+        value = tmp;
+        return true;
+    }
+
+    template<class T>
+    static bool ParseExact(const string& source, T& value)
+    {
+        return ParseExact(source.data(), source.data() + source.size(), value);
+    }
+
+    /** @brief Parses the number at the beginning of the text the way atoi/atof do
+     *
+     * Leading blanks are skipped and anything after the number is ignored.
+     * @return the number or 0 if the text doesn't start with one
+     */
+    template<class T>
+    static T ParseLenient(const char* first, const char* last)
+    {
+        while(first<last && IsBlank(*first)) first++;
+
+        T value = T();
+        Parse(first, last, value);
+        return value;
+    }
+
+    template<class T>
+    static T ParseLenient(const string& source)
+    {
+        return ParseLenient<T>(source.data(), source.data() + source.size());
+    }
+
+private:
+    static bool IsBlank(char c)
+    {
+        return c==' ' || c=='\n' || c=='\t' || c=='\v' || c=='\r' || c=='\f';
+    }
+};
+
+}
+
+#endif //_NumericParser_
@@ -0,0 +1,123 @@
+#ifndef _SnapshotFile_
+#define _SnapshotFile_
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "CCDB/Model/Assignment.h"
+#include "CCDB/Model/ConstantsTypeColumn.h"
+
+using namespace std;
+
+namespace ccdb
+{
+
+/** @brief Read only file with the constants of one run, variation and time
+ *
+ * A snapshot is made once from a database, @see Write, and then opened by
+ * every job of a production. The file is mapped to memory, opening it reads
+ * only the index and a table request copies its columns out of the mapped
+ * pages without parsing a single cell:
+ *
+ *   "CCDBSNAP", uint32 version, int32 run, int64 time, uint32 tables count,
+ *   uint32 length and characters of the variation,
+ *   index entry of each table:
+ *     uint32 length and characters of the path,
+ *     int32 assignment id, int32 valid run min, int32 valid run max, uint32 rows count,
+ *     uint32 columns count, then length, characters and type byte of each column,
+ *     uint64 offset and uint64 size of the table data
+ *   table data, each one starts on a PageSize boundary, @see BinaryBlob::EncodeBytes
+ *
+ * All values are little endian, like in BinaryBlob.
+ */
+class SnapshotFile
+{
+public:
+
+	/** @brief Index entry of one table */
+	struct Table
+	{
+		string Path;                                        ///Absolute path of the type table
+		int AssignmentId;                                   ///Id of the assignment in the database
+		int ValidRunMin;                                    ///First run of the run range
+		int ValidRunMax;                                    ///Last run of the run range
+		int RowsCount;                                      ///Number of rows of the table
+		vector<string> ColumnNames;                         ///Names of the columns
+		vector<ConstantsTypeColumn::ColumnTypes> ColumnTypes; ///Types of the columns as in the database
+		const char* Data;                                   ///Encoded table in the mapped file
+		size_t DataSize;                                    ///Size of the encoded table
+	};
+
+	static const char* Magic;        ///"CCDBSNAP", the first bytes of every snapshot
+	static const unsigned int Version;
+	static const size_t PageSize;    ///Table data alignment
+
+	SnapshotFile();
+	~SnapshotFile();
+
+	/** @brief Maps the file and reads its index
+	 * @return false if the file can't be opened or is not a snapshot, @see GetErrorMessage
+	 */
+	bool Open(const string& fileName);
+
+	/** @brief Unmaps the file. Table::Data pointers are no longer valid */
+	void Close();
+
+	bool IsOpen() const { return mData != NULL; }
+
+	const string& GetFileName() const { return mFileName; }
+	const string& GetErrorMessage() const { return mErrorMessage; }
+
+	int GetRun() const { return mRun; }                           ///Run the snapshot was made for
+	const string& GetVariation() const { return mVariation; }     ///Variation the snapshot was made for
+	time_t GetTime() const { return mTime; }                      ///Time of constants, 0 - the latest at the moment of the snapshot
+
+	/** @brief Index entry of the table or NULL if the snapshot doesn't have it */
+	const Table* FindTable(const string& path) const;
+
+	/** @brief Index entries of all tables by path */
+	const map<string, Table>& GetTables() const { return mTables; }
+
+	/** @brief Writes a snapshot of assignments
+	 *
+	 * The assignments should have their type tables with columns loaded. A column
+	 * whose cells don't read as its type is stored as a string column, so any
+	 * table the text vault holds makes it to the snapshot.
+	 *
+	 * The file is written under a temporary name and renamed at the end, so a
+	 * reader never maps a half written snapshot.
+	 *
+	 * @param [in]  fileName    - the snapshot file
+	 * @param [in]  run         - the run the assignments were requested for
+	 * @param [in]  variation   - the variation the assignments were requested for
+	 * @param [in]  time        - the time the assignments were requested for
+	 * @param [in]  assignments - assignments by absolute table path
+	 * @param [out] error       - description of the error if false is returned
+	 * @return false if the file can't be written or an assignment has no columns
+	 */
+	static bool Write(const string& fileName, int run, const string& variation, time_t time,
+	                  const map<string, Assignment *>& assignments, string& error);
+
+private:
+	bool ReadIndex();
+	void Unmap();
+
+	string mFileName;
+	string mErrorMessage;
+	const char* mData;               ///The mapped file
+	size_t mSize;                    ///Size of the mapped file
+	bool mIsMapped;                  ///False if the file was read to the heap instead
+	int mRun;
+	string mVariation;
+	time_t mTime;
+	map<string, Table> mTables;
+
+	SnapshotFile(const SnapshotFile& rhs);
+	SnapshotFile& operator=(const SnapshotFile& rhs);
+};
+
+}
+
+#endif // _SnapshotFile_
@@ -24,6 +24,7 @@
 
 
 #include <CCDB/Helpers/Varargs.h>
+#include <CCDB/Helpers/NumericParser.h>
 
 #define CCDB_BLANK_CHARACTERS " \n\t\v\r\f"
 //checks if character is blank.
@@ -267,6 +268,22 @@ public:
     static double           ParseDouble(const string& source, bool *result=NULL );      ///Reads double from the last query row
     static string           ParseString(const string& source, bool *result=NULL );      ///Reads string from the last query row
     static time_t           ParseUnixTime(const string& source, bool *result=NULL );    ///Reads string from the last query row
+
+private:
+
+    /** @brief Parses source using NumericParser
+     *
+     * If source is not exactly one number, *result is set to false and
+     * the number at the beginning of source is returned, as atoi/atof do.
+     */
+    template<class T>
+    static T ParseNumber(const string& source, bool *result)
+    {
+        T value = T();
+        bool parsed = NumericParser::ParseExact(source, value);
+        if(result) *result = parsed;
+        return parsed ? value : NumericParser::ParseLenient<T>(source);
+    }
 };
 }
 #endif // StringUtils_h__
@@ -0,0 +1,49 @@
+#ifndef _StringView_
+#define _StringView_
+
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+namespace ccdb
+{
+
+/** @brief Read only view of characters owned by someone else
+ *
+ * A minimal std::string_view: it is a pointer and a size, copying it
+ * copies no characters. The view is valid as long as the characters it
+ * points to are not changed or freed.
+ */
+class StringView
+{
+public:
+	StringView(): mData(NULL), mSize(0) {}
+	StringView(const char* data, size_t size): mData(data), mSize(size) {}
+	StringView(const string& str): mData(str.data()), mSize(str.size()) {}
+
+	const char* Data() const { return mData; }   ///First character, not null terminated
+	size_t Size() const { return mSize; }        ///Number of characters
+	bool Empty() const { return mSize == 0; }
+
+	const char* Begin() const { return mData; }
+	const char* End() const { return mData + mSize; }
+
+	char operator[](size_t index) const { return mData[index]; }
+
+	string ToString() const { return string(mData, mSize); }   ///Copy of the characters
+
+	bool operator==(const StringView& rhs) const
+	{
+		return mSize == rhs.mSize && (mSize == 0 || memcmp(mData, rhs.mData, mSize) == 0);
+	}
+	bool operator!=(const StringView& rhs) const { return !(*this == rhs); }
+
+private:
+	const char* mData;
+	size_t mSize;
+};
+
+}
+
+#endif // _StringView_
@@ -7,12 +7,18 @@
 
 #include <vector>
 #include <map>
+#include <deque>
+#include <stdexcept>
+#include <assert.h>
 
 #include "CCDB/Model/StoredObject.h"
 #include "CCDB/Model/ObjectsOwner.h"
 #include "CCDB/Model/ConstantsTypeTable.h"
 #include "CCDB/Model/ConstantsTypeColumn.h"
 #include "CCDB/Helpers/StringUtils.h"
+#include "CCDB/Helpers/BinaryBlob.h"
+#include "CCDB/Helpers/StringView.h"
+#include "CCDB/Helpers/NumericParser.h"
 
 using namespace std;
 
@@ -51,6 +57,17 @@ public:
 	 */
 	static string VectorToBlob(const vector<string>& values);
 
+	/**
+	 * @brief makes a typed binary blob from tokens, see BinaryBlob
+	 *
+	 * Tables that don't fit the binary form (a cell that doesn't read
+	 * as the type of its column) get the text blob of VectorToBlob
+	 * @param     values - cells row by row
+	 * @param     types  - type of each column
+	 * @return   std::string
+	 */
+	static string VectorToBinaryBlob(const vector<string>& values, const vector<ConstantsTypeColumn::ColumnTypes>& types);
+
 	/** @brief Encodes blob separator
 	 *
 	 * if str contains '|' it will be replaced by '&pipe;'
@@ -83,6 +100,16 @@ public:
 	int			    GetRequestedRun() const;			/// Run than was requested for user
 	void			SetRequestedRun(int val);			/// Run than was requested for user
 
+	/** @brief Runs around the requested run for which this assignment is the one returned
+	 *
+	 * Set by GetAssignmentShort from the assignment timeline. A request for any run of
+	 * [GetValidRunMin(), GetValidRunMax()] with the same variation and time gets the same data.
+	 * If the span is unknown GetValidRunMin() > GetValidRunMax()
+	 */
+	int				GetValidRunMin() const { return mValidRunMin; }
+	int				GetValidRunMax() const { return mValidRunMax; }
+	void			SetValidRuns(int min, int max) { mValidRunMin = min; mValidRunMax = max; }
+
 	RunRange *	    GetRunRange() const;		        /// Run range object, is NULL if not set
 	void            SetRunRange(RunRange * val);		/// Run range object, is NULL if not set
 
@@ -101,8 +128,34 @@ public:
 	time_t	GetModifiedTime() const { return mModifiedTime;}   ///Time of last modification
     void	SetModifiedTime(time_t val) {mModifiedTime = val;} ///Time of last modification
 
-	string	GetRawData() const { return mRawData; }            ///Raw data blob
-	void	SetRawData(std::string val);					   ///Raw data blob
+	const string& GetRawData() const;                          ///Raw data blob
+	void	SetRawData(std::string val);					   ///Raw data blob, text or binary form
+
+	/** @brief Sets the data from bytes of BinaryBlob::EncodeBytes
+	 *
+	 * The bytes are decoded to typed columns at once and may be freed after the call.
+	 * The raw data blob is made from the columns only if GetRawData() is called.
+	 * @return false if the bytes are not a valid encoded table, the assignment has no data then
+	 */
+	bool	SetBinaryData(const char* first, const char* last);
+
+	/** @brief True if the raw data blob is in the typed binary form, see BinaryBlob */
+	bool	IsBinaryData() const { return mIsBinaryData; }
+
+	/** @brief Typed columns of a binary data blob, they are empty for a text blob */
+	const vector<BinaryBlob::Column>& GetBinaryColumns() const { return mBinaryColumns; }
+
+	/** @brief Number of cells in the data blob */
+	size_t GetCellsCount() const { return Cells().size(); }
+
+	/** @brief Cell of the data blob without copying it
+	 *
+	 * The view points into the raw data blob (or to the decoded cell if it has
+	 * an escaped separator) and is valid until SetRawData is called again.
+	 * @param index - cell index, cells go row by row
+	 */
+	StringView GetCellView(size_t index) const { return Cells()[index]; }
+	StringView GetCellView(size_t rowIndex, size_t columnIndex) const;
 
 	
 	/** @brief GetMappedData returns rows vector of maps of column_name => data_value
@@ -111,6 +164,43 @@ public:
 	vector<map<string,string> > GetMappedData() const;					
 	void GetMappedData(vector<map<string,string> > & mappedData) const;	///Mapped data
 
+	/** @brief Appends rows of column_name => value, converting each cell with parse
+	 *
+	 * All rows have the same keys. They are inserted once, into a prototype
+	 * row, and every row is a copy of it: copying a map neither compares nor
+	 * searches the keys. The values are then written walking each row in key
+	 * order, with the column of each key looked up once for the whole table.
+	 */
+	template<class T>
+	void GetMappedData(vector<map<string,T> > & mappedData, T (*parse)(const StringView& cell)) const
+	{
+		vector<string> columnNames = mTypeTable->GetColumnNames();
+		if (columnNames.empty()) return;
+		size_t rowsNum = GetCellsCount() / columnNames.size();
+
+		map<string, size_t> keyColumns;    //the last column wins for repeated names, as MapData does
+		for (size_t i = 0; i < columnNames.size(); i++) keyColumns[columnNames[i]] = i;
+
+		map<string, T> prototype;
+		vector<size_t> columnOfKey;        //column of each key in map order
+		for (map<string, size_t>::const_iterator it = keyColumns.begin(); it != keyColumns.end(); ++it)
+		{
+			prototype.insert(prototype.end(), make_pair(it->first, T()));
+			columnOfKey.push_back(it->second);
+		}
+
+		size_t firstRow = mappedData.size();
+		mappedData.resize(firstRow + rowsNum, prototype);
+		for (size_t row = 0; row < rowsNum; row++)
+		{
+			typename map<string, T>::iterator cell = mappedData[firstRow + row].begin();
+			for (size_t key = 0; key < columnOfKey.size(); ++key, ++cell)
+			{
+				cell->second = parse(GetCellView(row, columnOfKey[key]));
+			}
+		}
+	}
+
 	vector<string> GetVectorData() const;				    ///Vector data
 	void GetVectorData(vector<string> & vectorData) const;	///Mapped data
 
@@ -123,9 +213,73 @@ public:
 	std::string GetComment() const { return mComment;} ///Comment of assignment
 	void SetComment(std::string val) {mComment = val;} ///Comment of assignment
 	
-	void SetTypeTable(ConstantsTypeTable* typeTable) { this->mTypeTable = typeTable;}
+	void SetTypeTable(ConstantsTypeTable* typeTable) { this->mTypeTable = typeTable; mColumnIndexes.clear(); }
 	ConstantsTypeTable* GetTypeTable() const { return mTypeTable; }
 
+	/** @brief Order of the cells in GetFlatData */
+	enum DataLayout
+	{
+		cRowMajor,      ///cell (row, column) is at row*columns + column
+		cColumnMajor    ///cell (row, column) is at column*rows + row
+	};
+
+	/** @brief Fills values with all cells converted to T
+	 *
+	 * Text cells are parsed in place with NumericParser, without a string
+	 * per cell. A cell that is not exactly one number is read the way
+	 * atoi/atof do, as StringUtils::ParseDouble etc. do. Cells of a binary
+	 * blob are converted from their stored type.
+	 * T is any type NumericParser reads: int, unsigned int, long, unsigned long,
+	 * long long, unsigned long long, float, double or bool.
+	 * @param [out] values - cells in the layout order
+	 * @param [in]  layout - row by row or column by column
+	 * @throw std::logic_error if a binary blob has other columns than the type table
+	 */
+	template<class T>
+	void GetFlatData(vector<T> &values, DataLayout layout = cRowMajor) const
+	{
+		assert(mTypeTable !=NULL); // it is DataProvider work
+
+		size_t columnsNum = mTypeTable->GetColumnsCount();
+		size_t rowsNum = columnsNum ? GetCellsCount() / columnsNum : 0;
+
+		//typed columns are read by index, so they must be the columns of the type table
+		if (mIsBinaryData && (mBinaryColumns.size() != columnsNum || rowsNum > mBinaryRowsCount))
+		{
+			throw std::logic_error("Assignment::GetFlatData. The binary blob has " + StringUtils::IntToString(static_cast<int>(mBinaryColumns.size())) +
+			                       " columns, the type table has " + StringUtils::IntToString(static_cast<int>(columnsNum)));
+		}
+		values.resize(rowsNum * columnsNum);
+
+		for (size_t col = 0; col < columnsNum; col++)
+		{
+			const BinaryBlob::Column* binary = mIsBinaryData ? &mBinaryColumns[col] : NULL;
+			for (size_t row = 0; row < rowsNum; row++)
+			{
+				T& value = values[layout == cRowMajor ? row*columnsNum + col : col*rowsNum + row];
+				if (binary && binary->Type != ConstantsTypeColumn::cStringColumn)
+				{
+					value = BinaryCell<T>(*binary, row);
+				}
+				else
+				{
+					StringView cell = GetCellView(row, col);
+					if (!NumericParser::ParseExact(cell.Begin(), cell.End(), value))
+					{
+						value = NumericParser::ParseLenient<T>(cell.Begin(), cell.End());
+					}
+				}
+			}
+		}
+	}
+
+	/** @brief Index of the column in the type table
+	 * @return column index or -1 if the table has no such column
+	 */
+	int GetColumnIndex(const string& columnName) const;
+
+	/** Cell values. They are read in place, an empty string is returned for a cell out of the table.
+	 *  GetValue(columnIndex) takes the cell index of all cells, row by row */
 	string GetValue(size_t columnIndex);
 	string GetValue(size_t rowIndex, size_t columnIndex);
 	string GetValue(string columnName);
@@ -171,8 +325,8 @@ public:
 	size_t GetColumnsCount() const { return mTypeTable->GetColumnsCount(); }
 private:
 
-	vector<map<string,string> > mRows;	// cache for blob data by rows
-	string mRawData;					// data blob
+	mutable map<string, int> mColumnIndexes;	// column name => index, built on first use
+	mutable string mRawData;			// data blob
 	int mId;							// id in database
 	int mDataBlobId;					// blob id in database
 	unsigned int mVariationId;			// database ID of variation
@@ -181,6 +335,8 @@ private:
 	unsigned int mEventRangeId;			// event range ID
     unsigned int mColumnCount;          // number of columns
 	int	mRequestedRun;					// Run than was requested for user
+	int mValidRunMin;					// First run with the same assignment
+	int mValidRunMax;					// Last run with the same assignment
 	RunRange *mRunRange;				// Run range object, is NULL if not set
 	EventRange *mEventRange;			// Event range object, is NULL if not set
 	Variation *mVariation;				// Variation object, is NULL if not set
@@ -190,7 +346,33 @@ private:
 	time_t mModifiedTime;				// time of last modification
 	string mComment;					// Comment of assignment
 
-	vector<string> mVectorData;         // Vectorized blob
+	mutable bool mIsRawDataReady;       // mRawData is set, false after SetBinaryData
+	mutable vector<StringView> mCells;  // cells of the blob, views into mRawData or mDecodedCells
+	mutable deque<string> mDecodedCells;// cells that differ from the raw data: escaped or binary
+	mutable bool mIsCellsReady;         // mCells is filled
+	bool mIsBinaryData;                 // the blob is in binary form
+	size_t mBinaryRowsCount;            // rows of mBinaryColumns
+	vector<BinaryBlob::Column> mBinaryColumns; // decoded binary blob
+
+	void Tokenize();                    // fills mCells from a text blob in one pass
+	static string CellToString(const StringView& cell);   // parse function of GetMappedData for strings
+
+	/** cell of a typed binary column cast to T */
+	template<class T>
+	static T BinaryCell(const BinaryBlob::Column& column, size_t row)
+	{
+		switch (column.Type)
+		{
+			case ConstantsTypeColumn::cIntColumn:    return static_cast<T>(column.Ints[row]);
+			case ConstantsTypeColumn::cUIntColumn:   return static_cast<T>(column.UInts[row]);
+			case ConstantsTypeColumn::cLongColumn:   return static_cast<T>(column.Longs[row]);
+			case ConstantsTypeColumn::cULongColumn:  return static_cast<T>(column.ULongs[row]);
+			case ConstantsTypeColumn::cDoubleColumn: return static_cast<T>(column.Doubles[row]);
+			case ConstantsTypeColumn::cBoolColumn:   return static_cast<T>(column.Bools[row]);
+			default:                                 return T();
+		}
+	}
+	const vector<StringView>& Cells() const;   // mCells, formatting binary columns if needed
 
 	Assignment(const Assignment& rhs);	
 	Assignment& operator=(const Assignment& rhs);
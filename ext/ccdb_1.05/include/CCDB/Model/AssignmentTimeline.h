@@ -0,0 +1,92 @@
+/*
+ * AssignmentTimeline.h
+ */
+
+#ifndef _DAssignmentTimeline_
+#define _DAssignmentTimeline_
+
+#include <vector>
+
+#include "CCDB/Globals.h"
+
+using namespace std;
+
+namespace ccdb {
+
+/** @brief Effective assignments of one type table by run.
+ *
+ * Many assignments of a table may cover a run. The one that is returned
+ * for the run is the one of the nearest variation in the variation chain,
+ * and the newest of them if there are several. The timeline is built from
+ * the whole assignment history of the table and splits the runs into
+ * sorted, non overlapping intervals, each with the assignment that wins
+ * there. So the assignment of a run is found by binary search.
+ *
+ * usage:
+ *  timeline.AddAssignment(...); //for each assignment in the history
+ *  timeline.Build();
+ *  const AssignmentTimeline::Interval *interval = timeline.Find(run);
+ */
+class AssignmentTimeline
+{
+public:
+
+	/** @brief runs [RunMin, RunMax] where one assignment is effective */
+	struct Interval
+	{
+		int RunMin;
+		int RunMax;
+		dbkey_t AssignmentId;
+		dbkey_t ConstantSetId;
+	};
+
+	AssignmentTimeline();
+
+	/** @brief Adds an assignment of the history
+	 *
+	 * @param [in] assignmentId  - database id of the assignment. Bigger ids are newer
+	 * @param [in] constantSetId - database id of the data of the assignment
+	 * @param [in] runMin        - first run of the run range
+	 * @param [in] runMax        - last run of the run range
+	 * @param [in] variationOrder - place of the variation of the assignment in the
+	 *                             variation chain. 0 is the requested variation, 1 its parent...
+	 */
+	void AddAssignment(dbkey_t assignmentId, dbkey_t constantSetId, int runMin, int runMax, int variationOrder);
+
+	/** @brief Computes the intervals from the added assignments
+	 *
+	 * Assignments added after Build() are used after the next Build()
+	 */
+	void Build();
+
+	/** @brief Finds the interval of the run
+	 *
+	 * @param [in] run - run number
+	 * @return interval that contains run or NULL if no assignment covers the run
+	 */
+	const Interval* Find(int run) const;
+
+	const vector<Interval>& GetIntervals() const { return mIntervals; } ///Sorted intervals, valid after Build()
+	size_t GetAssignmentsCount() const { return mAssignments.size(); }  ///Number of added assignments
+
+private:
+
+	/** @brief assignment as added, with its priority */
+	struct Candidate
+	{
+		dbkey_t AssignmentId;
+		dbkey_t ConstantSetId;
+		int RunMin;
+		int RunMax;
+		int VariationOrder;
+
+		bool operator<(const Candidate& other) const;   ///Winning candidate goes first
+	};
+
+	vector<Candidate> mAssignments;
+	vector<Interval> mIntervals;
+};
+
+}
+
+#endif /* _DAssignmentTimeline_ */
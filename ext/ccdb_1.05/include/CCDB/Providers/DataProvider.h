@@ -4,10 +4,12 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 
 #include "CCDB/Providers/IAuthentication.h"
 #include "CCDB/Model/ObjectsOwner.h"
 #include "CCDB/Model/Assignment.h"
+#include "CCDB/Model/AssignmentTimeline.h"
 #include "CCDB/Model/ConstantsTypeTable.h"
 #include "CCDB/Model/Directory.h"
 #include "CCDB/Model/RunRange.h"
@@ -180,6 +182,41 @@ public:
 	 */
 	virtual bool LoadDirectories() = 0;
 
+    /** @brief Reads all variations from DB
+     *
+     * Implementations read every row of the variations table to mVariationsById
+     * and call BuildVariationDependencies() at the end
+     * @return   bool
+     */
+    virtual bool LoadVariations() = 0;
+
+    virtual void BuildVariationDependencies();  /// Sets parents and ancestor chains of variations. Used right at the end of LoadVariations().
+
+    /** @brief Composes SQL parts that select data of a variation or of its nearest parent that has data
+     *
+     * @param  [in]  variation variation to start with
+     * @param  [in]  column    variation id column, i.e. "`assignments`.`variationId`"
+     * @param  [out] whereInsertion "column IN (id, parent id, ...)"
+     * @param  [out] orderInsertion "CASE column WHEN id THEN 0 WHEN parent id THEN 1 ... END"
+     */
+    void PrepareVariationChainInsertion(Variation* variation, const string& column, string& whereInsertion, string& orderInsertion);
+
+    /** @brief Composes comma separated list of ids for "IN (...)" SQL clause
+     *
+     * @param  [in] ids
+     * @return string "id1, id2, ..."
+     */
+    string PrepareIdListInsertion(const vector<dbkey_t>& ids);
+
+    /** @brief Composes condition for assignments whose run ranges overlap given run ranges of their type tables
+     *
+     * GetAssignmentsShort uses it to find the assignments that end the run spans of the found ones
+     *
+     * @param  [in] runRanges - run min and max by type table id
+     * @return string "((`constantSets`.`constantTypeId` = id AND `runRanges`.`runMax` >= min AND `runRanges`.`runMin` <= max) OR ...)"
+     */
+    string PrepareRunOverlapInsertion(const map<dbkey_t, pair<int, int> >& runRanges);
+
     virtual void BuildDirectoryDependencies();  /// Builds directory relational structure. Used right at the end of RetriveDirectories().
     virtual bool CheckDirectoryListActual();    /// Checks if directory list is actual i.e. nobody changed directories in database
     virtual bool UpdateDirectoriesIfNeeded();   /// Update directories structure if this is required
@@ -210,6 +247,48 @@ public:
      */
     virtual ConstantsTypeTable * GetConstantsTypeTable(const string& name, Directory *parentDir, bool loadColumns=false)=0;
 
+    /** @brief Gets type table with its columns from the provider cache
+     *
+     * The table is loaded from the DB on the first request for the path. Later requests
+     * and all assignments returned by GetAssignmentShort share the same object.
+     * The object is owned by the provider and must not be changed or deleted by the caller.
+     * It stays valid until the provider is destroyed, even after InvalidateTypeTablesCache().
+     *
+     * @param  [in] path absolute path of the type table
+     * @return cached ConstantsTypeTable or NULL if there is no such table
+     */
+    virtual ConstantsTypeTable * GetCachedConstantsTypeTable(const string& path);
+
+    /** @brief Drops type tables from the cache, so they are loaded from the DB on the next request
+     *
+     * Dropped tables are still owned by the provider, so assignments that use them stay valid
+     *
+     * @param  [in] path absolute path of the type table. If empty, all tables are dropped
+     */
+    virtual void InvalidateTypeTablesCache(const string& path="");
+
+    protected:
+
+    /** @brief Loads to the cache all type tables of the paths that are not cached yet
+     *
+     * The default implementation calls GetCachedConstantsTypeTable for each path.
+     * SQL providers load all tables with their columns in two queries
+     *
+     * @param  [in] paths absolute paths of type tables
+     * @return false if loading failed. Paths of not existing tables are not an error
+     */
+    virtual bool LoadConstantsTypeTables(const vector<string>& paths);
+
+    /** @brief Selects paths of type tables that are not in the cache yet
+     *
+     * @param  [in]  paths absolute paths of type tables
+     * @param  [out] uncachedPaths paths that are not cached and whose directory exists
+     * @param  [out] directoryIds ids of the directories of uncachedPaths, each id once
+     */
+    void SelectUncachedTypeTables(const vector<string>& paths, set<string>& uncachedPaths, vector<dbkey_t>& directoryIds);
+
+    public:
+
     /** @brief Gets ConstantsType information from the DB
      *
      * @param  [in] name name of ConstantsTypeTable
@@ -344,10 +423,31 @@ public:
     //----------------------------------------------------------------------------------------
     /** @brief Get variation by name
      *
-     * @param     const char * name
-     * @return   DVariation*
+     * All variations are loaded from the DB on the first request. @see LoadVariations
+     * The returned object is owned by the provider
+     *
+     * @param     name variation name
+     * @return   Variation* or NULL if there is no variation with this name
+     */
+    virtual Variation* GetVariation(const string& name);
+
+    /** @brief Get variation by database id
+     *
+     * @param     id database id of the variation
+     * @return   Variation* or NULL if there is no variation with this id
      */
-    virtual Variation* GetVariation(const string& name)=0;
+    virtual Variation* GetVariationById(dbkey_t id);
+
+    /** @brief Gets ids of the variation and all its parents
+     *
+     * Ids go from the variation itself to its top parent. It is the order in which
+     * a table is looked up when a variation has no data for it.
+     * The chains are computed once when variations are loaded
+     *
+     * @param     variation variation returned by GetVariation
+     * @return   ids of the variation and its parents, empty if the variation is unknown
+     */
+    const vector<dbkey_t>& GetVariationChain(Variation* variation);
      
     /**
      * @brief Searches all variations associated with this type table
@@ -398,7 +498,7 @@ public:
      * @param [in] run - run number
      * @param [in] path - object path
      * @param [in] variation - variation name
-     * @param [in] loadColumns - optional, do we need to load table columns information (for column names and types) or not
+     * @param [in] loadColumns - kept for compatibility. Columns of the shared cached type table are always loaded
      * @return DAssignment object or NULL if no assignment is found or error
      */
     virtual Assignment* GetAssignmentShort(int run, const string& path, const string& variation="default", bool loadColumns=false)=0;
@@ -415,10 +515,58 @@ public:
      * @param [in] path - object path
      * @param [in] time - timestamp, data that is equal or earlier in time than that timestamp is returned
      * @param [in] variation - variation name
-     * @param [in] loadColumns - optional, do we need to load table columns information (for column names and types) or not
+     * @param [in] loadColumns - kept for compatibility. Columns of the shared cached type table are always loaded
      * @return DAssignment object or NULL if no assignment is found or error
      */
     virtual Assignment* GetAssignmentShort(int run, const string& path, time_t time, const string& variation="default", bool loadColumns=false)=0;
+
+    /** @brief Gets Assignments with data blob only for many type tables at once
+     *
+     * The result is the same as of GetAssignmentShort for each path. 
+     * The default implementation calls GetAssignmentShort for each path.
+     * SQL providers resolve all assignments with a fixed number of queries
+     * that doesn't depend on the number of paths.
+     *
+     * @param [out] assignments - assignments by type table path. Tables without data for the run are not added.
+     *                            The caller owns the assignments
+     * @param [in] run - run number
+     * @param [in] paths - absolute paths of type tables
+     * @param [in] time - timestamp, data that is equal or earlier in time than that timestamp is returned. 0 - the latest data
+     * @param [in] variation - variation name
+     * @return false if there was an error
+     */
+    virtual bool GetAssignmentsShort(map<string, Assignment*>& assignments, int run, const vector<string>& paths, time_t time=0, const string& variation="default");
+
+    /** @brief Gets effective assignments of a type table by run from the provider cache
+     *
+     * The timeline is built from the assignment history of the table on the first request
+     * for the table, variation and time. After that the assignment of any run is found
+     * without database queries. The timeline is owned by the provider.
+     *
+     * @param [in] table - type table
+     * @param [in] variation - variation. Assignments of its parents are used where it has no data
+     * @param [in] time - timestamp, assignments created later are not used. 0 - all assignments
+     * @return cached timeline or NULL if there was an error
+     */
+    virtual const AssignmentTimeline* GetAssignmentTimeline(ConstantsTypeTable* table, Variation* variation, time_t time=0);
+
+    /** @brief Drops all assignment timelines, so they are built again on the next request
+     *
+     * Timelines with time=0 don't see assignments added after they were built
+     */
+    virtual void InvalidateAssignmentTimelines();
+
+    protected:
+
+    /** @brief Reads the assignment history of the table to the timeline
+     *
+     * Implementations call timeline.AddAssignment for each assignment of the table
+     * in the variation chain that is created before time (if time>0)
+     * @return false if there was an error
+     */
+    virtual bool LoadAssignmentTimeline(AssignmentTimeline& timeline, ConstantsTypeTable* table, Variation* variation, time_t time)=0;
+
+    public:
        
 
     /** @brief Get last Assignment with all related objects
@@ -604,7 +752,39 @@ public:
      * @return true if success and assignment was filled with data
      */
     virtual bool FillAssignment(Assignment* assignment)=0;
-    
+
+    /** @brief Adds constants of a type table for a run range and variation
+     *
+     * The run range without a name is created if the database has none with
+     * runMin and runMax. The constant set and the assignment are added in one
+     * transaction, @see CreateAssignments
+     *
+     * @param  [in] data       rows of cells, nRows x nColumns of the type table
+     * @param  [in] path       absolute path of the type table
+     * @param  [in] runMin     first run of the run range
+     * @param  [in] runMax     last run of the run range
+     * @param  [in] variation  name of an existing variation
+     * @param  [in] comment    comment of the assignment
+     * @return new assignment with ids set or NULL on error
+     */
+    virtual Assignment* CreateAssignment(const vector<vector<string> >& data, const string& path, int runMin, int runMax, const string& variation="default", const string& comment="");
+
+    /** @brief Adds many assignments in one transaction
+     *
+     * Each assignment must have a type table, a run range with min and max,
+     * a variation with name and the data. The comment is optional. A type
+     * table that is not loaded from the database, with only the full path set,
+     * is replaced by the cached one, @see GetCachedConstantsTypeTable
+     * Either all of them are added, and their ids are set, or none.
+     *
+     * The default implementation reports CCDB_ERROR_NOT_IMPLEMENTED,
+     * providers that can write override it
+     *
+     * @param  [in,out] assignments - assignments to add
+     * @return true if all assignments were added
+     */
+    virtual bool CreateAssignments(const vector<Assignment *>& assignments);
+
 #ifndef __GNUC__
 	#pragma endregion Assignments
 #endif
@@ -673,6 +853,26 @@ public:
 
 
 
+    //----------------------------------------------------------------------------------------
+    //  T I M E   Z O N E
+    //----------------------------------------------------------------------------------------
+
+    /** @brief Time zone the `created` times of the database are written in */
+    enum TimeZones
+    {
+        cLocalTime,     ///local time, as the python tools write them. The default
+        cUTCTime        ///UTC, the same for readers in any time zone
+    };
+
+    /** @brief Sets the time zone the `created` times are written in
+     *
+     * Requests with a time compare `created` to the time in this zone, and new assignments
+     * are created with the current time in this zone. The cached timelines are dropped.
+     * For MySQL cLocalTime is the time zone of the MySQL session.
+     */
+    virtual void SetTimeZone(TimeZones timeZone);
+    TimeZones GetTimeZone() const { return mTimeZone; }   ///@see SetTimeZone
+
     //----------------------------------------------------------------------------------------
     //  L O G G I N G
     //----------------------------------------------------------------------------------------
@@ -688,6 +888,20 @@ protected:
      * @return   void
      */
     void SetObjectLoaded(StoredObject* obj);
+
+    /** @brief Checks an assignment given to CreateAssignments and sets the id of its variation
+     *
+     * @param  [in] errorSource - function name for the error
+     * @return false and reports the error if the assignment can't be added
+     */
+    bool CheckNewAssignment(Assignment* assignment, const string& errorSource);
+
+    /** @brief Formats the time as "YYYY-MM-DD hh:mm:ss" in the time zone of the database
+     *
+     * It is the form the `created` columns hold, so a `created` column can be compared
+     * with it as is, and an index on the column is used. @see SetTimeZone
+     */
+    string FormatDatabaseTime(time_t time) const;
     
     /******* D I R E C T O R I E S   W O R K *******/ 
     vector<Directory *>  mDirectories;
@@ -713,11 +927,22 @@ protected:
     
     std::string mLogUserName;           ///User name
 
+    TimeZones mTimeZone;                ///Time zone of `created` times. @see SetTimeZone
+
     std::string mConnectionString;      ///Connection string that was used on last successfully connect.
 
     IAuthentication * mAuthentication;
 
+    /******* V A R I A T I O N S   W O R K *******/
     map<dbkey_t, Variation *> mVariationsById;
+    map<string, Variation *> mVariationsByName;
+    map<dbkey_t, vector<dbkey_t> > mVariationChains;   ///Ids of each variation and its parents. @see GetVariationChain
+    bool mVariationsAreLoaded;                          ///Variations are loaded from database
+
+    map<string, ConstantsTypeTable *> mTypeTablesByPath;    ///Cached type tables with columns by full path. @see GetCachedConstantsTypeTable
+
+    typedef pair<pair<dbkey_t, dbkey_t>, time_t> TimelineKey;  ///type table id, variation id, time
+    map<TimelineKey, AssignmentTimeline *> mAssignmentTimelines; ///Cached timelines. @see GetAssignmentTimeline
 };
 }
 #endif // _DDataProvider_
@@ -0,0 +1,78 @@
+#ifndef _DDataProviderPool_
+#define _DDataProviderPool_
+
+#include <string>
+#include <vector>
+
+#ifdef WIN32
+#include "winpthreads.h"
+#else //posix
+#include <pthread.h>
+#endif
+
+#include "CCDB/Providers/DataProvider.h"
+
+using namespace std;
+
+namespace ccdb
+{
+
+/** @brief Fixed set of providers, each with its own database connection
+ *
+ * A provider is not thread safe: it has one connection, one current statement and
+ * its own caches. The pool lets several threads query the database at once. Each
+ * query checks out a free provider with Acquire() and gives it back with Release().
+ * When all providers are busy, Acquire() waits for one.
+ *
+ * usage:
+ *   DataProvider *provider = pool->Acquire();
+ *   Assignment *assignment = provider->GetAssignmentShort(...);
+ *   pool->Release(provider);
+ */
+class DataProviderPool
+{
+public:
+	/** @param [in] connectionString - connection string of the providers. Used by Connect() and to reconnect them */
+	DataProviderPool(const string& connectionString);
+
+	/** Deletes the providers. Objects owned by them are deleted too */
+	~DataProviderPool();
+
+	/** @brief Adds a not connected provider to the pool. The pool owns it */
+	void Add(DataProvider *provider);
+
+	/** @brief Connects all providers
+	 * @return false if one of them could not connect
+	 */
+	bool Connect();
+
+	/** @brief Disconnects all providers. They are connected again by Acquire() */
+	void Disconnect();
+
+	/** @brief Waits for a free provider and checks it out
+	 * @param [in] connect - if false the provider is not reconnected, for work that doesn't query the database
+	 * @throw std::logic_error if the provider could not reconnect. It is given back to the pool
+	 * @return the provider, connected if connect is true
+	 */
+	DataProvider * Acquire(bool connect = true);
+
+	/** @brief Gives back the provider taken by Acquire() */
+	void Release(DataProvider *provider);
+
+	size_t GetSize() const { return mProviders.size(); }   ///Number of providers
+
+private:
+	string mConnectionString;
+	vector<DataProvider *> mProviders;   ///all providers
+	vector<DataProvider *> mFree;        ///providers that are not checked out
+
+	pthread_mutex_t mMutex;              ///guards mFree
+	pthread_cond_t mFreeCondition;       ///signaled when a provider is released
+
+	DataProviderPool(const DataProviderPool& rhs);
+	DataProviderPool& operator=(const DataProviderPool& rhs);
+};
+
+}
+
+#endif // _DDataProviderPool_
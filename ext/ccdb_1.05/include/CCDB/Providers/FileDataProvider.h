@@ -1,38 +1,175 @@
-#pragma once
-#include "DataProvider.h"
-#ifndef WIN32
-#include <dirent.h>
-#include <stdio.h>
-#endif
-namespace ccdb
-{
-#ifndef WIN32
-	int listdir(const char *path) 
-	{
-		struct dirent *entry;
-		DIR *dp;
+#ifndef _FileDataProvider_
+#define _FileDataProvider_
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
 
-		dp = opendir(path);
-		if (dp == NULL) {
-			perror("opendir");
-			return -1;
-		}
+#include "CCDB/Providers/DataProvider.h"
+#include "CCDB/Model/ConstantsTypeTable.h"
 
-		while((entry = readdir(dp)))
-			puts(entry->d_name);
+using namespace std;
 
-		closedir(dp);
-		return 0;
-	}
-#endif
+namespace ccdb
+{
 
-class FileDataProvider : public DataProvider
+/** @brief Read only provider of constants kept as text files in a directory tree
+ *
+ * The connection string is file://<root directory>. Directories under the root
+ * mirror the directories of the type tables, and each file holds one assignment:
+ *
+ *   <root>/calibration/ftof/status.default.0-2147483647.txt
+ *   <root>/calibration/ftof/status.mc.100-200.1506844800.txt
+ *          \____________/ \____/ \_/ \_____/ \________/
+ *           directories   table  variation runs  created (unix time, optional)
+ *
+ * The max run may also be written as "max". Files are in the format of
+ * ConstantsTable::write_to_file: a "# names # types" header line and then
+ * whitespace separated cells, one row per line. Strings with spaces are quoted.
+ *
+ * Variations are the ones used in the file names, all of them are children of
+ * "default" unless <root>/variations.txt has "name parent" lines.
+ *
+ * The tree is indexed on Connect, so table and assignment lookups don't touch the
+ * file system. Only the file of the found assignment is mapped and read.
+ */
+class FileDataProvider: public DataProvider
 {
 public:
 	FileDataProvider(void);
-	~FileDataProvider(void);
+	virtual ~FileDataProvider(void);
+
+	//----------------------------------------------------------------------------------------
+	//	C O N N E C T I O N
+	//----------------------------------------------------------------------------------------
+
+	/**
+	 * @brief Indexes the directory tree
+	 *
+	 * @param connectionString "file://<root directory>"
+	 * @return true if the root directory was indexed
+	 */
 	virtual bool Connect(std::string connectionString);
 
+	/** @brief Drops the index */
 	virtual void Disconnect();
+
+	/** @brief indicates ether the tree is indexed or not */
+	virtual bool IsConnected();
+
+	/** @brief Checks Connection and report error if not connected, @see SQLiteDataProvider::CheckConnection */
+	virtual bool CheckConnection(const string& errorSource="");
+
+	//----------------------------------------------------------------------------------------
+	//	D I R E C T O R Y   M A N G E M E N T
+	//----------------------------------------------------------------------------------------
+	virtual Directory* GetDirectory(const string& path);
+	virtual bool SearchDirectories(vector<Directory *>& resultDirectories, const string& searchPattern, const string& parentPath="", int take=0, int startWith=0);
+	virtual vector<Directory *> SearchDirectories(const string& searchPattern, const string& parentPath="", int take=0, int startWith=0);
+	virtual bool LoadDirectories();
+	virtual bool LoadVariations();
+
+	//----------------------------------------------------------------------------------------
+	//	C O N S T A N T   T Y P E   T A B L E
+	//----------------------------------------------------------------------------------------
+	virtual ConstantsTypeTable * GetConstantsTypeTable(const string& name, Directory *parentDir, bool loadColumns=false);
+	virtual ConstantsTypeTable * GetConstantsTypeTable(const string& path, bool loadColumns=false);
+	virtual bool GetConstantsTypeTables(vector<ConstantsTypeTable *>& typeTables, const string& parentDirPath, bool loadColumns=false);
+	virtual vector<ConstantsTypeTable *> GetConstantsTypeTables(Directory *parentDir, bool loadColumns=false);
+	virtual bool GetConstantsTypeTables(vector<ConstantsTypeTable *>& typeTables, Directory *parentDir, bool loadColumns=false);
+	virtual bool SearchConstantsTypeTables(vector<ConstantsTypeTable *>& typeTables, const string& pattern, const string& parentPath = "", bool loadColumns=false, int take=0, int startWith=0 );
+	virtual vector<ConstantsTypeTable *> SearchConstantsTypeTables(const string& pattern, const string& parentPath = "", bool loadColumns=false, int take=0, int startWith=0 );
+	virtual int CountConstantsTypeTables(Directory *dir);
+
+	/** @brief Reads columns of the table from the header of its newest file */
+	virtual bool LoadColumns(ConstantsTypeTable* table);
+
+	//----------------------------------------------------------------------------------------
+	//	R U N   R A N G E S
+	//----------------------------------------------------------------------------------------
+	virtual RunRange* GetRunRange(int min, int max, const string& name = "");
+	virtual bool GetRunRanges(vector<RunRange *>& resultRunRanges, ConstantsTypeTable *table, const string& variation="", int take=0, int startWith=0);
+	virtual RunRange* GetRunRange(const string& name);   ///Always NULL, files have no named run ranges
+
+	//----------------------------------------------------------------------------------------
+	//	V A R I A T I O N
+	//----------------------------------------------------------------------------------------
+	virtual bool GetVariations(vector<Variation *>& resultVariations, ConstantsTypeTable *table, int run=0, int take=0, int startWith=0);
+	virtual vector<Variation *> GetVariations(ConstantsTypeTable *table, int run=0, int take=0, int startWith=0);
+
+	//----------------------------------------------------------------------------------------
+	//	A S S I G N M E N T S
+	//----------------------------------------------------------------------------------------
+	virtual Assignment* GetAssignmentShort(int run, const string& path, const string& variation="default", bool loadColumns=false);
+	virtual Assignment* GetAssignmentShort(int run, const string& path, time_t time, const string& variation="default", bool loadColumns=false);
+	virtual Assignment* GetAssignmentFull(int run, const string& path, const string& variation="default");
+	virtual Assignment* GetAssignmentFull(int run, const string& path, int version, const string& variation="default");
+	virtual bool GetAssignments(vector<Assignment *> &assingments,const string& path, int runMin, int runMax, const string& runRangeName, const string& variation, time_t beginTime, time_t endTime, int sortBy=0, int take=0, int startWith=0);
+	virtual bool GetAssignments(vector<Assignment *> &assingments,const string& path, int run, const string& variation="", time_t date=0, int take=0, int startWith=0);
+	virtual vector<Assignment *> GetAssignments(const string& path, int run, const string& variation="", time_t date=0, int take=0, int startWith=0);
+	virtual bool GetAssignments(vector<Assignment *> &assingments,const string& path, const string& runName, const string& variation="", time_t date=0, int take=0, int startWith=0);
+	virtual vector<Assignment *> GetAssignments(const string& path, const string& runName, const string& variation="", time_t date=0, int take=0, int startWith=0);
+
+	/** @brief Fills data, run range, variation and type table of the assignment with the id set */
+	virtual bool FillAssignment(Assignment* assignment);
+
+	/** @brief Reads a table file
+	 *
+	 * The file is mapped to memory and parsed in place. The header of files written
+	 * by older ConstantsTable::write_to_file, that has no line break before the
+	 * first row, is read too.
+	 *
+	 * @param [in]  fileName - the file
+	 * @param [out] names    - column names, empty if the file has no header
+	 * @param [out] types    - column types, "double" where the header doesn't tell
+	 * @param [out] cells    - cells, row by row
+	 * @return false if the file can't be read
+	 */
+	static bool ReadTableFile(const string& fileName, vector<string>& names, vector<string>& types, vector<string>& cells);
+
+	/** @brief Parses the text of a table file, @see ReadTableFile */
+	static void ParseTableText(const char* first, const char* last, vector<string>& names, vector<string>& types, vector<string>& cells);
+
+protected:
+	virtual bool LoadAssignmentTimeline(AssignmentTimeline& timeline, ConstantsTypeTable* table, Variation* variation, time_t time);
+
+private:
+
+	/** @brief One file of the tree, it is one assignment */
+	struct TableFile
+	{
+		dbkey_t Id;             ///Id of the assignment and its data. Newer files have bigger ids
+		string FileName;        ///Full name of the file
+		string Path;            ///Path of the type table
+		string Variation;       ///Variation name
+		int RunMin;
+		int RunMax;
+		time_t Created;         ///Time from the file name, 0 if not there
+	};
+
+	/** @brief Type table of the tree */
+	struct TableIndex
+	{
+		dbkey_t Id;
+		string DirectoryPath;   ///Path of the directory of the table
+		vector<size_t> Files;   ///Indexes of the files in mFiles, oldest first
+	};
+
+	bool IndexDirectory(const string& fileDir, const string& path);
+	bool ParseFileName(const string& name, TableFile& file);
+	void ReadVariationParents(const string& fileName);
+	const TableFile* FindFile(dbkey_t id) const;
+	Assignment* MakeAssignment(const TableFile& file, bool full);
+
+	bool mIsConnected;
+	string mRootDirectory;                  ///Root directory of the tree in the file system
+	vector<string> mDirectoryPaths;         ///Directories of the tree, parents before children
+	vector<TableFile> mFiles;               ///Files sorted by id
+	map<string, TableIndex> mTables;        ///Type tables by path
+	map<string, string> mVariationParents;  ///Parent of each variation by name
 };
+
 }
+
+#endif //_FileDataProvider_
@@ -72,6 +72,12 @@ public:
 	 */
 	virtual void Disconnect();
 
+	/** @brief Sets the time zone of `created` times, @see DataProvider::SetTimeZone
+	 *
+	 * cUTCTime sets the time zone of the MySQL session to UTC
+	 */
+	virtual void SetTimeZone(TimeZones timeZone);
+
 	/** @brief Parse Connection String
 	 *
 	 * @param   [in]  conStr
@@ -294,6 +300,15 @@ public:
 	 */
 	virtual bool LoadColumns(ConstantsTypeTable* table);
 
+	/** @brief Loads to the cache all not cached type tables of the paths
+	 *
+	 * All tables of the directories of the paths are selected by one query
+	 * and columns of the needed ones by another
+	 * @param [in] paths absolute paths of type tables
+	 * @return true if no errors (even if some tables are not found)
+	 */
+	virtual bool LoadConstantsTypeTables(const vector<string>& paths);
+
 	#pragma endregion Constant type table
 
 	//----------------------------------------------------------------------------------------
@@ -340,13 +355,6 @@ public:
 	//----------------------------------------------------------------------------------------
     #pragma region Variation
 
-	/** @brief Load variation by name
-	 * 
-	 * @param     const char * name
-	 * @return   DVariation*
-	 */
-	virtual Variation* GetVariation(const string& name);
-	
 	/**
 	 * @brief Searches all variations associated with this type table
 	 * @param  [out] resultVariations result variations
@@ -370,17 +378,11 @@ public:
 	virtual vector<Variation *> GetVariations(ConstantsTypeTable *table, int run=0, int take=0, int startWith=0 );
 	
 private:
-    /** @brief Load variation by name
+    /** @brief Reads all variations from DB
     * 
-    * @param     const char * name
-    * @return   DVariation*
+    * @return   bool
     */
-	virtual Variation* GetVariationById(int id);
-
-    /**
-     * Get variation by database request
-     */
-    virtual Variation* SelectVariation(const string& query);
+	virtual bool LoadVariations();
     
 	#pragma endregion Variation
 
@@ -418,6 +420,22 @@ public:
      */
     virtual Assignment* GetAssignmentShort(int run, const string& path, time_t time, const string& variation="default", bool loadColumns=false);
 
+	/** @brief Gets Assignments with data blob only for many type tables at once
+	 *
+	 * Besides loading not cached type tables, only two queries are made for any number of paths: 
+	 * the first selects the latest assignment of each table, the second reads their data blobs
+	 * @see DataProvider::GetAssignmentsShort
+	 */
+	virtual bool GetAssignmentsShort(map<string, Assignment*>& assignments, int run, const vector<string>& paths, time_t time=0, const string& variation="default");
+
+	protected:
+	/** @brief Reads run ranges of all assignments of the table in the variation chain with one query
+	 * @see DataProvider::LoadAssignmentTimeline
+	 */
+	virtual bool LoadAssignmentTimeline(AssignmentTimeline& timeline, ConstantsTypeTable* table, Variation* variation, time_t time);
+
+	public:
+
 
     
 	/** @brief Get last Assignment with all related objects
@@ -606,6 +624,12 @@ public:
 	 */
 	virtual bool FillAssignment(Assignment* assignment);
 
+	/** @brief Adds assignments in one transaction, @see DataProvider::CreateAssignments
+	 *
+	 * Run ranges that are not in the database are added in the same transaction
+	 */
+	virtual bool CreateAssignments(const vector<Assignment *>& assignments);
+
 
 	#pragma endregion Assignments
         
@@ -673,6 +697,22 @@ protected:
 	 * @return string to incert in query
 	 */
 	string PrepareCommentForInsert(const string& comment);
+
+	/** @brief Escapes the string and puts it in quotes for INSERT statement
+	 *
+	 * @param	[in] str
+	 * @return string to insert in query
+	 */
+	string PrepareStringForInsert(const string& str);
+
+	/** Adds the run range, constant set, assignment and log record of one assignment of CreateAssignments
+	 *
+	 * @return false if a query failed, the transaction should be rolled back then
+	 */
+	bool InsertAssignment(Assignment* assignment);
+
+	/** Sets the session time zone for the time zone of `created` times @see SetTimeZone */
+	bool ApplySessionTimeZone();
 	
 	/**
 	 * @brief Converts wildcard * and ? to MySQL like % _ in the string
@@ -722,9 +762,6 @@ private:
 	
 	string mLastShortQuerry;  //full text of last short assignment query
 	
-    //VARIATIONs WORK
-    Variation* mLastVariation;                     ///Last requested variation ID. Used for caching
-	
 
 #pragma endregion Private
 
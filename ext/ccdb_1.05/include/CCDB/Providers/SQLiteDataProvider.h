@@ -74,6 +74,15 @@ public:
 	 */
 	virtual bool CheckConnection(const string& errorSource="");
 
+	/** @brief Opens next connections read only and without SQLite mutexes
+	 *
+	 * Used for providers of a DataProviderPool. Each of them is used by one thread at a time,
+	 * so SQLite doesn't need to serialize calls on the connection
+	 * @param [in] readOnly - open with SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX
+	 */
+	void SetReadOnly(bool readOnly) { mIsReadOnly = readOnly; }
+	bool GetReadOnly() const { return mIsReadOnly; }
+
 	//----------------------------------------------------------------------------------------
 	//	D I R E C T O R Y   M A N G E M E N T
 	//----------------------------------------------------------------------------------------
@@ -276,6 +285,15 @@ public:
 	 */
 	virtual bool LoadColumns(ConstantsTypeTable* table);
 
+	/** @brief Loads to the cache all not cached type tables of the paths
+	 *
+	 * All tables of the directories of the paths are selected by one query
+	 * and columns of the needed ones by another
+	 * @param [in] paths absolute paths of type tables
+	 * @return true if no errors (even if some tables are not found)
+	 */
+	virtual bool LoadConstantsTypeTables(const vector<string>& paths);
+
 	
 
 	//----------------------------------------------------------------------------------------
@@ -317,13 +335,6 @@ public:
 	//----------------------------------------------------------------------------------------
 	//	V A R I A T I O N
 	//----------------------------------------------------------------------------------------
-	/** @brief Load variation by name
-	 * 
-	 * @param     const char * name
-	 * @return   DVariation*
-	 */
-	virtual Variation* GetVariation(const string& name);
-	
 	/**
 	 * @brief Searches all variations associated with this type table
 	 * @param  [out] resultVariations result variations
@@ -350,21 +361,11 @@ public:
 	
 	private:
 
-    /** @brief Load variation by DB id
-	 * 
-	 * @param     const char * name
-	 * @return   DVariation*
-	 */
-    Variation* GetVariationById(dbkey_t id);
-
-     /** @brief Executes statement and create Variation object. 
+    /** @brief Reads all variations from DB
 	 * 
-     * mStatement should be prepared when calling the function. 
-     * The assumed data order in prepared statement is:
-     * `id`, `parentId`, `name` 
-	 * @return   DVariation*
+	 * @return   bool
 	 */
-    Variation *SelectVariation();
+    virtual bool LoadVariations();
 
 	//----------------------------------------------------------------------------------------
 	//	A S S I G N M E N T S
@@ -397,6 +398,22 @@ public:
      * @return new DAssignment object or 
      */
     virtual Assignment* GetAssignmentShort(int run, const string& path, time_t time, const string& variation="default", bool loadColumns =false);
+
+	/** @brief Gets Assignments with data blob only for many type tables at once
+	 *
+	 * Besides loading not cached type tables, only two queries are made for any number of paths: 
+	 * the first selects the latest assignment of each table, the second reads their data blobs
+	 * @see DataProvider::GetAssignmentsShort
+	 */
+	virtual bool GetAssignmentsShort(map<string, Assignment*>& assignments, int run, const vector<string>& paths, time_t time=0, const string& variation="default");
+
+	protected:
+	/** @brief Reads run ranges of all assignments of the table in the variation chain with one query
+	 * @see DataProvider::LoadAssignmentTimeline
+	 */
+	virtual bool LoadAssignmentTimeline(AssignmentTimeline& timeline, ConstantsTypeTable* table, Variation* variation, time_t time);
+
+	public:
      
     
 	/** @brief Get last Assignment with all related objects
@@ -585,6 +602,24 @@ public:
 	 * @return true if success and assignment was filled with data
 	 */
 	virtual bool FillAssignment(Assignment* assignment);
+
+	/** @brief Adds assignments in one transaction, @see DataProvider::CreateAssignments
+	 *
+	 * Run ranges that are not in the database are added in the same transaction.
+	 * The provider should not be opened read only, @see SetReadOnly
+	 */
+	virtual bool CreateAssignments(const vector<Assignment *>& assignments);
+
+	/** @brief Adds the index that covers assignment lookups by type table, variation and time
+	 *
+	 * The index is on `assignments` (`constantSetId`, `variationId`, `created`, `runRangeId`).
+	 * The type table of an assignment is in `constantSets`, which already has an index by
+	 * `constantTypeId`, so with this index the lookups don't read the `assignments` rows.
+	 * Nothing is done if the index exists. The provider should not be opened read only
+	 *
+	 * @return false if the index could not be added
+	 */
+	bool CreateAssignmentsLookupIndex();
 	
 protected:
 	
@@ -632,9 +667,41 @@ protected:
 	 */
 	bool FetchRow();
 
-    /** prepares preparedStatemets for use
+    /** @brief Gets prepared statement for the query from the cache or prepares it
+     *
+     * Statements are cached per connection by the query text and are reused
+     * after sqlite3_reset and sqlite3_clear_bindings. The statement is also set to mStatement.
+     * Cached statements must never be finalized by the caller, use ReleaseStatement() instead.
+     *
+     * @param   [in] query - SQL query text, also the cache key
+     * @param   [in] functionName - name of the calling function for error reporting
+     * @return  prepared statement or NULL if the query could not be prepared
+     */
+    sqlite3_stmt* GetCachedStatement(const char* query, const char* functionName);
+
+    /** Resets cached mStatement, so it releases its read lock and could be used again
      */
-    bool InitializePreparedStatements(){ return false;} //TODO implement PreparedStatements for GetAssignmentShort functions
+    void ReleaseStatement();
+
+    /** Finalizes all cached statements. Should be called before the connection is closed
+     */
+    void FinalizeCachedStatements();
+
+    /** Runs a cached query that returns no rows, like BEGIN or COMMIT
+     */
+    bool ExecuteStatement(const char* query, const char* functionName);
+
+    /** Adds the run range, constant set, assignment and log record of one assignment of CreateAssignments
+     *
+     * @return false if a query failed, the transaction should be rolled back then
+     */
+    bool InsertAssignment(Assignment* assignment, const char* functionName);
+
+    /** Id of the run range without a name with runMin and runMax. It is added if there is none
+     *
+     * @return the id or 0 if a query failed
+     */
+    dbkey_t GetOrInsertRunRange(int runMin, int runMax, const char* functionName);
 
 	//read of row fields
 	bool IsNullOrUnreadable(int fieldNum);		///Check if the field is NULL or is unreadable. If it is Unreadable
@@ -688,6 +755,7 @@ private:
 	bool mHaveUnfreeResults; 			//indicates that we have some unfree results from mysql, that must be freed
 	sqlite3 *		mDatabase;			//Handler to sqlite object
 	sqlite3_stmt *	mStatement;
+	map<string, sqlite3_stmt*> mCachedStatements;	///Prepared statements by query text. Owned by the connection
 
 	vector<vector<string> > mRow;
 	
@@ -697,11 +765,9 @@ private:
 	//SQLITE_ULONG mLastInsertedId;		//number of last id
 	
 	bool mIsConnected;					//indicates connection to db
+	bool mIsReadOnly;					//next connection is opened read only. @see SetReadOnly
 	dbkey_t mLastInsertedId;
 
-	
-    //VARIATIONs WORK
-    Variation* mLastVariation;                    ///Last requested variation. Used for caching
 
 };
 }
@@ -0,0 +1,101 @@
+#ifndef _SQLiteIndexAdvisor_
+#define _SQLiteIndexAdvisor_
+
+#include <string>
+#include <vector>
+
+struct sqlite3;
+
+using namespace std;
+
+namespace ccdb
+{
+
+/** @brief Checks that a CCDB SQLite file has the indexes SQLiteDataProvider queries need
+ *
+ * Files converted from a MySQL dump don't always get all indexes of the CCDB schema,
+ * and SQLite then scans whole tables, `assignments` the first, on every request.
+ * The advisor shows the query plan of each kind of query the provider makes and
+ * adds the indexes that are missing:
+ *
+ *   SQLiteIndexAdvisor advisor;
+ *   advisor.Open("clas12.sqlite", false);
+ *   vector<SQLiteIndexAdvisor::Index> created;
+ *   advisor.CreateMissingIndexes(created);
+ *
+ * The indexes it adds are those SQLiteDataProvider::CreateAssignmentsLookupIndex
+ * adds and the ones the CCDB schema has for type tables, columns and run ranges.
+ */
+class SQLiteIndexAdvisor
+{
+public:
+
+	/** @brief Plan of one kind of query the provider makes */
+	struct QueryPlan
+	{
+		string Name;            ///What the provider uses the query for
+		string Query;           ///The query, with sample ids where the provider inserts them
+		vector<string> Steps;   ///Lines of EXPLAIN QUERY PLAN
+		bool HasFullScan;       ///True if a table is read in whole although the query selects by id
+	};
+
+	/** @brief Index the provider queries need */
+	struct Index
+	{
+		string Name;            ///Name the index is created with
+		string Table;
+		vector<string> Columns;
+	};
+
+	SQLiteIndexAdvisor();
+	~SQLiteIndexAdvisor();
+
+	/** @brief Opens the existing SQLite file
+	 * @param [in] readOnly - if true indexes can't be created
+	 * @return false if the file can't be opened, @see GetErrorMessage
+	 */
+	bool Open(const string& fileName, bool readOnly=true);
+
+	void Close();
+
+	bool IsOpen() const { return mDatabase != NULL; }
+
+	const string& GetErrorMessage() const { return mErrorMessage; }
+
+	/** @brief Indexes the provider queries need, whether the file has them or not */
+	static vector<Index> GetIndexes();
+
+	/** @brief Explains the queries of the provider
+	 * @return false if a query can't be explained, for example a table is missing
+	 */
+	bool ExplainQueries(vector<QueryPlan>& plans);
+
+	/** @brief Indexes of GetIndexes the file lacks
+	 *
+	 * An index is there if any index of the table starts with its columns, whatever its name
+	 */
+	bool FindMissingIndexes(vector<Index>& missing);
+
+	/** @brief Creates the missing indexes in one transaction and runs ANALYZE
+	 *
+	 * ANALYZE is run even if nothing was missing, so the query planner has statistics
+	 * @param [out] created - the indexes that were created
+	 * @return false if the file is opened read only or an index can't be created
+	 */
+	bool CreateMissingIndexes(vector<Index>& created);
+
+private:
+	bool Execute(const string& query);
+	bool ReadIndexColumns(const string& table, vector<vector<string> >& indexes);
+	void SetError(const string& what);
+
+	sqlite3* mDatabase;
+	string mErrorMessage;
+
+	SQLiteIndexAdvisor(const SQLiteIndexAdvisor& rhs);
+	SQLiteIndexAdvisor& operator=(const SQLiteIndexAdvisor& rhs);
+};
+
+}
+
+#endif // _SQLiteIndexAdvisor_
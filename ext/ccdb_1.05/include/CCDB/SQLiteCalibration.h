@@ -48,6 +48,9 @@ public:
      * @see SQLiteCalibration
      * sqlite://<path to sqlite file>
      *
+     * "?pool=N" at the end of the connection string makes a pool of N connections
+     * to load assignments from many threads at once. @see GetProviderPoolSize
+     *
      * @param connectionString the Connection String
      * @return true if connected
      */
@@ -68,6 +71,11 @@ public:
 	 */
 	virtual bool IsConnected();
 
+protected:
+	/** @brief Creates a provider for a pool of connections, @see Calibration::ConnectProviderPool
+	 */
+	virtual DataProvider * CreatePoolProvider();
+
 private:
     SQLiteCalibration(const SQLiteCalibration& rhs);
     SQLiteCalibration& operator=(const SQLiteCalibration& rhs);
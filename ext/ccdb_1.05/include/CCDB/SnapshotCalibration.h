@@ -0,0 +1,89 @@
+#ifndef SnapshotCalibration_h
+#define SnapshotCalibration_h
+
+#include <map>
+#include <string>
+
+#include "CCDB/Calibration.h"
+#include "CCDB/Helpers/SnapshotFile.h"
+
+using namespace std;
+
+namespace ccdb
+{
+
+/** @brief Calibration that reads constants from a snapshot file
+ *
+ * The connection string is snapshot://<path to the snapshot file>, @see SnapshotFile.
+ * There is no database provider behind it: the snapshot is mapped on Connect and
+ * every request is served from the mapped file, so many jobs of a production share
+ * the same pages instead of each one querying the database.
+ *
+ * A snapshot holds the constants of one run, variation and time. Requests for
+ * another variation or time, or a run outside of the run range of a table, throw
+ * std::logic_error rather than silently returning the constants of the snapshot.
+ */
+class SnapshotCalibration: public Calibration
+{
+public:
+	/** @brief Ctor takes default run number and default variation, @see SQLiteCalibration */
+	SnapshotCalibration(int defaultRun, string defaultVariation="default", time_t defaultTime=0);
+
+	/** @brief Just a default ctor */
+	SnapshotCalibration();
+
+	virtual ~SnapshotCalibration();
+
+	/** @brief Maps the snapshot file
+	 *
+	 * @param connectionString snapshot://<path to the snapshot file>
+	 * @return true if the file is a valid snapshot, @see GetErrorMessage otherwise
+	 */
+	virtual bool Connect(std::string connectionString);
+
+	/** @brief Unmaps the snapshot file */
+	virtual void Disconnect();
+
+	/** @brief indicates ether the snapshot file is mapped or not */
+	virtual bool IsConnected();
+
+	/** @brief The connection string of the last successful @see Connect */
+	virtual string GetConnectionString() const;
+
+	/** @brief Gets the assignment of a table of the snapshot, NULL if the snapshot has no such table
+	 * @see Calibration::GetAssignment
+	 */
+	virtual Assignment * GetAssignment(const string& namepath, bool loadColumns = true);
+
+	/** @brief Gets assignments of many tables of the snapshot, @see Calibration::GetAssignments */
+	virtual bool GetAssignments(map<string, Assignment *> &assignments, const vector<string>& namepaths);
+
+	/** @brief Gets assignments of all tables of the snapshot in the directory, @see Calibration::GetDirectoryAssignments */
+	virtual bool GetDirectoryAssignments(map<string, Assignment *> &assignments, const string& directoryPath);
+
+	/** @brief Get list of all tables of the snapshot, @see Calibration::GetListOfNamepaths */
+	virtual void GetListOfNamepaths(vector<string> &namepaths);
+
+	/** @brief Description of the last Connect error */
+	const string& GetErrorMessage() const { return mSnapshot.GetErrorMessage(); }
+
+	/** @brief The mapped snapshot */
+	const SnapshotFile& GetSnapshot() const { return mSnapshot; }
+
+private:
+	Assignment * MakeAssignment(const string& namepath);
+
+	SnapshotFile mSnapshot;
+	string mConnectionString;
+	map<string, ConstantsTypeTable *> mTypeTables;   ///Type tables of the mapped snapshot by path
+	vector<ConstantsTypeTable *> mOwnedTypeTables;   ///All type tables ever made, returned assignments use them
+
+	void ClearTypeTables();
+
+	SnapshotCalibration(const SnapshotCalibration& rhs);
+	SnapshotCalibration& operator=(const SnapshotCalibration& rhs);
+};
+
+}
+
+#endif // SnapshotCalibration_h
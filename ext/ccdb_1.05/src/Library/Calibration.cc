@@ -2,6 +2,7 @@
 #include <assert.h>
 #include <iostream>
 #include <memory>
+#include <set>
 
 #include "CCDB/Calibration.h"
 #include "CCDB/GlobalMutex.h"
@@ -14,6 +15,59 @@ using namespace std;
 namespace ccdb
 {
 
+namespace
+{
+    //______________________________________________________________________________
+    double ParseDoubleCell(const StringView& cell)
+    {
+        return StringUtils::ParseDouble(cell.ToString());
+    }
+
+    //______________________________________________________________________________
+    int ParseIntCell(const StringView& cell)
+    {
+        return StringUtils::ParseInt(cell.ToString());
+    }
+
+    //______________________________________________________________________________
+    /** Splits the flat table of Calibration::GetCalib(vector<T>&, size_t&, ...) into rows */
+    template<class T>
+    bool FillRows(Calibration &calib, vector< vector<T> > &values, const string & namepath)
+    {
+        vector<T> flat;
+        size_t columnsNum = 0;
+        if(!calib.GetCalib(flat, columnsNum, namepath)) return false;
+
+        assert(values.empty());
+        size_t rowsNum = columnsNum ? flat.size() / columnsNum : 0;
+        values.resize(rowsNum);
+        for (size_t row = 0; row < rowsNum; row++)
+        {
+            values[row].assign(flat.begin() + row*columnsNum, flat.begin() + (row + 1)*columnsNum);
+        }
+        return true;
+    }
+
+    //______________________________________________________________________________
+    /** Reads a table of one row with Calibration::GetCalib(vector<T>&, size_t&, ...) */
+    template<class T>
+    bool FillRow(Calibration &calib, vector<T> &values, const string & namepath, const string& function)
+    {
+        size_t columnsNum = 0;
+        values.clear();
+        if(!calib.GetCalib(values, columnsNum, namepath)) return false;
+
+        //check data and check that the user will get what he ment...
+        if(values.size() == 0)
+            throw std::logic_error(function + ". Data has no rows. Zero rows are not supposed to be.");
+
+        if(values.size() != columnsNum)
+            throw std::logic_error(function + ". logic_error: Calling of single row vector<dataType> version of GetCalib method on dataset that has more than one rows. Use GetCalib vector<vector<dataType> > instead.");
+
+        return true;
+    }
+}
+
 //______________________________________________________________________________
 Calibration::Calibration()
 {
@@ -25,6 +79,9 @@ Calibration::Calibration()
 	mDefaultTime = 0;
     mDefaultVariation = "default";
     mReadMutex = new PthreadMutex(new PthreadSyncObject());
+    mProviderPool = NULL;
+    mTimeZone = DataProvider::cLocalTime;
+    pthread_rwlock_init(&mAssignmentsCacheLock, NULL);
     mIsAutoReconnect = true;
     mLastActivityTime=0;
 }
@@ -44,6 +101,9 @@ Calibration::Calibration(int defaultRun, string defaultVariation/*="default"*/,
     PthreadSyncObject * x = NULL;
     x = new PthreadSyncObject();
     mReadMutex = new PthreadMutex(x);
+    mProviderPool = NULL;
+    mTimeZone = DataProvider::cLocalTime;
+    pthread_rwlock_init(&mAssignmentsCacheLock, NULL);
     mIsAutoReconnect = true;
     mLastActivityTime=0;
 }
@@ -54,6 +114,12 @@ Calibration::~Calibration()
 {
     //Destructor
 
+    ClearAssignmentsCache();
+    pthread_rwlock_destroy(&mAssignmentsCacheLock);
+
+    //cached assignments pointed to type tables of the pooled providers
+    if(mProviderPool) delete mProviderPool;
+
     if(!mProviderIsLocked && mProvider!=NULL) delete mProvider;
     if(mReadMutex) delete mReadMutex;
 }
@@ -119,39 +185,26 @@ bool Calibration::GetCalib( vector< map<string, string> > &values, const string
 //______________________________________________________________________________
 bool Calibration::GetCalib( vector< map<string, double> > &values, const string & namepath )
 {
-    //read values
+    //the cells are parsed straight from the assignment, see Assignment::GetMappedData
 
-    //TODO right now the function works through copy. 
-    //one needs to find out, maybe it needs to be reimplemented
-    
-    vector<map<string, string> > rawValues;
+    Assignment *assignment = GetAssignment(namepath, true);
+    if(assignment == NULL) return false;
+
+    assert(values.empty());
     try
     {
-        if(!GetCalib(rawValues, namepath)) return false;
+        assignment->GetMappedData(values, ParseDoubleCell);
     }
-    catch (std::exception &)
+    catch (...)
     {
-    	throw;
+        delete assignment;
+        throw;
     }
+    delete assignment;
 
-    assert(values.empty());
-    
-    int rowsNum = rawValues.size();
-    int columnsNum = rawValues[0].size(); //rawTableValues[0] - size was checked in GetCalib
-
-    values.resize(rawValues.size());
-
-    //compose values
-    for (int rowIter = 0; rowIter < rowsNum; rowIter++)
-    {
-        map<string, string>::iterator iter;
-        for ( iter=rawValues[rowIter].begin() ; iter != rawValues[rowIter].end(); iter++ )
-        {
-            double tmpVal = StringUtils::ParseDouble(iter->second);
-            values[rowIter][iter->first] = tmpVal;
-        }
+    if(values.size() == 0){
+        throw std::logic_error("Calibration::GetCalib( vector< map<string, double> >&, const string&). Data has no rows. Zero rows are not supposed to be.");
     }
-
     return true;
 }
 
@@ -159,37 +212,24 @@ bool Calibration::GetCalib( vector< map<string, double> > &values, const string
 //______________________________________________________________________________
 bool Calibration::GetCalib( vector< map<string, int> > &values, const string & namepath )
 {
-    //TODO right now the function works through copy. 
-    //one needs to find out, maybe it needs to be reimplemented
+    Assignment *assignment = GetAssignment(namepath, true);
+    if(assignment == NULL) return false;
 
-    vector<map<string, string> > rawValues;
+    assert(values.empty());
     try
     {
-        if(!GetCalib(rawValues, namepath)) return false;
+        assignment->GetMappedData(values, ParseIntCell);
     }
-    catch (std::exception &)
+    catch (...)
     {
+        delete assignment;
         throw;
     }
+    delete assignment;
 
-    assert(values.empty());
-
-    int rowsNum = rawValues.size();
-    int columnsNum = rawValues[0].size(); //rawTableValues[0] - size was checked in GetCalib
-
-    values.resize(rawValues.size());
-
-    //compose values
-    for (int rowIter = 0; rowIter < rowsNum; rowIter++)
-    {
-        map<string, string>::iterator iter;
-        for ( iter=rawValues[rowIter].begin() ; iter != rawValues[rowIter].end(); iter++ )
-        {
-            int intlVal = StringUtils::ParseInt(iter->second);
-            values[rowIter][iter->first] = intlVal;
-        }
+    if(values.size() == 0){
+        throw std::logic_error("Calibration::GetCalib( vector< map<string, int> >&, const string&). Data has no rows. Zero rows are not supposed to be.");
     }
-
     return true;
 }
 
@@ -223,70 +263,14 @@ bool Calibration::GetCalib( vector< vector<string> > &values, const string & nam
 //______________________________________________________________________________
 bool Calibration::GetCalib( vector< vector<double> > &values, const string & namepath )
 {
-    //TODO right now the function works through copy. One has to check, maybe it needs to be reimplemented
-
-    vector< vector<string> > rawValues;
-    try
-    {
-        if(!GetCalib(rawValues, namepath)) return false;
-    }
-    catch (std::exception &)
-    {
-        throw;
-    }
-
-    assert(values.empty());
-
-    int rowsNum = rawValues.size();
-    int columnsNum = rawValues[0].size(); //rawTableValues[0] - size was checked in GetCalib
-
-    values.resize(rawValues.size());
-
-    //compose values
-    for (int rowIter = 0; rowIter < rowsNum; rowIter++)
-    {   
-        for (int columnsIter = 0; columnsIter < columnsNum; columnsIter++)
-        {
-            double tmpVal = StringUtils::ParseDouble(rawValues[rowIter][columnsIter]);
-            values[rowIter].push_back(tmpVal);
-        }
-    }
-
-    return true;
+    return FillRows(*this, values, namepath);
 }
 
 
 //______________________________________________________________________________
 bool Calibration::GetCalib( vector< vector<int> > &values, const string & namepath )
 {
-    vector< vector<string> > rawValues;
-    try
-    {
-        if(!GetCalib(rawValues, namepath)) return false;
-    }
-    catch (std::exception &)
-    {
-        throw;
-    }
-
-    assert(values.empty());
-
-    int rowsNum = rawValues.size();
-    int columnsNum = rawValues[0].size(); //rawTableValues[0] - size was checked in GetCalib
-
-    values.resize(rawValues.size());
-
-    //compose values
-    for (int rowIter = 0; rowIter < rowsNum; rowIter++)
-    {   
-        for (int columnsIter = 0; columnsIter < columnsNum; columnsIter++)
-        {
-            int tmpVal = StringUtils::ParseInt(rawValues[rowIter][columnsIter]);
-            values[rowIter].push_back(tmpVal);
-        }
-    }
-
-    return true;
+    return FillRows(*this, values, namepath);
 }
 
 
@@ -463,54 +447,14 @@ bool Calibration::GetCalib( vector<string> &values, const string & namepath )
 //______________________________________________________________________________
 bool Calibration::GetCalib( vector<double> &values, const string & namepath )
 {
-    vector<string> rawValues;
-    try
-    {
-        if(!GetCalib(rawValues, namepath)) return false;
-    }
-    catch (std::exception &)
-    {
-        throw;
-    }
-    
-    int columnsNum = rawValues.size(); //rawTableValues[0] - size was checked in GetCalib    
-
-    values.resize(rawValues.size());
-
-    //compose values
-    for (int columnsIter = 0; columnsIter < columnsNum; columnsIter++)
-    {
-        double tmpVal = StringUtils::ParseDouble(rawValues[columnsIter]);
-        values[columnsIter] = tmpVal;
-    }
-    return true;
+    return FillRow(*this, values, namepath, "Calibration::GetCalib(vector<double> &, const string &)");
 }
 
 
 //______________________________________________________________________________
 bool Calibration::GetCalib( vector<int> &values, const string & namepath )
 {
-    vector<string> rawValues;
-    try
-    {
-        if(!GetCalib(rawValues, namepath)) return false;
-    }
-    catch (std::exception &)
-    {
-        throw;
-    }
-
-    int columnsNum = rawValues.size(); //rawTableValues[0] - size was checked in GetCalib
-
-    values.resize(rawValues.size());
-
-    //compose values
-    for (int columnsIter = 0; columnsIter < columnsNum; columnsIter++)
-    {
-        int tmpVal = StringUtils::ParseInt(rawValues[columnsIter]);
-        values[columnsIter] = tmpVal;
-    }
-    return true;
+    return FillRow(*this, values, namepath, "Calibration::GetCalib(vector<int> &, const string &)");
 }
 
 //______________________________________________________________________________
@@ -565,6 +509,7 @@ bool Calibration::GetCalib(int &value, const string & namepath)
 string Calibration::GetConnectionString() const
 {
     //
+    if (mProvider!=NULL && mProviderPool!=NULL) return mProvider->GetConnectionString() + StringUtils::Format("?pool=%i", (int)mProviderPool->GetSize());
     if (mProvider!=NULL) return mProvider->GetConnectionString();
     
     return string();
@@ -583,35 +528,142 @@ Assignment * Calibration::GetAssignment(const string& namepath, bool loadColumns
      * @return   DAssignment *
      */
 
-	UpdateActivityTime();
-
     RequestParseResult result = PathUtils::ParseRequest(namepath);
     string variation = (result.WasParsedVariation ? result.Variation : mDefaultVariation);
     int run  = (result.WasParsedRunNumber ? result.RunNumber : mDefaultRun);
-    Assignment* assigment = NULL;
-    
+    string path = PathUtils::MakeAbsolute(result.Path);
+    time_t time = (result.WasParsedTime ? result.Time : mDefaultTime);
+
+    //the cache doesn't need the provider, so it is looked up before the provider lock
+    string cacheKey = StringUtils::Format("%lu:", (unsigned long)time) + variation + ":" + path;
+    Assignment* assigment = FindCachedAssignment(cacheKey, run);
+    if(assigment) return assigment;
+
+	UpdateActivityTime();
     CheckConnection();  // Check if is connected and reconnect if needed (and allowed)
 	
     //Lock();Unlock();
-    mReadMutex->Lock();
+    DataProvider *provider = AcquireProvider();
     if(result.WasParsedTime)
     {
-        assigment = mProvider->GetAssignmentShort(run, PathUtils::MakeAbsolute(result.Path), result.Time, variation,loadColumns);
+        assigment = provider->GetAssignmentShort(run, PathUtils::MakeAbsolute(result.Path), result.Time, variation,loadColumns);
     }
 	else if (mDefaultTime>0)
 	{
-		assigment = mProvider->GetAssignmentShort(run, PathUtils::MakeAbsolute(result.Path), mDefaultTime, variation,loadColumns);
+		assigment = provider->GetAssignmentShort(run, PathUtils::MakeAbsolute(result.Path), mDefaultTime, variation,loadColumns);
 	}
 	else
 	{
-		assigment = mProvider->GetAssignmentShort(run, PathUtils::MakeAbsolute(result.Path), variation,loadColumns);
+		assigment = provider->GetAssignmentShort(run, PathUtils::MakeAbsolute(result.Path), variation,loadColumns);
 	}
-	
-    mReadMutex->Release();
+
+    //the caller owns the assignment. Deleting a provider owned one would change the provider without the lock
+    if(assigment) provider->ReleaseOwnership(assigment);
+    ReleaseProvider(provider);
+
+    if(assigment) CacheAssignment(cacheKey, run, assigment);
     return assigment;
 }
 
 
+//______________________________________________________________________________
+Assignment * Calibration::FindCachedAssignment(const string& key, int run)
+{
+    pthread_rwlock_rdlock(&mAssignmentsCacheLock);
+
+    CachedAssignment *cached = NULL;
+    map<string, CachedAssignmentsByRun>::iterator keyIter = mAssignmentsCache.find(key);
+    if(keyIter != mAssignmentsCache.end())
+    {
+        CachedAssignmentsByRun::iterator runIter = keyIter->second.upper_bound(run);
+        if(runIter != keyIter->second.begin())
+        {
+            --runIter;
+            if(run <= runIter->second->RunMax) cached = runIter->second;
+        }
+    }
+
+    //the data is copied while the lock is held, ClearAssignmentsCache may delete the entry right after
+    Assignment *assignment = NULL;
+    if(cached)
+    {
+        assignment = new Assignment();
+        assignment->SetId(cached->Id);
+        assignment->SetRawData(cached->RawData);
+        assignment->SetRequestedRun(run);
+        assignment->SetValidRuns(cached->RunMin, cached->RunMax);
+        assignment->SetTypeTable(cached->TypeTable);
+    }
+
+    pthread_rwlock_unlock(&mAssignmentsCacheLock);
+    return assignment;
+}
+
+
+//______________________________________________________________________________
+void Calibration::CacheAssignment(const string& key, int run, Assignment * assignment)
+{
+    CachedAssignment *cached = new CachedAssignment();
+    cached->Id = assignment->GetId();
+    cached->RawData = assignment->GetRawData();
+    cached->TypeTable = assignment->GetTypeTable();
+
+    //if the provider doesn't know the valid runs, the assignment is cached for the requested run only
+    cached->RunMin = run;
+    cached->RunMax = run;
+    if(assignment->GetValidRunMin() <= run && run <= assignment->GetValidRunMax())
+    {
+        cached->RunMin = assignment->GetValidRunMin();
+        cached->RunMax = assignment->GetValidRunMax();
+    }
+
+    pthread_rwlock_wrlock(&mAssignmentsCacheLock);
+
+    //another thread may have cached it meanwhile
+    CachedAssignmentsByRun &runs = mAssignmentsCache[key];
+    CachedAssignmentsByRun::iterator runIter = runs.find(cached->RunMin);
+    if(runIter == runs.end())
+    {
+        runs[cached->RunMin] = cached;
+        cached = NULL;
+    }
+
+    pthread_rwlock_unlock(&mAssignmentsCacheLock);
+    delete cached;
+}
+
+
+//______________________________________________________________________________
+void Calibration::ClearAssignmentsCache()
+{
+    pthread_rwlock_wrlock(&mAssignmentsCacheLock);
+
+    map<string, CachedAssignmentsByRun>::iterator keyIter = mAssignmentsCache.begin();
+    for(; keyIter != mAssignmentsCache.end(); ++keyIter)
+    {
+        CachedAssignmentsByRun::iterator runIter = keyIter->second.begin();
+        for(; runIter != keyIter->second.end(); ++runIter) delete runIter->second;
+    }
+    mAssignmentsCache.clear();
+
+    pthread_rwlock_unlock(&mAssignmentsCacheLock);
+}
+
+
+//______________________________________________________________________________
+size_t Calibration::GetAssignmentsCacheSize()
+{
+    pthread_rwlock_rdlock(&mAssignmentsCacheLock);
+
+    size_t size = 0;
+    map<string, CachedAssignmentsByRun>::iterator keyIter = mAssignmentsCache.begin();
+    for(; keyIter != mAssignmentsCache.end(); ++keyIter) size += keyIter->second.size();
+
+    pthread_rwlock_unlock(&mAssignmentsCacheLock);
+    return size;
+}
+
+
 //______________________________________________________________________________
 void Calibration::Lock()
 {
@@ -628,6 +680,153 @@ void Calibration::Unlock()
 }
 
 
+//______________________________________________________________________________
+bool Calibration::GetAssignments(map<string, Assignment *> &assignments, const vector<string>& namepaths)
+{
+    /** @brief Gets assignments of many tables at once
+     *
+     * @remark the function is thread safe
+     *
+     * @parameter [out] assignments - assignments by namepath. The caller owns the assignments
+     * @parameter [in]  namepaths - /path/to/data:run:variation:time namepaths
+     * @return   false if there was an error in the provider
+     */
+
+    UpdateActivityTime();
+
+    //group the requests by run, variation and time
+    map<string, vector<size_t> > groups;
+    vector<RequestParseResult> requests(namepaths.size());
+    set<string> requested;
+    for(size_t i=0; i<namepaths.size(); i++)
+    {
+        if(!requested.insert(namepaths[i]).second) continue;  //the same namepath gets one assignment
+
+        RequestParseResult& request = requests[i];
+        request = PathUtils::ParseRequest(namepaths[i]);
+        request.Path = PathUtils::MakeAbsolute(request.Path);
+        if(!request.WasParsedVariation) request.Variation = mDefaultVariation;
+        if(!request.WasParsedRunNumber) request.RunNumber = mDefaultRun;
+        if(!request.WasParsedTime) request.Time = mDefaultTime;
+
+        string key = StringUtils::Format("%i:%lu:", request.RunNumber, (unsigned long)request.Time) + request.Variation;
+        groups[key].push_back(i);
+    }
+
+    CheckConnection();  // Check if is connected and reconnect if needed (and allowed)
+
+    bool ok = true;
+    map<string, vector<size_t> >::iterator groupIter = groups.begin();
+    for(; groupIter != groups.end() && ok; ++groupIter)
+    {
+        const RequestParseResult& context = requests[groupIter->second[0]];
+
+        //namepaths like "/a/t" and "/a/t::default" may ask for the same table. Each gets
+        //its own assignment: the first ones of each table are loaded now, the others by
+        //the next round of the loop
+        vector<size_t> pending = groupIter->second;
+        while(!pending.empty() && ok)
+        {
+            vector<size_t> indexes, duplicates;
+            set<string> paths;
+            for(size_t i=0; i<pending.size(); i++)
+            {
+                if(paths.insert(requests[pending[i]].Path).second) indexes.push_back(pending[i]);
+                else duplicates.push_back(pending[i]);
+            }
+
+            map<string, Assignment *> found;
+            DataProvider *provider = AcquireProvider();
+            ok = provider->GetAssignmentsShort(found, context.RunNumber, vector<string>(paths.begin(), paths.end()), context.Time, context.Variation);
+            map<string, Assignment *>::iterator releaseIter = found.begin();
+            for(; releaseIter != found.end(); ++releaseIter) provider->ReleaseOwnership(releaseIter->second);
+            ReleaseProvider(provider);
+
+            for(size_t i=0; i<indexes.size(); i++)
+            {
+                map<string, Assignment *>::iterator foundIter = found.find(requests[indexes[i]].Path);
+                if(foundIter == found.end()) continue;
+                assignments[namepaths[indexes[i]]] = foundIter->second;
+            }
+
+            //tables that were not found are not looked up again
+            pending.clear();
+            for(size_t i=0; i<duplicates.size(); i++)
+            {
+                if(found.count(requests[duplicates[i]].Path)) pending.push_back(duplicates[i]);
+            }
+        }
+    }
+
+    return ok;
+}
+
+
+//______________________________________________________________________________
+bool Calibration::GetDirectoryAssignments(map<string, Assignment *> &assignments, const string& directoryPath)
+{
+    /** @brief Gets assignments of all tables in the directory and its subdirectories at once
+     *
+     * @parameter [out] assignments - assignments by absolute table path. The caller owns the assignments
+     * @parameter [in]  directoryPath - path to the directory, i.e. "/calibration/ftof"
+     * @return   false if there was an error in the provider
+     */
+
+    UpdateActivityTime();
+    CheckConnection();  // Check if is connected and reconnect if needed (and allowed)
+
+    vector<ConstantsTypeTable*> tables;
+    mReadMutex->Lock();
+    bool ok = mProvider->SearchConstantsTypeTables(tables, "*");
+    mReadMutex->Release();
+    if(!ok) return false;
+
+    string prefix = directoryPath;
+    prefix = PathUtils::MakeAbsolute(prefix);
+    if(prefix[prefix.length()-1] != '/') prefix += '/';
+
+    vector<string> paths;
+    for (size_t i=0; i< tables.size(); i++)
+    {
+        if(tables[i]->GetFullPath().compare(0, prefix.length(), prefix) == 0)
+        {
+            paths.push_back(tables[i]->GetFullPath());
+        }
+        delete tables[i];
+    }
+
+    return GetAssignments(assignments, paths);
+}
+
+
+//______________________________________________________________________________
+bool Calibration::CreateAssignments(const vector<Assignment *>& assignments)
+{
+    UpdateActivityTime();
+    CheckConnection();  // Check if is connected and reconnect if needed (and allowed)
+    if(mProvider == NULL) return false;
+
+    mReadMutex->Lock();
+    bool ok = mProvider->CreateAssignments(assignments);
+    mReadMutex->Release();
+    if(!ok) return false;
+
+    ClearAssignmentsCache();
+    if(mProviderPool)
+    {
+        //all providers are checked out, so none of them is loading while its timelines are dropped
+        vector<DataProvider *> providers;
+        for(size_t i=0; i<mProviderPool->GetSize(); i++) providers.push_back(mProviderPool->Acquire(false));
+        for(size_t i=0; i<providers.size(); i++)
+        {
+            providers[i]->InvalidateAssignmentTimelines();
+            mProviderPool->Release(providers[i]);
+        }
+    }
+    return true;
+}
+
+
 //______________________________________________________________________________
 void Calibration::GetListOfNamepaths( vector<string> &namepaths )
 {
@@ -687,6 +886,91 @@ bool Calibration::Reconnect()
 }
 
 
+//______________________________________________________________________________
+int Calibration::ExtractPoolSize(string& connectionString)
+{
+    size_t pos = connectionString.rfind("?pool=");
+    if(pos == string::npos) return 1;
+
+    int size = StringUtils::ParseInt(connectionString.substr(pos + 6));
+    connectionString.erase(pos);
+    return size;
+}
+
+
+//______________________________________________________________________________
+bool Calibration::ConnectProviderPool(const string& connectionString, int size)
+{
+    mProvider->SetTimeZone(mTimeZone);
+
+    if(mProviderPool == NULL)
+    {
+        if(size < 2) return true;
+
+        DataProvider *provider = CreatePoolProvider();
+        if(provider == NULL) return true;   //not supported, mProvider does all the work
+
+        mProviderPool = new DataProviderPool(connectionString);
+        provider->SetTimeZone(mTimeZone);
+        mProviderPool->Add(provider);
+        for(int i=1; i<size; i++)
+        {
+            provider = CreatePoolProvider();
+            provider->SetTimeZone(mTimeZone);
+            mProviderPool->Add(provider);
+        }
+    }
+    return mProviderPool->Connect();
+}
+
+
+//______________________________________________________________________________
+void Calibration::SetTimeZone(DataProvider::TimeZones timeZone)
+{
+    mReadMutex->Lock();
+    mTimeZone = timeZone;
+    if(mProvider != NULL) mProvider->SetTimeZone(timeZone);
+    mReadMutex->Release();
+
+    if(mProviderPool)
+    {
+        //all providers are checked out, so none of them is loading while the time zone changes
+        vector<DataProvider *> providers;
+        for(size_t i=0; i<mProviderPool->GetSize(); i++) providers.push_back(mProviderPool->Acquire(false));
+        for(size_t i=0; i<providers.size(); i++)
+        {
+            providers[i]->SetTimeZone(timeZone);
+            mProviderPool->Release(providers[i]);
+        }
+    }
+
+    //assignments cached for a time were selected in the other time zone
+    ClearAssignmentsCache();
+}
+
+
+//______________________________________________________________________________
+DataProvider * Calibration::AcquireProvider()
+{
+    if(mProviderPool) return mProviderPool->Acquire();
+
+    mReadMutex->Lock();
+    return mProvider;
+}
+
+
+//______________________________________________________________________________
+void Calibration::ReleaseProvider(DataProvider * provider)
+{
+    if(mProviderPool)
+    {
+        mProviderPool->Release(provider);
+        return;
+    }
+    mReadMutex->Release();
+}
+
+
 //______________________________________________________________________________
 void Calibration::CheckConnection()
 {
@@ -3,6 +3,8 @@
 
 #include "CCDB/CalibrationGenerator.h"
 #include "CCDB/SQLiteCalibration.h"
+#include "CCDB/SnapshotCalibration.h"
+#include "CCDB/FileCalibration.h"
 #include "CCDB/Providers/SQLiteDataProvider.h"
 #include "CCDB/Helpers/TimeProvider.h"
 #ifdef CCDB_MYSQL
@@ -29,9 +31,15 @@ Calibration* CalibrationGenerator::CreateCalibration(const std::string & connect
 	 */
 
 
-	//is it sqlite or mysql
+	//is it sqlite, mysql, a snapshot or a directory of files
 	bool isMySql = false; //if false SQlite provider is used		
-	if(connectionString.find("mysql://")==0)
+	bool isSnapshot = connectionString.find("snapshot://")==0;
+	bool isFile = connectionString.find("file://")==0;
+	if(isSnapshot || isFile)
+	{
+		//snapshot file has no provider, files have their own calibration
+	}
+	else if(connectionString.find("mysql://")==0)
 	{		
 		isMySql = true;  //It is mysql
 		
@@ -45,17 +53,20 @@ Calibration* CalibrationGenerator::CreateCalibration(const std::string & connect
 		if(connectionString.find("sqlite://")!=0)
 		{	
 			//something wrong here!!!
-			throw std::logic_error("Unknown connection string type. mysql:// and sqlite:// are only known types now. The connection string: " + connectionString);
+			throw std::logic_error("Unknown connection string type. mysql://, sqlite://, snapshot:// and file:// are only known types now. The connection string: " + connectionString);
 		}
 	}
 	
 	//now we create calibration
-	Calibration * calib = CreateCalibration(isMySql, run, variation, time);    
+	Calibration * calib = isSnapshot ? new SnapshotCalibration(run, variation, time)
+	                    : isFile     ? new FileCalibration(run, variation, time)
+	                                 : CreateCalibration(isMySql, run, variation, time);    
 
     //Connect!
     if(!calib->Connect(connectionString))
     {
         string message = GetConnectionErrorMessage(calib);
+        delete calib;
         throw std::logic_error(message);
     }
 
@@ -71,6 +82,8 @@ bool CalibrationGenerator::CheckOpenable( const std::string & str)
 	#endif
 
 	if(str.find("sqlite://")== 0) return true;
+	if(str.find("snapshot://")== 0) return true;
+	if(str.find("file://")== 0) return true;
     return false;
 }
 
@@ -110,9 +123,15 @@ Calibration* CalibrationGenerator::MakeCalibration( const std::string & connecti
 		return mCalibrationsByHash[calibHash];
 	}
 
-	//is it sqlite or mysql
+	//is it sqlite, mysql, a snapshot or a directory of files
 	bool isMySql = false; //if false SQlite provider is used		
-	if(connectionString.find("mysql://")==0)
+	bool isSnapshot = connectionString.find("snapshot://")==0;
+	bool isFile = connectionString.find("file://")==0;
+	if(isSnapshot || isFile)
+	{
+		//snapshot file has no provider, files have their own calibration
+	}
+	else if(connectionString.find("mysql://")==0)
 	{		
 		isMySql = true;  //It is mysql
 		
@@ -126,12 +145,14 @@ Calibration* CalibrationGenerator::MakeCalibration( const std::string & connecti
 		if(connectionString.find("sqlite://")!=0)
 		{	
 			//something wrong here!!!
-			throw std::logic_error("Unknown connection string type. mysql:// and sqlite:// are only known types now. The connection string: " + connectionString);
+			throw std::logic_error("Unknown connection string type. mysql://, sqlite://, snapshot:// and file:// are only known types now. The connection string: " + connectionString);
 		}
 	}
 	
 	//now we create calibration
-	Calibration * calib = CreateCalibration(isMySql, run, variation, time);
+	Calibration * calib = isSnapshot ? new SnapshotCalibration(run, variation, time)
+	                    : isFile     ? new FileCalibration(run, variation, time)
+	                                 : CreateCalibration(isMySql, run, variation, time);
 
     //Connect!
     if(!calib->Connect(connectionString))
@@ -219,7 +240,12 @@ std::string CalibrationGenerator::GetConnectionErrorMessage( Calibration * calib
     DataProvider* provider = calib->GetProvider();
     string message("CONNECTION ERROR. ");
 
-    if(provider == NULL)
+    SnapshotCalibration* snapshot = dynamic_cast<SnapshotCalibration*>(calib);
+    if(snapshot != NULL)
+    {
+        message += snapshot->GetErrorMessage();
+    }
+    else if(provider == NULL)
     {
         message += "Can't failed to create database Provider";
     }
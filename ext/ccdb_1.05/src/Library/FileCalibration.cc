@@ -0,0 +1,134 @@
+#include <stdexcept>
+#include <assert.h>
+
+#include "CCDB/FileCalibration.h"
+#include "CCDB/Providers/FileDataProvider.h"
+#include "CCDB/Helpers/PathUtils.h"
+
+namespace ccdb
+{
+
+
+//______________________________________________________________________________
+FileCalibration::FileCalibration()
+{	
+}
+
+//______________________________________________________________________________
+FileCalibration::FileCalibration( int defaultRun, string defaultVariation/*="default"*/ , time_t defaultTime/*=0*/ )
+    :Calibration(defaultRun,defaultVariation, defaultTime)
+{
+}
+
+
+//______________________________________________________________________________
+FileCalibration::~FileCalibration()
+{   
+}
+
+
+//______________________________________________________________________________
+bool FileCalibration::Connect( std::string connectionString )
+{
+    /**
+	 * @brief Indexes the directory of table files
+	 *
+	 * @param connectionString file://<root directory>
+	 * @return true if connected
+	 */
+    int poolSize = ExtractPoolSize(connectionString);
+
+    Lock();
+
+    UpdateActivityTime();
+
+    //Create provider if needed
+    if(mProvider == NULL)
+    {
+        if(!mProviderIsLocked)
+        {
+            mProvider = new FileDataProvider();
+        }
+        else
+        {
+            Unlock();
+            //Invalid FileCalibration usage 
+            throw std::logic_error((const char*)ERRMSG_INVALID_CONNECT_USAGE);
+        }
+    }
+
+    //Maybe we are connected?
+    if(mProvider->IsConnected())
+    {
+        Unlock();
+
+        //But where we connected to?
+        if(mProvider->GetConnectionString() == connectionString)
+        {   
+            return true;
+        }
+        else
+        {
+            //The connection is open to another source. Invalid FileCalibration usage 
+            throw std::logic_error(ERRMSG_CONNECTED_TO_ANOTHER);
+        }
+    }
+
+    //Ok at this point we have not connected provider
+    //but can we connect or not?
+    if(mProviderIsLocked)
+    {
+        Unlock();
+        throw std::logic_error(ERRMSG_CONNECT_LOCKED);
+    }
+
+    bool result = mProvider->Connect(connectionString);
+    if(result) result = ConnectProviderPool(connectionString, poolSize);
+    Unlock();
+    return result;
+    //TODO decide maybe to throw an exception here?
+}
+
+
+//______________________________________________________________________________
+void FileCalibration::Disconnect()
+{
+    /**
+	 * @brief closes connection to data
+	 * Closes connection to data. 
+	 * If underlayed @see DProvider* object is "locked"
+	 * (user could check this by 
+	 * 
+	 */
+    //Ok at this point we have not connected provider
+    //but can we connect or not?
+    if(mProviderIsLocked)
+    {
+        throw std::logic_error(ERRMSG_CONNECT_LOCKED); //TODO ERRMSG_DISCONECT_LOCKED
+    }
+
+    mProvider->Disconnect();
+    if(mProviderPool) mProviderPool->Disconnect();
+}
+
+
+//______________________________________________________________________________
+DataProvider * FileCalibration::CreatePoolProvider()
+{
+    return new FileDataProvider();
+}
+
+
+//______________________________________________________________________________
+bool FileCalibration::IsConnected()
+{
+    /** @brief indicates ether the connection is open or not
+	 * 
+	 * @return true if  connection is open
+	 */
+    if(mProvider==NULL) return false;
+    return mProvider->IsConnected();
+}
+
+}
+
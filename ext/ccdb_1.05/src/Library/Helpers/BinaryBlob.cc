@@ -0,0 +1,479 @@
+#include <clocale>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "CCDB/Helpers/BinaryBlob.h"
+#include "CCDB/Helpers/NumericParser.h"
+
+using namespace std;
+using namespace ccdb;
+
+const char* BinaryBlob::Prefix = "@ccdb-bin1@";
+
+namespace
+{
+	typedef unsigned long long ull;
+
+	const char* Base64Chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	//______________________________________________________________________________
+	/** Value of a base64 character or -1 */
+	int Base64Value(char c)
+	{
+		if(c>='A' && c<='Z') return c - 'A';
+		if(c>='a' && c<='z') return c - 'a' + 26;
+		if(c>='0' && c<='9') return c - '0' + 52;
+		if(c=='+') return 62;
+		if(c=='/') return 63;
+		return -1;
+	}
+
+	//______________________________________________________________________________
+	void PutUInt(string& out, ull value, int bytes)
+	{
+		for(int i=0; i<bytes; i++)
+		{
+			out.push_back(static_cast<char>((value >> (8*i)) & 0xFF));
+		}
+	}
+
+	//______________________________________________________________________________
+	void PutDouble(string& out, double value)
+	{
+		ull bits;
+		memcpy(&bits, &value, sizeof(bits));
+		PutUInt(out, bits, 8);
+	}
+
+	/** Reads little endian values from the decoded bytes, checking the size */
+	class Reader
+	{
+	public:
+		Reader(const char* first, const char* last): mPos(first), mEnd(last) {}
+
+		bool UInt(int bytes, ull& value)
+		{
+			if(mEnd - mPos < bytes) return false;
+			value = 0;
+			for(int i=0; i<bytes; i++)
+			{
+				value |= static_cast<ull>(static_cast<unsigned char>(mPos[i])) << (8*i);
+			}
+			mPos += bytes;
+			return true;
+		}
+
+		bool Double(double& value)
+		{
+			ull bits;
+			if(!UInt(8, bits)) return false;
+			memcpy(&value, &bits, sizeof(value));
+			return true;
+		}
+
+		bool String(string& value)
+		{
+			ull size;
+			if(!UInt(4, size) || static_cast<ull>(mEnd - mPos) < size) return false;
+			value.assign(mPos, static_cast<size_t>(size));
+			mPos += size;
+			return true;
+		}
+
+		bool AtEnd() const { return mPos == mEnd; }
+
+	private:
+		const char* mPos;
+		const char* mEnd;
+	};
+
+	//______________________________________________________________________________
+	/** Encodes one cell of the column type. False if the cell doesn't read as the type */
+	bool EncodeCell(string& out, ConstantsTypeColumn::ColumnTypes type, const string& cell)
+	{
+		switch(type)
+		{
+		case ConstantsTypeColumn::cIntColumn:
+			{
+				int value;
+				if(!NumericParser::ParseExact(cell, value)) return false;
+				PutUInt(out, static_cast<unsigned int>(value), 4);
+				return true;
+			}
+		case ConstantsTypeColumn::cUIntColumn:
+			{
+				unsigned int value;
+				if(!NumericParser::ParseExact(cell, value)) return false;
+				PutUInt(out, value, 4);
+				return true;
+			}
+		case ConstantsTypeColumn::cLongColumn:
+			{
+				long long value;
+				if(!NumericParser::ParseExact(cell, value)) return false;
+				PutUInt(out, static_cast<ull>(value), 8);
+				return true;
+			}
+		case ConstantsTypeColumn::cULongColumn:
+			{
+				ull value;
+				if(!NumericParser::ParseExact(cell, value)) return false;
+				PutUInt(out, value, 8);
+				return true;
+			}
+		case ConstantsTypeColumn::cDoubleColumn:
+			{
+				double value;
+				if(!NumericParser::ParseExact(cell, value)) return false;
+				PutDouble(out, value);
+				return true;
+			}
+		case ConstantsTypeColumn::cBoolColumn:
+			{
+				bool value;
+				if(!NumericParser::ParseExact(cell, value)) return false;
+				PutUInt(out, value ? 1 : 0, 1);
+				return true;
+			}
+		default:
+			if(cell.size() > 0xFFFFFFFFul) return false;
+			PutUInt(out, cell.size(), 4);
+			out.append(cell);
+			return true;
+		}
+	}
+
+	//______________________________________________________________________________
+	/** Reads rows values of one column of the type */
+	bool DecodeColumn(Reader& reader, BinaryBlob::Column& column, size_t rows)
+	{
+		ull value;
+		for(size_t i=0; i<rows; i++)
+		{
+			switch(column.Type)
+			{
+			case ConstantsTypeColumn::cIntColumn:
+				if(!reader.UInt(4, value)) return false;
+				column.Ints.push_back(static_cast<int>(static_cast<unsigned int>(value)));
+				break;
+			case ConstantsTypeColumn::cUIntColumn:
+				if(!reader.UInt(4, value)) return false;
+				column.UInts.push_back(static_cast<unsigned int>(value));
+				break;
+			case ConstantsTypeColumn::cLongColumn:
+				{
+					if(!reader.UInt(8, value)) return false;
+					long long signedValue = static_cast<long long>(value);
+					if(signedValue < numeric_limits<long>::min() || signedValue > numeric_limits<long>::max()) return false;
+					column.Longs.push_back(static_cast<long>(signedValue));
+					break;
+				}
+			case ConstantsTypeColumn::cULongColumn:
+				if(!reader.UInt(8, value) || value > numeric_limits<unsigned long>::max()) return false;
+				column.ULongs.push_back(static_cast<unsigned long>(value));
+				break;
+			case ConstantsTypeColumn::cDoubleColumn:
+				{
+					double doubleValue;
+					if(!reader.Double(doubleValue)) return false;
+					column.Doubles.push_back(doubleValue);
+					break;
+				}
+			case ConstantsTypeColumn::cBoolColumn:
+				if(!reader.UInt(1, value)) return false;
+				column.Bools.push_back(value != 0);
+				break;
+			default:
+				{
+					string stringValue;
+					if(!reader.String(stringValue)) return false;
+					column.Strings.push_back(stringValue);
+					break;
+				}
+			}
+		}
+		return true;
+	}
+
+	//______________________________________________________________________________
+	template<class T>
+	string FormatInteger(T value)
+	{
+		char buf[32];
+		char* pos = buf + sizeof(buf);
+		bool negative = value < T();
+		ull magnitude = negative ? 0 - static_cast<ull>(value) : static_cast<ull>(value);
+		do
+		{
+			*--pos = static_cast<char>('0' + magnitude % 10);
+			magnitude /= 10;
+		} while(magnitude);
+		if(negative) *--pos = '-';
+		return string(pos, buf + sizeof(buf));
+	}
+
+	//______________________________________________________________________________
+	/** snprintf in the C locale whatever the current one is */
+	void PrintDouble(char* buf, size_t size, int precision, double value)
+	{
+		snprintf(buf, size, "%.*g", precision, value);
+		char point = localeconv()->decimal_point[0];
+		if(point == '.') return;
+		for(char* c=buf; *c; c++)
+		{
+			if(*c == point) *c = '.';
+		}
+	}
+}
+
+
+//______________________________________________________________________________
+bool ccdb::BinaryBlob::IsBinary(const string& blob)
+{
+	return blob.compare(0, strlen(Prefix), Prefix) == 0;
+}
+
+
+//______________________________________________________________________________
+bool ccdb::BinaryBlob::Encode(const vector<string>& values, const vector<ConstantsTypeColumn::ColumnTypes>& types, string& blob)
+{
+	string bytes;
+	if(!EncodeBytes(values, types, bytes)) return false;
+	blob = BytesToBlob(bytes);
+	return true;
+}
+
+
+//______________________________________________________________________________
+bool ccdb::BinaryBlob::EncodeBytes(const vector<string>& values, const vector<ConstantsTypeColumn::ColumnTypes>& types, string& bytes)
+{
+	if(types.empty() || values.size() % types.size() != 0) return false;
+	size_t columnsCount = types.size();
+	size_t rows = values.size() / columnsCount;
+	if(rows > 0xFFFFFFFFul || columnsCount > 0xFFFFFFFFul) return false;
+
+	bytes.clear();
+	bytes.reserve(8 + columnsCount + values.size() * 8);
+	PutUInt(bytes, rows, 4);
+	PutUInt(bytes, columnsCount, 4);
+	for(size_t col=0; col<columnsCount; col++)
+	{
+		PutUInt(bytes, static_cast<unsigned int>(types[col]), 1);
+	}
+
+	for(size_t col=0; col<columnsCount; col++)
+	{
+		for(size_t row=0; row<rows; row++)
+		{
+			if(!EncodeCell(bytes, types[col], values[row*columnsCount + col])) return false;
+		}
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+void ccdb::BinaryBlob::EncodeBytes(const vector<Column>& columns, size_t rows, string& bytes)
+{
+	bytes.clear();
+	PutUInt(bytes, rows, 4);
+	PutUInt(bytes, columns.size(), 4);
+	for(size_t col=0; col<columns.size(); col++)
+	{
+		PutUInt(bytes, static_cast<unsigned int>(columns[col].Type), 1);
+	}
+
+	for(size_t col=0; col<columns.size(); col++)
+	{
+		const Column& column = columns[col];
+		for(size_t row=0; row<rows; row++)
+		{
+			switch(column.Type)
+			{
+			case ConstantsTypeColumn::cIntColumn:    PutUInt(bytes, static_cast<unsigned int>(column.Ints[row]), 4); break;
+			case ConstantsTypeColumn::cUIntColumn:   PutUInt(bytes, column.UInts[row], 4);                            break;
+			case ConstantsTypeColumn::cLongColumn:   PutUInt(bytes, static_cast<ull>(static_cast<long long>(column.Longs[row])), 8); break;
+			case ConstantsTypeColumn::cULongColumn:  PutUInt(bytes, column.ULongs[row], 8);                           break;
+			case ConstantsTypeColumn::cDoubleColumn: PutDouble(bytes, column.Doubles[row]);                           break;
+			case ConstantsTypeColumn::cBoolColumn:   PutUInt(bytes, column.Bools[row] ? 1 : 0, 1);                   break;
+			default:
+				PutUInt(bytes, column.Strings[row].size(), 4);
+				bytes.append(column.Strings[row]);
+				break;
+			}
+		}
+	}
+}
+
+
+//______________________________________________________________________________
+string ccdb::BinaryBlob::BytesToBlob(const string& bytes)
+{
+	return string(Prefix) + Base64Encode(bytes);
+}
+
+
+//______________________________________________________________________________
+bool ccdb::BinaryBlob::Decode(const string& blob, vector<Column>& columns, size_t& rows)
+{
+	columns.clear();
+	rows = 0;
+	if(!IsBinary(blob)) return false;
+
+	string bytes;
+	if(!Base64Decode(blob.data() + strlen(Prefix), blob.data() + blob.size(), bytes)) return false;
+	return DecodeBytes(bytes.data(), bytes.data() + bytes.size(), columns, rows);
+}
+
+
+//______________________________________________________________________________
+bool ccdb::BinaryBlob::DecodeBytes(const char* first, const char* last, vector<Column>& columns, size_t& rows)
+{
+	columns.clear();
+	rows = 0;
+
+	Reader reader(first, last);
+	ull rowsCount, columnsCount;
+	if(!reader.UInt(4, rowsCount) || !reader.UInt(4, columnsCount)) return false;
+	if(columnsCount > static_cast<ull>(last - first)) return false;
+
+	columns.resize(static_cast<size_t>(columnsCount));
+	for(size_t col=0; col<columns.size(); col++)
+	{
+		ull type;
+		if(!reader.UInt(1, type) || type > ConstantsTypeColumn::cStringColumn)
+		{
+			columns.clear();
+			return false;
+		}
+		columns[col].Type = static_cast<ConstantsTypeColumn::ColumnTypes>(type);
+	}
+
+	for(size_t col=0; col<columns.size(); col++)
+	{
+		if(!DecodeColumn(reader, columns[col], static_cast<size_t>(rowsCount)))
+		{
+			columns.clear();
+			return false;
+		}
+	}
+	if(!reader.AtEnd())
+	{
+		columns.clear();
+		return false;
+	}
+
+	rows = static_cast<size_t>(rowsCount);
+	return true;
+}
+
+
+//______________________________________________________________________________
+void ccdb::BinaryBlob::ToVector(const vector<Column>& columns, size_t rows, vector<string>& values)
+{
+	values.clear();
+	values.reserve(rows * columns.size());
+	for(size_t row=0; row<rows; row++)
+	{
+		for(size_t col=0; col<columns.size(); col++)
+		{
+			const Column& column = columns[col];
+			switch(column.Type)
+			{
+			case ConstantsTypeColumn::cIntColumn:    values.push_back(FormatInteger(column.Ints[row]));   break;
+			case ConstantsTypeColumn::cUIntColumn:   values.push_back(FormatInteger(column.UInts[row]));  break;
+			case ConstantsTypeColumn::cLongColumn:   values.push_back(FormatInteger(column.Longs[row]));  break;
+			case ConstantsTypeColumn::cULongColumn:  values.push_back(FormatInteger(column.ULongs[row])); break;
+			case ConstantsTypeColumn::cDoubleColumn: values.push_back(FormatDouble(column.Doubles[row])); break;
+			case ConstantsTypeColumn::cBoolColumn:   values.push_back(column.Bools[row] ? "true" : "false"); break;
+			default:                                 values.push_back(column.Strings[row]);               break;
+			}
+		}
+	}
+}
+
+
+//______________________________________________________________________________
+string ccdb::BinaryBlob::FormatDouble(double value)
+{
+	//the shortest of %.15g .. %.17g that reads back as the same double
+	char buf[32];
+	for(int precision=15; precision<17; precision++)
+	{
+		PrintDouble(buf, sizeof(buf), precision, value);
+		double back;
+		if(NumericParser::ParseExact(buf, buf + strlen(buf), back) && back == value) return buf;
+	}
+	PrintDouble(buf, sizeof(buf), 17, value);
+	return buf;
+}
+
+
+//______________________________________________________________________________
+string ccdb::BinaryBlob::Base64Encode(const string& bytes)
+{
+	string result;
+	result.reserve((bytes.size() + 2) / 3 * 4);
+	size_t i = 0;
+	for(; i + 2 < bytes.size(); i += 3)
+	{
+		unsigned long triple = (static_cast<unsigned char>(bytes[i]) << 16)
+		                     | (static_cast<unsigned char>(bytes[i+1]) << 8)
+		                     |  static_cast<unsigned char>(bytes[i+2]);
+		result.push_back(Base64Chars[(triple >> 18) & 0x3F]);
+		result.push_back(Base64Chars[(triple >> 12) & 0x3F]);
+		result.push_back(Base64Chars[(triple >> 6) & 0x3F]);
+		result.push_back(Base64Chars[triple & 0x3F]);
+	}
+
+	size_t rest = bytes.size() - i;
+	if(rest)
+	{
+		unsigned long triple = static_cast<unsigned char>(bytes[i]) << 16;
+		if(rest == 2) triple |= static_cast<unsigned char>(bytes[i+1]) << 8;
+		result.push_back(Base64Chars[(triple >> 18) & 0x3F]);
+		result.push_back(Base64Chars[(triple >> 12) & 0x3F]);
+		result.push_back(rest == 2 ? Base64Chars[(triple >> 6) & 0x3F] : '=');
+		result.push_back('=');
+	}
+	return result;
+}
+
+
+//______________________________________________________________________________
+bool ccdb::BinaryBlob::Base64Decode(const char* first, const char* last, string& bytes)
+{
+	if((last - first) % 4 != 0) return false;
+	bytes.clear();
+	bytes.reserve((last - first) / 4 * 3);
+
+	for(; first<last; first += 4)
+	{
+		int padding = 0;
+		if(first + 4 == last)
+		{
+			if(first[3] == '=') padding++;
+			if(first[2] == '=') padding++;
+		}
+
+		unsigned long quad = 0;
+		for(int i=0; i<4; i++)
+		{
+			int value = 0;
+			if(i < 4 - padding)
+			{
+				value = Base64Value(first[i]);
+				if(value < 0) return false;
+			}
+			quad = (quad << 6) | value;
+		}
+
+		bytes.push_back(static_cast<char>((quad >> 16) & 0xFF));
+		if(padding < 2) bytes.push_back(static_cast<char>((quad >> 8) & 0xFF));
+		if(padding < 1) bytes.push_back(static_cast<char>(quad & 0xFF));
+	}
+	return true;
+}
@@ -0,0 +1,362 @@
+#include <clocale>
+#include <cerrno>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "CCDB/Helpers/NumericParser.h"
+
+using namespace std;
+using namespace ccdb;
+
+namespace
+{
+    typedef unsigned long long ull;
+
+    //______________________________________________________________________________
+    bool IsDigit(char c)
+    {
+        return c>='0' && c<='9';
+    }
+
+    //______________________________________________________________________________
+    char ToLower(char c)
+    {
+        return (c>='A' && c<='Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    //______________________________________________________________________________
+    /** Checks that [first,last) starts with word (case insensitive).
+     * @return pointer after the word or first if it doesn't match
+     */
+    const char* MatchWord(const char* first, const char* last, const char* word)
+    {
+        const char* p = first;
+        for(; *word; word++, p++)
+        {
+            if(p==last || ToLower(*p)!=*word) return first;
+        }
+        return p;
+    }
+
+    //______________________________________________________________________________
+    /** Reads [sign]digits into negative and magnitude
+     * @return pointer after the digits or first on error or overflow
+     */
+    const char* ParseMagnitude(const char* first, const char* last, bool allowMinus, bool& negative, ull& magnitude)
+    {
+        const char* p = first;
+        negative = false;
+        if(p<last && (*p=='-' || *p=='+'))
+        {
+            if(*p=='-')
+            {
+                if(!allowMinus) return first;
+                negative = true;
+            }
+            p++;
+        }
+
+        const char* digits = p;
+        const ull maxValue = numeric_limits<ull>::max();
+        ull m = 0;
+        for(; p<last && IsDigit(*p); p++)
+        {
+            unsigned int d = static_cast<unsigned int>(*p - '0');
+            if(m > (maxValue - d)/10) return first;    //overflow
+            m = m*10 + d;
+        }
+        if(p==digits) return first;
+
+        magnitude = m;
+        return p;
+    }
+
+    //______________________________________________________________________________
+    template<class T>
+    const char* ParseSigned(const char* first, const char* last, T& value)
+    {
+        bool negative;
+        ull m;
+        const char* end = ParseMagnitude(first, last, true, negative, m);
+        if(end==first) return first;
+
+        const ull maxValue = static_cast<ull>(numeric_limits<T>::max());
+        if(!negative)
+        {
+            if(m > maxValue) return first;
+            value = static_cast<T>(m);
+        }
+        else
+        {
+            if(m > maxValue + 1) return first;
+            //-(m-1)-1 doesn't overflow for m == |min|
+            value = (m==0) ? T(0) : static_cast<T>(-static_cast<T>(m - 1) - 1);
+        }
+        return end;
+    }
+
+    //______________________________________________________________________________
+    template<class T>
+    const char* ParseUnsigned(const char* first, const char* last, T& value)
+    {
+        bool negative;
+        ull m;
+        const char* end = ParseMagnitude(first, last, false, negative, m);
+        if(end==first) return first;
+        if(m > static_cast<ull>(numeric_limits<T>::max())) return first;
+        value = static_cast<T>(m);
+        return end;
+    }
+
+    //______________________________________________________________________________
+    /** Slow path for floating point numbers that can't be converted exactly
+     * by the fast path: too many digits or a big exponent.
+     *
+     * The text is handed to strtod with '.' replaced by the decimal point
+     * of the current locale, so the result is the same in any locale.
+     */
+    bool StrtodFallback(const char* first, const char* last, double& value)
+    {
+        string buffer(first, last);
+        const char* localePoint = localeconv()->decimal_point;
+        if(localePoint && localePoint[0] && localePoint[0]!='.' && !localePoint[1])
+        {
+            for(size_t i=0; i<buffer.size(); i++) if(buffer[i]=='.') buffer[i] = localePoint[0];
+        }
+
+        errno = 0;
+        char* end = NULL;
+        double result = strtod(buffer.c_str(), &end);
+        if(end != buffer.c_str() + buffer.size()) return false;
+        if(errno==ERANGE && (result==HUGE_VAL || result==-HUGE_VAL)) return false;  //overflow
+        value = result;
+        return true;
+    }
+}
+
+//______________________________________________________________________________
+const char* ccdb::NumericParser::Parse( const char* first, const char* last, int& value )
+{
+    return ParseSigned(first, last, value);
+}
+
+
+//______________________________________________________________________________
+const char* ccdb::NumericParser::Parse( const char* first, const char* last, unsigned int& value )
+{
+    return ParseUnsigned(first, last, value);
+}
+
+
+//______________________________________________________________________________
+const char* ccdb::NumericParser::Parse( const char* first, const char* last, long& value )
+{
+    return ParseSigned(first, last, value);
+}
+
+
+//______________________________________________________________________________
+const char* ccdb::NumericParser::Parse( const char* first, const char* last, unsigned long& value )
+{
+    return ParseUnsigned(first, last, value);
+}
+
+
+//______________________________________________________________________________
+const char* ccdb::NumericParser::Parse( const char* first, const char* last, long long& value )
+{
+    return ParseSigned(first, last, value);
+}
+
+
+//______________________________________________________________________________
+const char* ccdb::NumericParser::Parse( const char* first, const char* last, unsigned long long& value )
+{
+    return ParseUnsigned(first, last, value);
+}
+
+
+//______________________________________________________________________________
+const char* ccdb::NumericParser::Parse( const char* first, const char* last, double& value )
+{
+    /** The fast path collects up to 19 significant digits into an integer
+     * mantissa. If the mantissa fits into 53 bits and the decimal exponent
+     * is within [-22, 22], both the mantissa and the power of 10 are exact
+     * doubles and a single multiplication or division gives the correctly
+     * rounded result. Everything else goes to StrtodFallback.
+     */
+    static const double powersOf10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const ull maxExactMantissa = 1ULL << 53;
+
+    const char* p = first;
+    bool negative = false;
+    if(p<last && (*p=='-' || *p=='+'))
+    {
+        negative = (*p=='-');
+        p++;
+    }
+
+    //nan and inf
+    if(p<last && !IsDigit(*p) && *p!='.')
+    {
+        const char* end = MatchWord(p, last, "nan");
+        if(end!=p)
+        {
+            value = negative ? -numeric_limits<double>::quiet_NaN() : numeric_limits<double>::quiet_NaN();
+            return end;
+        }
+        end = MatchWord(p, last, "inf");
+        if(end!=p)
+        {
+            const char* longEnd = MatchWord(end, last, "inity");
+            value = negative ? -numeric_limits<double>::infinity() : numeric_limits<double>::infinity();
+            return longEnd!=end ? longEnd : end;
+        }
+        return first;
+    }
+
+    ull mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+    bool inexact = false;   //some nonzero digits didn't fit into the mantissa
+
+    for(; p<last && IsDigit(*p); p++)
+    {
+        anyDigits = true;
+        unsigned int d = static_cast<unsigned int>(*p - '0');
+        if(significantDigits<19)
+        {
+            if(mantissa!=0 || d!=0)
+            {
+                mantissa = mantissa*10 + d;
+                significantDigits++;
+            }
+        }
+        else
+        {
+            exponent++;
+            if(d!=0) inexact = true;
+        }
+    }
+
+    if(p<last && *p=='.')
+    {
+        p++;
+        for(; p<last && IsDigit(*p); p++)
+        {
+            anyDigits = true;
+            unsigned int d = static_cast<unsigned int>(*p - '0');
+            if(significantDigits<19)
+            {
+                if(mantissa!=0 || d!=0)
+                {
+                    mantissa = mantissa*10 + d;
+                    significantDigits++;
+                }
+                exponent--;
+            }
+            else if(d!=0)
+            {
+                inexact = true;
+            }
+        }
+    }
+
+    if(!anyDigits) return first;
+
+    //exponent part. If it is malformed the number ends before 'e'
+    if(p<last && (*p=='e' || *p=='E'))
+    {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if(q<last && (*q=='-' || *q=='+'))
+        {
+            negativeExponent = (*q=='-');
+            q++;
+        }
+        if(q<last && IsDigit(*q))
+        {
+            int e = 0;
+            for(; q<last && IsDigit(*q); q++)
+            {
+                if(e < 100000) e = e*10 + (*q - '0');    //anything bigger is inf or 0 anyway
+            }
+            exponent += negativeExponent ? -e : e;
+            p = q;
+        }
+    }
+
+    if(mantissa==0)
+    {
+        value = negative ? -0.0 : 0.0;
+        return p;
+    }
+
+    if(!inexact && mantissa<=maxExactMantissa && exponent>=-22 && exponent<=22)
+    {
+        double result = static_cast<double>(mantissa);
+        if(exponent<0)
+        {
+            result /= powersOf10[-exponent];
+        }
+        else
+        {
+            result *= powersOf10[exponent];
+        }
+        value = negative ? -result : result;
+        return p;
+    }
+
+    double result;
+    if(!StrtodFallback(first, p, result)) return first;
+    value = result;
+    return p;
+}
+
+
+//______________________________________________________________________________
+const char* ccdb::NumericParser::Parse( const char* first, const char* last, float& value )
+{
+    double result;
+    const char* end = Parse(first, last, result);
+    if(end==first) return first;
+
+    //out of range for float, but nan and inf are fine
+    if(result==result && fabs(result) > numeric_limits<float>::max() && fabs(result) != numeric_limits<double>::infinity())
+    {
+        return first;
+    }
+    value = static_cast<float>(result);
+    return end;
+}
+
+
+//______________________________________________________________________________
+const char* ccdb::NumericParser::Parse( const char* first, const char* last, bool& value )
+{
+    const char* end = MatchWord(first, last, "true");
+    if(end!=first)
+    {
+        value = true;
+        return end;
+    }
+
+    end = MatchWord(first, last, "false");
+    if(end!=first)
+    {
+        value = false;
+        return end;
+    }
+
+    long long number;
+    end = ParseSigned(first, last, number);
+    if(end==first) return first;
+    value = (number!=0);
+    return end;
+}
@@ -0,0 +1,398 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif //WIN32
+
+#include "CCDB/Helpers/SnapshotFile.h"
+#include "CCDB/Helpers/BinaryBlob.h"
+#include "CCDB/Helpers/StringUtils.h"
+#include "CCDB/Model/ConstantsTypeTable.h"
+
+using namespace std;
+using namespace ccdb;
+
+const char* SnapshotFile::Magic = "CCDBSNAP";
+const unsigned int SnapshotFile::Version = 1;
+const size_t SnapshotFile::PageSize = 4096;
+
+namespace
+{
+	typedef unsigned long long ull;
+
+	const size_t MagicSize = 8;
+
+	//______________________________________________________________________________
+	void PutUInt(string& out, ull value, int bytes)
+	{
+		for(int i=0; i<bytes; i++)
+		{
+			out.push_back(static_cast<char>((value >> (8*i)) & 0xFF));
+		}
+	}
+
+	//______________________________________________________________________________
+	void PutString(string& out, const string& value)
+	{
+		PutUInt(out, value.size(), 4);
+		out.append(value);
+	}
+
+	/** Reads little endian values of the index, checking the size */
+	class Reader
+	{
+	public:
+		Reader(const char* first, const char* last): mPos(first), mEnd(last) {}
+
+		bool UInt(int bytes, ull& value)
+		{
+			if(mEnd - mPos < bytes) return false;
+			value = 0;
+			for(int i=0; i<bytes; i++)
+			{
+				value |= static_cast<ull>(static_cast<unsigned char>(mPos[i])) << (8*i);
+			}
+			mPos += bytes;
+			return true;
+		}
+
+		bool Int(int& value)
+		{
+			ull bits;
+			if(!UInt(4, bits)) return false;
+			value = static_cast<int>(static_cast<unsigned int>(bits));
+			return true;
+		}
+
+		bool String(string& value)
+		{
+			ull size;
+			if(!UInt(4, size) || static_cast<ull>(mEnd - mPos) < size) return false;
+			value.assign(mPos, static_cast<size_t>(size));
+			mPos += size;
+			return true;
+		}
+
+	private:
+		const char* mPos;
+		const char* mEnd;
+	};
+
+	//______________________________________________________________________________
+	/** Index entry without the data offset, the offset and size are appended by the writer */
+	void PutTableEntry(string& out, const string& path, Assignment* assignment, int run, size_t rows,
+	                   const vector<string>& names, const vector<ConstantsTypeColumn::ColumnTypes>& types)
+	{
+		//if the provider doesn't know the run range, the table is valid for the snapshot run only
+		int runMin = assignment->GetValidRunMin();
+		int runMax = assignment->GetValidRunMax();
+		if(runMin > runMax) runMin = runMax = run;
+
+		PutString(out, path);
+		PutUInt(out, static_cast<unsigned int>(assignment->GetId()), 4);
+		PutUInt(out, static_cast<unsigned int>(runMin), 4);
+		PutUInt(out, static_cast<unsigned int>(runMax), 4);
+		PutUInt(out, rows, 4);
+		PutUInt(out, names.size(), 4);
+		for(size_t i=0; i<names.size(); i++)
+		{
+			PutString(out, names[i]);
+			PutUInt(out, types[i], 1);
+		}
+	}
+}
+
+
+//______________________________________________________________________________
+SnapshotFile::SnapshotFile():
+	mData(NULL),
+	mSize(0),
+	mIsMapped(false),
+	mRun(0),
+	mTime(0)
+{
+}
+
+
+//______________________________________________________________________________
+SnapshotFile::~SnapshotFile()
+{
+	Close();
+}
+
+
+//______________________________________________________________________________
+bool SnapshotFile::Open(const string& fileName)
+{
+	/** @brief Maps the file and reads its index
+	 *
+	 * Where mmap is not available the file is read to memory at once
+	 *
+	 * @return false if the file can't be opened or is not a snapshot
+	 */
+
+	Close();
+	mFileName = fileName;
+	mErrorMessage.clear();
+
+#ifndef WIN32
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if(fd < 0)
+	{
+		mErrorMessage = "Can't open snapshot file '" + fileName + "'";
+		return false;
+	}
+
+	struct stat info;
+	if(fstat(fd, &info) != 0 || info.st_size <= 0)
+	{
+		close(fd);
+		mErrorMessage = "Snapshot file '" + fileName + "' is empty or can't be read";
+		return false;
+	}
+
+	void *data = mmap(NULL, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);      //the mapping stays valid without the descriptor
+	if(data == MAP_FAILED)
+	{
+		mErrorMessage = "Can't map snapshot file '" + fileName + "' to memory";
+		return false;
+	}
+	mData = static_cast<const char*>(data);
+	mSize = static_cast<size_t>(info.st_size);
+	mIsMapped = true;
+#else
+	FILE *file = fopen(fileName.c_str(), "rb");
+	if(file == NULL)
+	{
+		mErrorMessage = "Can't open snapshot file '" + fileName + "'";
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	char *data = size > 0 ? new char[size] : NULL;
+	if(data == NULL || fread(data, 1, size, file) != static_cast<size_t>(size))
+	{
+		delete[] data;
+		fclose(file);
+		mErrorMessage = "Snapshot file '" + fileName + "' is empty or can't be read";
+		return false;
+	}
+	fclose(file);
+	mData = data;
+	mSize = static_cast<size_t>(size);
+	mIsMapped = false;
+#endif //WIN32
+
+	if(!ReadIndex())
+	{
+		Unmap();
+		mTables.clear();
+		mErrorMessage = "File '" + fileName + "' is not a valid CCDB snapshot";
+		return false;
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+void SnapshotFile::Close()
+{
+	Unmap();
+	mTables.clear();
+	mVariation.clear();
+	mRun = 0;
+	mTime = 0;
+}
+
+
+//______________________________________________________________________________
+void SnapshotFile::Unmap()
+{
+	if(mData == NULL) return;
+
+#ifndef WIN32
+	if(mIsMapped) munmap(const_cast<char*>(mData), mSize);
+	else delete[] mData;
+#else
+	delete[] mData;
+#endif //WIN32
+
+	mData = NULL;
+	mSize = 0;
+	mIsMapped = false;
+}
+
+
+//______________________________________________________________________________
+bool SnapshotFile::ReadIndex()
+{
+	if(mSize < MagicSize || memcmp(mData, Magic, MagicSize) != 0) return false;
+
+	Reader reader(mData + MagicSize, mData + mSize);
+	ull version, time, tablesCount;
+	if(!reader.UInt(4, version) || version != Version) return false;
+	if(!reader.Int(mRun) || !reader.UInt(8, time) || !reader.UInt(4, tablesCount)) return false;
+	if(!reader.String(mVariation)) return false;
+	mTime = static_cast<time_t>(static_cast<long long>(time));
+
+	for(ull i=0; i<tablesCount; i++)
+	{
+		Table table;
+		ull columnsCount;
+		if(!reader.String(table.Path)) return false;
+		if(!reader.Int(table.AssignmentId) || !reader.Int(table.ValidRunMin) || !reader.Int(table.ValidRunMax)) return false;
+		if(!reader.Int(table.RowsCount)) return false;
+		if(!reader.UInt(4, columnsCount) || columnsCount > mSize) return false;
+
+		for(ull col=0; col<columnsCount; col++)
+		{
+			string name;
+			ull type;
+			if(!reader.String(name) || !reader.UInt(1, type) || type > ConstantsTypeColumn::cStringColumn) return false;
+			table.ColumnNames.push_back(name);
+			table.ColumnTypes.push_back(static_cast<ConstantsTypeColumn::ColumnTypes>(type));
+		}
+
+		ull offset, size;
+		if(!reader.UInt(8, offset) || !reader.UInt(8, size)) return false;
+		if(offset > mSize || size > mSize - offset) return false;
+		table.Data = mData + offset;
+		table.DataSize = static_cast<size_t>(size);
+
+		mTables[table.Path] = table;
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+const SnapshotFile::Table* SnapshotFile::FindTable(const string& path) const
+{
+	map<string, Table>::const_iterator iter = mTables.find(path);
+	if(iter == mTables.end()) return NULL;
+	return &iter->second;
+}
+
+
+//______________________________________________________________________________
+bool SnapshotFile::Write(const string& fileName, int run, const string& variation, time_t time,
+                         const map<string, Assignment *>& assignments, string& error)
+{
+	/** @brief Writes a snapshot of assignments
+	 *
+	 * @return false if the file can't be written or an assignment has no columns
+	 */
+
+	string index;
+	vector<string> datas;
+	vector<size_t> rowsCounts;
+	map<string, Assignment *>::const_iterator iter = assignments.begin();
+	for(; iter != assignments.end(); ++iter)
+	{
+		const string& path = iter->first;
+		Assignment* assignment = iter->second;
+		ConstantsTypeTable* typeTable = assignment->GetTypeTable();
+		if(typeTable == NULL || typeTable->GetColumnsCount() == 0)
+		{
+			error = "Assignment of table '" + path + "' has no columns loaded";
+			return false;
+		}
+
+		vector<string> names = typeTable->GetColumnNames();
+		vector<ConstantsTypeColumn::ColumnTypes> types;
+		for(size_t col=0; col<names.size(); col++) types.push_back(typeTable->GetColumns()[col]->GetType());
+
+		vector<string> values;
+		assignment->GetVectorData(values);
+		if(values.size() % names.size() != 0)
+		{
+			error = StringUtils::Format("Table '%s' has %i cells, it is not a multiple of its %i columns",
+			                            path.c_str(), (int)values.size(), (int)names.size());
+			return false;
+		}
+
+		//columns with cells that don't read as their type are kept as strings
+		size_t rows = values.size() / names.size();
+		rowsCounts.push_back(rows);
+		datas.push_back(string());
+		if(!BinaryBlob::EncodeBytes(values, types, datas.back()))
+		{
+			vector<ConstantsTypeColumn::ColumnTypes> storedTypes(types);
+			for(size_t col=0; col<names.size(); col++)
+			{
+				vector<string> cells(rows);
+				for(size_t row=0; row<rows; row++) cells[row] = values[row*names.size() + col];
+
+				string scratch;
+				vector<ConstantsTypeColumn::ColumnTypes> cellType(1, types[col]);
+				if(!BinaryBlob::EncodeBytes(cells, cellType, scratch)) storedTypes[col] = ConstantsTypeColumn::cStringColumn;
+			}
+			BinaryBlob::EncodeBytes(values, storedTypes, datas.back());
+		}
+
+		PutTableEntry(index, path, assignment, run, rows, names, types);
+		index.append(16, '\0');     //offset and size, known when the header size is known
+	}
+
+	string header(Magic, MagicSize);
+	PutUInt(header, Version, 4);
+	PutUInt(header, static_cast<unsigned int>(run), 4);
+	PutUInt(header, static_cast<ull>(static_cast<long long>(time)), 8);
+	PutUInt(header, assignments.size(), 4);
+	PutString(header, variation);
+
+	//now the offsets of the data are known, the entries are written again with them
+	ull offset = header.size() + index.size();
+	index.clear();
+	size_t tableIndex = 0;
+	for(iter = assignments.begin(); iter != assignments.end(); ++iter, ++tableIndex)
+	{
+		ConstantsTypeTable* typeTable = iter->second->GetTypeTable();
+		vector<string> names = typeTable->GetColumnNames();
+		vector<ConstantsTypeColumn::ColumnTypes> types;
+		for(size_t col=0; col<names.size(); col++) types.push_back(typeTable->GetColumns()[col]->GetType());
+
+		offset = (offset + PageSize - 1) / PageSize * PageSize;
+		PutTableEntry(index, iter->first, iter->second, run, rowsCounts[tableIndex], names, types);
+		PutUInt(index, offset, 8);
+		PutUInt(index, datas[tableIndex].size(), 8);
+		offset += datas[tableIndex].size();
+	}
+
+	string tempName = fileName + ".tmp";
+	FILE *file = fopen(tempName.c_str(), "wb");
+	if(file == NULL)
+	{
+		error = "Can't open file '" + tempName + "' for writing";
+		return false;
+	}
+
+	bool ok = fwrite(header.data(), 1, header.size(), file) == header.size();
+	ok = ok && fwrite(index.data(), 1, index.size(), file) == index.size();
+	size_t position = header.size() + index.size();
+	for(size_t i=0; i<datas.size() && ok; i++)
+	{
+		size_t padding = (PageSize - position % PageSize) % PageSize;
+		string zeros(padding, '\0');
+		ok = fwrite(zeros.data(), 1, padding, file) == padding;
+		ok = ok && fwrite(datas[i].data(), 1, datas[i].size(), file) == datas[i].size();
+		position += padding + datas[i].size();
+	}
+	ok = (fclose(file) == 0) && ok;
+
+	if(!ok || rename(tempName.c_str(), fileName.c_str()) != 0)
+	{
+		remove(tempName.c_str());
+		error = "Can't write snapshot file '" + fileName + "'";
+		return false;
+	}
+	return true;
+}
@@ -340,44 +340,58 @@ vector<string> & ccdb::StringUtils::Split( const string& str, vector<string>& to
 //______________________________________________________________________________
 int ccdb::StringUtils::ParseInt( const string& source, bool *result/*=NULL*/  )
 {
-    return atoi(source.c_str()); //ugly isn't it?
+    return ParseNumber<int>(source, result);
 }
 
 
 //______________________________________________________________________________
 unsigned int ccdb::StringUtils::ParseUInt( const string& source, bool *result/*=NULL*/  )
 {
-    return static_cast<unsigned int>(atoi(source.c_str())); //ugly isn't it?
+    unsigned int value = 0;
+    if(NumericParser::ParseExact(source, value))
+    {
+        if(result) *result = true;
+        return value;
+    }
+
+    //negative numbers are wrapped around as they always were
+    if(result) *result = false;
+    return static_cast<unsigned int>(NumericParser::ParseLenient<int>(source));
 }
 
 
 //______________________________________________________________________________
 long ccdb::StringUtils::ParseLong( const string& source, bool *result/*=NULL*/  )
 {
-    return atol(source.c_str()); //ugly isn't it?
+    return ParseNumber<long>(source, result);
 }
 
 
 //______________________________________________________________________________
 unsigned long ccdb::StringUtils::ParseULong( const string& source, bool *result/*=NULL*/  )
 {
-    return static_cast<unsigned long>(atol(source.c_str())); //ugly isn't it?
+    unsigned long value = 0;
+    if(NumericParser::ParseExact(source, value))
+    {
+        if(result) *result = true;
+        return value;
+    }
+
+    if(result) *result = false;
+    return static_cast<unsigned long>(NumericParser::ParseLenient<long>(source));
 }
 
 
 //______________________________________________________________________________
 bool ccdb::StringUtils::ParseBool( const string& source, bool *result/*=NULL*/  )
 {
-    if(source=="true") return true;
-    if(source=="false") return false;
-
-    return static_cast<bool>(atoi(source.c_str())!=0); //ugly isn't it?
+    return ParseNumber<bool>(source, result);
 }
 
 //___________________________________________________________________________________
 double ccdb::StringUtils::ParseDouble( const string& source, bool *result/*=NULL*/  )
 {
-    return atof(source.c_str()); //ugly isn't it?
+    return ParseNumber<double>(source, result);
 }
 
 //_______________________________________________________________________________________
@@ -6,6 +6,7 @@
  */
 #include <vector>
 #include <sstream>
+#include <cstring>
 #include <assert.h>
 
 #include "CCDB/Model/Assignment.h"
@@ -28,6 +29,12 @@ ccdb::Assignment::Assignment( ObjectsOwner * owner/*=NULL*/, DataProvider *provi
 	mDataVaultId  = 0;		// database ID of data blob
 	mEventRangeId = 0;		// event range ID
 	mRequestedRun = 0;		// Run than was requested for user
+	mValidRunMin  = 0;		// runs with the same assignment are unknown
+	mValidRunMax  = -1;
+	mIsCellsReady = true;
+	mIsRawDataReady = true;
+	mIsBinaryData = false;
+	mBinaryRowsCount = 0;
 
 	mRunRange   = NULL;		// Run range object, is NULL if not set
 	mEventRange = NULL;		// Event range object, is NULL if not set
@@ -218,6 +225,15 @@ string ccdb::Assignment::VectorToBlob(const vector<string>& values)
 }
 
 
+//______________________________________________________________________________
+string ccdb::Assignment::VectorToBinaryBlob(const vector<string>& values, const vector<ConstantsTypeColumn::ColumnTypes>& types)
+{
+	string result;
+	if(BinaryBlob::Encode(values, types, result)) return result;
+	return VectorToBlob(values);
+}
+
+
 //______________________________________________________________________________
 vector<map<string,string> > ccdb::Assignment::GetMappedData() const
 {
@@ -231,10 +247,21 @@ vector<map<string,string> > ccdb::Assignment::GetMappedData() const
 void ccdb::Assignment::GetMappedData(vector<map<string, string> >& mappedData) const
 {
     assert(mTypeTable !=NULL); // it is DataProvider work
-    	
-	//fill data
-	MapData(mappedData, GetVectorData(), mTypeTable->GetColumnNames() );
-	
+
+	//fill data, as MapData does, but straight from the cells
+	if (Cells().size() == 0)
+	{
+		mappedData.clear();
+		return;
+	}
+	GetMappedData(mappedData, CellToString);
+}
+
+
+//______________________________________________________________________________
+string ccdb::Assignment::CellToString(const StringView& cell)
+{
+	return cell.ToString();
 }
 
 
@@ -264,8 +291,22 @@ void ccdb::Assignment::GetData(std::vector<std::vector<std::string> >& data) con
 	//clear before filling
 	data.clear();
 
-	//fill data
-	MapData(data, GetVectorData(), mTypeTable->GetColumnsCount());
+	//fill data straight from the cells
+	const vector<StringView>& cells = Cells();
+	size_t columnsCount = mTypeTable->GetColumnsCount();
+	if (cells.size() == 0) return;
+	assert(columnsCount!=0);
+
+	size_t rows = cells.size() / columnsCount;
+	data.resize(rows);
+	for (size_t rowIter = 0; rowIter < rows; rowIter++)
+	{
+		data[rowIter].reserve(columnsCount);
+		for (size_t colIter = 0; colIter < columnsCount; colIter++)
+		{
+			data[rowIter].push_back(cells[rowIter*columnsCount + colIter].ToString());
+		}
+	}
 }
 
 
@@ -297,58 +338,168 @@ vector<string> ccdb::Assignment::GetVectorData() const
 //______________________________________________________________________________
 void ccdb::Assignment::GetVectorData(vector<string>& vectorData) const
 {
-	//split data
+	const vector<StringView>& cells = Cells();
 	vectorData.clear();
-	vector<string>::const_iterator iter = mVectorData.begin();
-	while (iter<mVectorData.end())
-	{	
-		vectorData.push_back(DecodeBlobSeparator(*iter));
-		iter++;
+	vectorData.reserve(cells.size());
+	for (size_t i = 0; i < cells.size(); i++)
+	{
+		vectorData.push_back(cells[i].ToString());
+	}
+}
+
+//______________________________________________________________________________
+StringView ccdb::Assignment::GetCellView(size_t rowIndex, size_t columnIndex) const
+{
+	assert(mTypeTable !=NULL); // it is DataProvider work
+	return Cells()[rowIndex*mTypeTable->GetColumnsCount() + columnIndex];
+}
+
+//______________________________________________________________________________
+const vector<StringView>& ccdb::Assignment::Cells() const
+{
+	if(!mIsCellsReady)
+	{
+		vector<string> values;
+		BinaryBlob::ToVector(mBinaryColumns, mBinaryRowsCount, values);
+		mCells.reserve(values.size());
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			mDecodedCells.push_back(string());
+			mDecodedCells.back().swap(values[i]);
+			mCells.push_back(StringView(mDecodedCells.back()));
+		}
+		mIsCellsReady = true;
+	}
+	return mCells;
+}
+
+//______________________________________________________________________________
+void ccdb::Assignment::Tokenize()
+{
+	/** The cells are views into mRawData. Only a cell with an escaped
+	 * separator gets a decoded copy. Empty cells are skipped, as
+	 * StringUtils::Split did.
+	 */
+	const char delimiter = CCDB_DATA_BLOB_DELIMETER[0];
+	const char* data = mRawData.data();
+	const char* end = data + mRawData.size();
+
+	for (const char* cellBegin = data; cellBegin < end; )
+	{
+		const char* cellEnd = static_cast<const char*>(memchr(cellBegin, delimiter, end - cellBegin));
+		if (!cellEnd) cellEnd = end;
+
+		if (cellEnd > cellBegin)
+		{
+			StringView cell(cellBegin, cellEnd - cellBegin);
+			if (memchr(cellBegin, '&', cellEnd - cellBegin))
+			{
+				mDecodedCells.push_back(DecodeBlobSeparator(cell.ToString()));
+				cell = StringView(mDecodedCells.back());
+			}
+			mCells.push_back(cell);
+		}
+		cellBegin = cellEnd + 1;
 	}
 }
 
 //______________________________________________________________________________
 void ccdb::Assignment::SetRawData(std::string val)
 {
-	mVectorData.clear();
-	mRows.clear();
-	mRawData = val;
+	mCells.clear();
+	mDecodedCells.clear();
+	mBinaryColumns.clear();
+	mBinaryRowsCount = 0;
+	mRawData.swap(val);
+	mIsRawDataReady = true;
 
-	mVectorData = StringUtils::Split(mRawData, CCDB_DATA_BLOB_DELIMETER);
-	for (size_t i = 0; i < mVectorData.size(); i++)
+	//binary blob is decoded to typed columns, text cells are made only if asked
+	mIsBinaryData = BinaryBlob::IsBinary(mRawData);
+	if(mIsBinaryData)
 	{
-		mVectorData[i] = DecodeBlobSeparator(mVectorData[i]); //Decode blob separators
+		//a damaged blob gives no data
+		BinaryBlob::Decode(mRawData, mBinaryColumns, mBinaryRowsCount);
+		mIsCellsReady = false;
+		return;
 	}
+
+	mIsCellsReady = true;
+	Tokenize();
 }
 
-std::string ccdb::Assignment::GetValue(string columnName)
+//______________________________________________________________________________
+int ccdb::Assignment::GetColumnIndex(const string& columnName) const
 {
-	if (mRows.size() == 0)
+	assert(mTypeTable !=NULL); // it is DataProvider work
+
+	if (mColumnIndexes.empty())
 	{
-		//fill data
-		MapData(mRows, GetVectorData(), mTypeTable->GetColumnNames());
+		vector<string> columnNames = mTypeTable->GetColumnNames();
+		for (size_t i = 0; i < columnNames.size(); i++)
+		{
+			mColumnIndexes[columnNames[i]] = static_cast<int>(i);
+		}
 	}
-	return mRows[0][columnName];
+
+	map<string, int>::const_iterator iter = mColumnIndexes.find(columnName);
+	return iter == mColumnIndexes.end() ? -1 : iter->second;
 }
 
-std::string ccdb::Assignment::GetValue(size_t rowIndex, string columnName)
+//______________________________________________________________________________
+bool ccdb::Assignment::SetBinaryData(const char* first, const char* last)
+{
+	mCells.clear();
+	mDecodedCells.clear();
+	mRawData.clear();
+	mIsRawDataReady = false;
+	mIsBinaryData = true;
+	mIsCellsReady = false;
+	return BinaryBlob::DecodeBytes(first, last, mBinaryColumns, mBinaryRowsCount);
+}
+
+//______________________________________________________________________________
+const string& ccdb::Assignment::GetRawData() const
 {
-	if (mRows.size() == 0)
+	if(!mIsRawDataReady)
 	{
-		//fill data
-		MapData(mRows, GetVectorData(), mTypeTable->GetColumnNames());
+		string bytes;
+		BinaryBlob::EncodeBytes(mBinaryColumns, mBinaryRowsCount, bytes);
+		mRawData = BinaryBlob::BytesToBlob(bytes);
+		mIsRawDataReady = true;
 	}
-	return GetMappedData()[0][columnName];
+	return mRawData;
+}
+
+//______________________________________________________________________________
+std::string ccdb::Assignment::GetValue(string columnName)
+{
+	return GetValue(0, columnName);
 }
 
+//______________________________________________________________________________
+std::string ccdb::Assignment::GetValue(size_t rowIndex, string columnName)
+{
+	int columnIndex = GetColumnIndex(columnName);
+	if (columnIndex < 0) return string();
+	return GetValue(rowIndex, static_cast<size_t>(columnIndex));
+}
+
+//______________________________________________________________________________
 std::string ccdb::Assignment::GetValue(size_t rowIndex, size_t columnIndex)
 {
-	return GetData()[rowIndex][columnIndex];
+	assert(mTypeTable !=NULL); // it is DataProvider work
+
+	size_t columnsCount = mTypeTable->GetColumnsCount();
+	size_t index = rowIndex*columnsCount + columnIndex;
+	if (columnIndex >= columnsCount || index >= Cells().size()) return string();
+	return Cells()[index].ToString();
 }
 
+//______________________________________________________________________________
 std::string ccdb::Assignment::GetValue(size_t columnIndex)
 {
-	return GetVectorData()[columnIndex];
+	if (columnIndex >= Cells().size()) return string();
+	return Cells()[columnIndex].ToString();
 }
 
 ConstantsTypeColumn::ColumnTypes ccdb::Assignment::GetValueType(const string& columnName)
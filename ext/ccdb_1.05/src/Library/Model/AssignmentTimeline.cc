@@ -0,0 +1,150 @@
+/*
+ * AssignmentTimeline.cc
+ */
+
+#include <algorithm>
+#include <set>
+
+#include "CCDB/Model/AssignmentTimeline.h"
+
+namespace ccdb {
+
+namespace
+{
+	/** orders indexes of candidates by their priority */
+	template<class T>
+	struct IndexLess
+	{
+		const vector<T> *items;
+		bool operator()(size_t a, size_t b) const { return (*items)[a] < (*items)[b]; }
+	};
+
+	/** orders candidates by the first and by the past-the-last run */
+	template<class T>
+	struct StartLess
+	{
+		const vector<T> *items;
+		bool operator()(size_t a, size_t b) const { return (*items)[a].RunMin < (*items)[b].RunMin; }
+	};
+
+	template<class T>
+	struct EndLess
+	{
+		const vector<T> *items;
+		bool operator()(size_t a, size_t b) const { return (*items)[a].RunMax < (*items)[b].RunMax; }
+	};
+
+	/** compares the first run of an interval with a run */
+	struct IntervalStartsAfter
+	{
+		bool operator()(int run, const AssignmentTimeline::Interval& interval) const { return run < interval.RunMin; }
+	};
+}
+
+
+//______________________________________________________________________________
+AssignmentTimeline::AssignmentTimeline()
+{
+}
+
+
+//______________________________________________________________________________
+bool AssignmentTimeline::Candidate::operator<(const Candidate& other) const
+{
+	//the nearest variation wins, then the newest assignment
+	if(VariationOrder != other.VariationOrder) return VariationOrder < other.VariationOrder;
+	return AssignmentId > other.AssignmentId;
+}
+
+
+//______________________________________________________________________________
+void AssignmentTimeline::AddAssignment(dbkey_t assignmentId, dbkey_t constantSetId, int runMin, int runMax, int variationOrder)
+{
+	if(runMin > runMax) return;
+
+	Candidate candidate;
+	candidate.AssignmentId = assignmentId;
+	candidate.ConstantSetId = constantSetId;
+	candidate.RunMin = runMin;
+	candidate.RunMax = runMax;
+	candidate.VariationOrder = variationOrder;
+	mAssignments.push_back(candidate);
+}
+
+
+//______________________________________________________________________________
+void AssignmentTimeline::Build()
+{
+	/** Sweeps over the run boundaries of all assignments. Between two
+	 *  neighbouring boundaries the set of covering assignments is the same,
+	 *  and the first one of the set by priority is effective there.
+	 */
+	mIntervals.clear();
+	size_t count = mAssignments.size();
+	if(count == 0) return;
+
+	vector<size_t> byStart(count), byEnd(count);
+	vector<long long> boundaries;
+	boundaries.reserve(2*count);
+	for(size_t i=0; i<count; i++)
+	{
+		byStart[i] = byEnd[i] = i;
+		boundaries.push_back(mAssignments[i].RunMin);
+		boundaries.push_back((long long)mAssignments[i].RunMax + 1); //RunMax may be INT_MAX
+	}
+	StartLess<Candidate> startLess = { &mAssignments };
+	EndLess<Candidate> endLess = { &mAssignments };
+	std::sort(byStart.begin(), byStart.end(), startLess);
+	std::sort(byEnd.begin(), byEnd.end(), endLess);
+	std::sort(boundaries.begin(), boundaries.end());
+	boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+	IndexLess<Candidate> priorityLess = { &mAssignments };
+	std::set<size_t, IndexLess<Candidate> > active(priorityLess);
+	size_t nextStart = 0, nextEnd = 0;
+
+	for(size_t b=0; b+1<boundaries.size(); b++)
+	{
+		long long first = boundaries[b];
+		while(nextEnd < count && (long long)mAssignments[byEnd[nextEnd]].RunMax + 1 == first)
+		{
+			active.erase(byEnd[nextEnd++]);
+		}
+		while(nextStart < count && mAssignments[byStart[nextStart]].RunMin == first)
+		{
+			active.insert(byStart[nextStart++]);
+		}
+		if(active.empty()) continue;
+
+		const Candidate& winner = mAssignments[*active.begin()];
+		int runMin = (int)first;
+		int runMax = (int)(boundaries[b+1] - 1);
+
+		//neighbouring intervals of the same assignment are merged
+		if(!mIntervals.empty() && mIntervals.back().AssignmentId == winner.AssignmentId && mIntervals.back().RunMax + 1 == runMin)
+		{
+			mIntervals.back().RunMax = runMax;
+			continue;
+		}
+
+		Interval interval;
+		interval.RunMin = runMin;
+		interval.RunMax = runMax;
+		interval.AssignmentId = winner.AssignmentId;
+		interval.ConstantSetId = winner.ConstantSetId;
+		mIntervals.push_back(interval);
+	}
+}
+
+
+//______________________________________________________________________________
+const AssignmentTimeline::Interval* AssignmentTimeline::Find(int run) const
+{
+	vector<Interval>::const_iterator iter = std::upper_bound(mIntervals.begin(), mIntervals.end(), run, IntervalStartsAfter());
+	if(iter == mIntervals.begin()) return NULL;
+	--iter;
+	if(run > iter->RunMax) return NULL;
+	return &(*iter);
+}
+
+}
@@ -9,7 +9,7 @@ unsigned long ccdb::StoredObject::mLastTempId=0;
 ccdb::StoredObject::StoredObject( ObjectsOwner * owner/*=NULL*/, DataProvider *provider/*=NULL*/ )
 {
 	mOwner = NULL;
-	mTempId = ++mLastTempId;
+	mTempId = __sync_add_and_fetch(&mLastTempId, 1);	//objects are made by many threads
 	mProvider = provider;
 	SetOwner(owner, owner!=NULL);
 }
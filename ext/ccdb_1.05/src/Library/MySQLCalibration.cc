@@ -48,6 +48,8 @@ bool MySQLCalibration::Connect( std::string connectionString )
 	 * @param connectionString the Connection String
 	 * @return true if connected
 	 */
+    int poolSize = ExtractPoolSize(connectionString);
+
     Lock();
 
     UpdateActivityTime();
@@ -93,6 +95,7 @@ bool MySQLCalibration::Connect( std::string connectionString )
     }
 
     bool result = mProvider->Connect(connectionString);
+    if(result) result = ConnectProviderPool(connectionString, poolSize);
     Unlock();
     return result;
     //TODO decide maybe to throw an exception here?
@@ -117,6 +120,14 @@ void MySQLCalibration::Disconnect()
     }
 
     mProvider->Disconnect();
+    if(mProviderPool) mProviderPool->Disconnect();
+}
+
+
+//______________________________________________________________________________
+DataProvider * MySQLCalibration::CreatePoolProvider()
+{
+    return new MySQLDataProvider();
 }
 
 
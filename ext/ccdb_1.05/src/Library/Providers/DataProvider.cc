@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <time.h>
 
 
 #include "CCDB/Providers/DataProvider.h"
@@ -24,13 +25,43 @@ DataProvider::DataProvider(void):
     mLogUserName = mAuthentication->GetLogin();
 	ClearErrorsOnFunctionStart();
     mConnectionString="";
+    mVariationsAreLoaded = false;
+    mTimeZone = cLocalTime;
 }
 
 
 //______________________________________________________________________________
 DataProvider::~DataProvider(void)
 {
-	//Guess what is it?
+	InvalidateAssignmentTimelines();
+}
+
+
+//______________________________________________________________________________
+void DataProvider::SetTimeZone(TimeZones timeZone)
+{
+	if(timeZone == mTimeZone) return;
+	mTimeZone = timeZone;
+
+	//timelines with a time were selected comparing to the other time zone
+	InvalidateAssignmentTimelines();
+}
+
+
+//______________________________________________________________________________
+string DataProvider::FormatDatabaseTime(time_t time) const
+{
+	struct tm parts;
+#ifndef WIN32
+	if(mTimeZone == cUTCTime) gmtime_r(&time, &parts);
+	else localtime_r(&time, &parts);
+#else
+	parts = (mTimeZone == cUTCTime)? *gmtime(&time) : *localtime(&time);
+#endif //WIN32
+
+	char buffer[32];
+	strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &parts);
+	return string(buffer);
 }
 
 
@@ -273,8 +304,104 @@ ConstantsTypeTable * DataProvider::GetConstantsTypeTable(const string& path, boo
 	return GetConstantsTypeTable(name, dir, loadColumns);
 }
 
+
+//______________________________________________________________________________
+ConstantsTypeTable * DataProvider::GetCachedConstantsTypeTable(const string& path)
+{
+	map<string, ConstantsTypeTable *>::iterator iter = mTypeTablesByPath.find(path);
+	if(iter != mTypeTablesByPath.end()) return iter->second;
+
+	ConstantsTypeTable *table = GetConstantsTypeTable(path, true);
+	if(!table) return NULL;     //not found tables are not cached
+
+	//the provider keeps the table alive for everybody who has a pointer to it
+	if(!IsOwner(table)) BeOwner(table);
+	mTypeTablesByPath[path] = table;
+	return table;
+}
+
+
+//______________________________________________________________________________
+void DataProvider::InvalidateTypeTablesCache(const string& path/*=""*/)
+{
+	//Tables are only removed from the cache. They are still owned by the provider
+	//and are deleted with it, as assignments may point to them
+	if(path.empty())
+	{
+		mTypeTablesByPath.clear();
+	}
+	else
+	{
+		mTypeTablesByPath.erase(path);
+	}
+}
+
+
+//______________________________________________________________________________
+bool DataProvider::LoadConstantsTypeTables(const vector<string>& paths)
+{
+	for(size_t i=0; i<paths.size(); i++)
+	{
+		GetCachedConstantsTypeTable(paths[i]);
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+void DataProvider::SelectUncachedTypeTables(const vector<string>& paths, set<string>& uncachedPaths, vector<dbkey_t>& directoryIds)
+{
+	set<dbkey_t> uniqueIds;
+	for(size_t i=0; i<paths.size(); i++)
+	{
+		if(mTypeTablesByPath.find(paths[i]) != mTypeTablesByPath.end()) continue;
+
+		Directory *dir = GetDirectory(PathUtils::ExtractDirectory(paths[i]));
+		if(dir == NULL) continue;
+
+		uncachedPaths.insert(paths[i]);
+		if(uniqueIds.insert(dir->GetId()).second) directoryIds.push_back(dir->GetId());
+	}
+}
+
 #pragma endregion Type tables
 
+//----------------------------------------------------------------------------------------
+//	A S S I G N M E N T   T I M E L I N E S
+//----------------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+const AssignmentTimeline* DataProvider::GetAssignmentTimeline(ConstantsTypeTable* table, Variation* variation, time_t time/*=0*/)
+{
+	if(table == NULL || variation == NULL) return NULL;
+
+	TimelineKey key(make_pair(table->GetId(), variation->GetId()), time);
+	map<TimelineKey, AssignmentTimeline *>::iterator iter = mAssignmentTimelines.find(key);
+	if(iter != mAssignmentTimelines.end()) return iter->second;
+
+	AssignmentTimeline *timeline = new AssignmentTimeline();
+	if(!LoadAssignmentTimeline(*timeline, table, variation, time))
+	{
+		delete timeline;
+		return NULL;
+	}
+	timeline->Build();
+	mAssignmentTimelines[key] = timeline;
+	return timeline;
+}
+
+
+//______________________________________________________________________________
+void DataProvider::InvalidateAssignmentTimelines()
+{
+	map<TimelineKey, AssignmentTimeline *>::iterator iter = mAssignmentTimelines.begin();
+	for(; iter != mAssignmentTimelines.end(); ++iter)
+	{
+		delete iter->second;
+	}
+	mAssignmentTimelines.clear();
+}
+
 //----------------------------------------------------------------------------------------
 //	R U N   R A N G E S
 //----------------------------------------------------------------------------------------
@@ -302,6 +429,130 @@ bool DataProvider::GetVariations(vector<Variation*>& resultVariations, const str
 }
 
 
+//______________________________________________________________________________
+Variation* DataProvider::GetVariation(const string& name)
+{
+    if(!mVariationsAreLoaded && !LoadVariations()) return NULL;
+
+    map<string, Variation *>::iterator iter = mVariationsByName.find(name);
+    if(iter == mVariationsByName.end()) return NULL;
+    return iter->second;
+}
+
+
+//______________________________________________________________________________
+Variation* DataProvider::GetVariationById(dbkey_t id)
+{
+    if(!mVariationsAreLoaded && !LoadVariations()) return NULL;
+
+    map<dbkey_t, Variation *>::iterator iter = mVariationsById.find(id);
+    if(iter == mVariationsById.end()) return NULL;
+    return iter->second;
+}
+
+
+//______________________________________________________________________________
+const vector<dbkey_t>& DataProvider::GetVariationChain(Variation* variation)
+{
+    static const vector<dbkey_t> emptyChain;
+    if(variation == NULL) return emptyChain;
+
+    map<dbkey_t, vector<dbkey_t> >::iterator iter = mVariationChains.find(variation->GetId());
+    if(iter == mVariationChains.end()) return emptyChain;
+    return iter->second;
+}
+
+
+//______________________________________________________________________________
+void DataProvider::BuildVariationDependencies()
+{
+    /** @brief Sets parents and ancestor chains of variations.
+    *   This method is supposed to be called after all variations are loaded to mVariationsById
+    */
+
+    mVariationsByName.clear();
+    mVariationChains.clear();
+
+    map<dbkey_t, Variation *>::iterator varIter = mVariationsById.begin();
+    for(; varIter != mVariationsById.end(); ++varIter)
+    {
+        Variation *variation = varIter->second;
+        mVariationsByName[variation->GetName()] = variation;
+
+        variation->SetParent(NULL);
+        if(variation->GetParentDbId() != 0)
+        {
+            map<dbkey_t, Variation *>::iterator parentIter = mVariationsById.find(variation->GetParentDbId());
+            if(parentIter != mVariationsById.end())
+            {
+                variation->SetParent(parentIter->second);
+            }
+            else
+            {
+                Error(CCDB_ERROR_VARIATION_INVALID, "DataProvider::BuildVariationDependencies", "Parent variation with wrong id");
+            }
+        }
+    }
+
+    //the chain ends at the top parent. The size check protects from loops in parentId
+    for(varIter = mVariationsById.begin(); varIter != mVariationsById.end(); ++varIter)
+    {
+        vector<dbkey_t> &chain = mVariationChains[varIter->first];
+        for(Variation *variation = varIter->second; variation != NULL && chain.size() < mVariationsById.size(); variation = variation->GetParent())
+        {
+            chain.push_back(variation->GetId());
+        }
+    }
+
+    mVariationsAreLoaded = true;
+}
+
+
+//______________________________________________________________________________
+void DataProvider::PrepareVariationChainInsertion(Variation* variation, const string& column, string& whereInsertion, string& orderInsertion)
+{
+    const vector<dbkey_t>& chain = GetVariationChain(variation);
+
+    string cases;
+    for(size_t i=0; i<chain.size(); i++)
+    {
+        cases += " WHEN " + StringUtils::IntToString(chain[i]) + " THEN " + StringUtils::IntToString(static_cast<int>(i));
+    }
+
+    whereInsertion = column + " IN (" + PrepareIdListInsertion(chain) + ")";
+    orderInsertion = "CASE " + column + cases + " END";
+}
+
+
+//______________________________________________________________________________
+string DataProvider::PrepareIdListInsertion(const vector<dbkey_t>& ids)
+{
+    string result;
+    for(size_t i=0; i<ids.size(); i++)
+    {
+        if(i>0) result += ", ";
+        result += StringUtils::IntToString(ids[i]);
+    }
+    return result;
+}
+
+
+//______________________________________________________________________________
+string DataProvider::PrepareRunOverlapInsertion(const map<dbkey_t, pair<int, int> >& runRanges)
+{
+    string result;
+    map<dbkey_t, pair<int, int> >::const_iterator iter = runRanges.begin();
+    for(; iter != runRanges.end(); ++iter)
+    {
+        if(!result.empty()) result += " OR ";
+        result += "(`constantSets`.`constantTypeId` = " + StringUtils::IntToString(iter->first) +
+                  " AND `runRanges`.`runMax` >= " + StringUtils::IntToString(iter->second.first) +
+                  " AND `runRanges`.`runMin` <= " + StringUtils::IntToString(iter->second.second) + ")";
+    }
+    return "(" + result + ")";
+}
+
+
 
 
 //----------------------------------------------------------------------------------------
@@ -310,6 +561,20 @@ bool DataProvider::GetVariations(vector<Variation*>& resultVariations, const str
 #pragma region Assignments
 
 
+//______________________________________________________________________________
+bool DataProvider::GetAssignmentsShort(map<string, Assignment*>& assignments, int run, const vector<string>& paths, time_t time/*=0*/, const string& variation/*="default"*/)
+{
+	for(size_t i=0; i<paths.size(); i++)
+	{
+		if(assignments.find(paths[i]) != assignments.end()) continue;
+
+		Assignment *assignment = GetAssignmentShort(run, paths[i], time, variation);
+		if(assignment) assignments[paths[i]] = assignment;
+	}
+	return true;
+}
+
+
 Assignment* DataProvider::GetAssignmentFull( int run, const string& path, const string& variation )
 {
 	/** @brief Get last Assignment with all related objects
@@ -354,6 +619,103 @@ Assignment* DataProvider::GetAssignmentFull( int run, const string& path,int ver
 	return *assigments.begin();
 }
 
+
+//______________________________________________________________________________
+Assignment* DataProvider::CreateAssignment(const vector<vector<string> >& data, const string& path, int runMin, int runMax, const string& variation/*="default"*/, const string& comment/*=""*/)
+{
+	ClearErrors(); //Clear error in function that can produce new ones
+
+	ConstantsTypeTable *table = GetCachedConstantsTypeTable(path);
+	if(!table)
+	{
+		Error(CCDB_ERROR_NO_TYPETABLE, "DataProvider::CreateAssignment", "Type table was not found: '" + path + "'");
+		return NULL;
+	}
+
+	vector<string> cells;
+	for(size_t row=0; row<data.size(); row++)
+	{
+		cells.insert(cells.end(), data[row].begin(), data[row].end());
+	}
+
+	Assignment *assignment = new Assignment(this, this);
+	assignment->SetTypeTable(table);
+	assignment->SetRawData(Assignment::VectorToBlob(cells));
+	assignment->SetComment(comment);
+
+	RunRange *runRange = new RunRange(assignment, this);
+	runRange->SetRange(runMin, runMax);
+	assignment->SetRunRange(runRange);
+
+	Variation *assignmentVariation = new Variation(assignment, this);
+	assignmentVariation->SetName(variation);
+	assignment->SetVariation(assignmentVariation);
+
+	if(!CreateAssignments(vector<Assignment *>(1, assignment)))
+	{
+		delete assignment;
+		return NULL;
+	}
+	return assignment;
+}
+
+
+//______________________________________________________________________________
+bool DataProvider::CreateAssignments(const vector<Assignment *>& /*assignments*/)
+{
+	Error(CCDB_ERROR_NOT_IMPLEMENTED, "DataProvider::CreateAssignments", "This provider can't add assignments");
+	return false;
+}
+
+
+//______________________________________________________________________________
+bool DataProvider::CheckNewAssignment(Assignment* assignment, const string& errorSource)
+{
+	if(assignment == NULL)
+	{
+		Error(CCDB_ERROR_ASSIGMENT_INVALID, errorSource, "Assignment is NULL");
+		return false;
+	}
+
+	//a table that is not loaded from the database only tells the path
+	ConstantsTypeTable *table = assignment->GetTypeTable();
+	if(table != NULL && table->GetId() <= 0)
+	{
+		table = GetCachedConstantsTypeTable(table->GetFullPath());
+		if(table) assignment->SetTypeTable(table);
+	}
+	if(table == NULL)
+	{
+		Error(CCDB_ERROR_NO_TYPETABLE, errorSource, "Assignment has no type table or the table was not found");
+		return false;
+	}
+
+	RunRange *runRange = assignment->GetRunRange();
+	if(runRange == NULL || runRange->GetMin() > runRange->GetMax())
+	{
+		Error(CCDB_ERROR_RUNRANGE_INVALID, errorSource, "Assignment of '" + table->GetFullPath() + "' has no valid run range");
+		return false;
+	}
+
+	Variation *known = assignment->GetVariation() ? GetVariation(assignment->GetVariation()->GetName()) : NULL;
+	if(known == NULL)
+	{
+		Error(CCDB_ERROR_VARIATION_INVALID, errorSource, "Assignment of '" + table->GetFullPath() + "' has no existing variation");
+		return false;
+	}
+	assignment->GetVariation()->SetId(known->GetId());
+
+	//the data must fill the table, as readers split it by the number of columns
+	size_t cellsCount = assignment->GetVectorData().size();
+	if(table->GetColumnsCount() == 0 || cellsCount != static_cast<size_t>(table->GetRowsCount() * table->GetColumnsCount()))
+	{
+		Error(CCDB_ERROR_DATA_INCONSISTANT, errorSource, StringUtils::Format("Assignment of '%s' has %i cells, the table has %i rows and %i columns",
+			table->GetFullPath().c_str(), (int)cellsCount, table->GetRowsCount(), table->GetColumnsCount()));
+		return false;
+	}
+	return true;
+}
+
 //______________________________________________________________________________
 
 #pragma endregion Assignments
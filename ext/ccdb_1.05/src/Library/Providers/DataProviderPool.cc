@@ -0,0 +1,99 @@
+#include <stdexcept>
+
+#include "CCDB/Providers/DataProviderPool.h"
+#include "CCDB/Helpers/StringUtils.h"
+
+namespace ccdb
+{
+
+//______________________________________________________________________________
+DataProviderPool::DataProviderPool(const string& connectionString):
+	mConnectionString(connectionString)
+{
+	pthread_mutex_init(&mMutex, NULL);
+	pthread_cond_init(&mFreeCondition, NULL);
+}
+
+
+//______________________________________________________________________________
+DataProviderPool::~DataProviderPool()
+{
+	for(size_t i=0; i<mProviders.size(); i++)
+	{
+		if(mProviders[i]->IsConnected()) mProviders[i]->Disconnect();
+		delete mProviders[i];
+	}
+
+	pthread_cond_destroy(&mFreeCondition);
+	pthread_mutex_destroy(&mMutex);
+}
+
+
+//______________________________________________________________________________
+void DataProviderPool::Add(DataProvider *provider)
+{
+	pthread_mutex_lock(&mMutex);
+	mProviders.push_back(provider);
+	mFree.push_back(provider);
+	pthread_cond_signal(&mFreeCondition);
+	pthread_mutex_unlock(&mMutex);
+}
+
+
+//______________________________________________________________________________
+bool DataProviderPool::Connect()
+{
+	bool result = true;
+	for(size_t i=0; i<mProviders.size(); i++)
+	{
+		if(!mProviders[i]->IsConnected() && !mProviders[i]->Connect(mConnectionString)) result = false;
+	}
+	return result;
+}
+
+
+//______________________________________________________________________________
+void DataProviderPool::Disconnect()
+{
+	//providers that are checked out now stay connected
+	pthread_mutex_lock(&mMutex);
+	for(size_t i=0; i<mFree.size(); i++)
+	{
+		if(mFree[i]->IsConnected()) mFree[i]->Disconnect();
+	}
+	pthread_mutex_unlock(&mMutex);
+}
+
+
+//______________________________________________________________________________
+DataProvider * DataProviderPool::Acquire(bool connect)
+{
+	pthread_mutex_lock(&mMutex);
+	while(mFree.empty())
+	{
+		pthread_cond_wait(&mFreeCondition, &mMutex);
+	}
+	DataProvider *provider = mFree.back();
+	mFree.pop_back();
+	pthread_mutex_unlock(&mMutex);
+
+	//the connection is made outside the lock, the provider belongs to this thread now
+	if(!connect || provider->IsConnected() || provider->Connect(mConnectionString)) return provider;
+
+	//the message of the error is logged by the provider
+	int errorCode = provider->GetLastError();
+	Release(provider);
+	throw std::logic_error(StringUtils::Format("DataProviderPool::Acquire(). Can not reconnect a pooled provider to '%s', error code %i", mConnectionString.c_str(), errorCode));
+}
+
+
+//______________________________________________________________________________
+void DataProviderPool::Release(DataProvider *provider)
+{
+	pthread_mutex_lock(&mMutex);
+	mFree.push_back(provider);
+	pthread_cond_signal(&mFreeCondition);
+	pthread_mutex_unlock(&mMutex);
+}
+
+}
@@ -1,30 +1,1112 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits.h>
+#include <set>
+
+#ifndef WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif //WIN32
+
+#include "CCDB/Globals.h"
+#include "CCDB/Helpers/PathUtils.h"
+#include "CCDB/Helpers/StringUtils.h"
 #include "CCDB/Providers/FileDataProvider.h"
-namespace ccdb
+#include "CCDB/Model/RunRange.h"
+
+using namespace std;
+
+namespace
 {
+	const char* TypeNames[] = {"int", "uint", "long", "ulong", "double", "bool", "string"};
+	const size_t TypeNamesCount = sizeof(TypeNames)/sizeof(TypeNames[0]);
 
+	//______________________________________________________________________________
+	/** Reads whitespace separated tokens of [pos, last) to tokens. "quoted strings" are one token */
+	void Tokenize(const char* pos, const char* last, vector<string>& tokens)
+	{
+		while(pos < last)
+		{
+			while(pos < last && isspace(static_cast<unsigned char>(*pos))) pos++;
+			if(pos >= last) break;
 
+			if(*pos == '"')
+			{
+				const char* end = static_cast<const char*>(memchr(pos + 1, '"', last - pos - 1));
+				if(end == NULL) end = last;
+				tokens.push_back(string(pos + 1, end));
+				pos = end + 1;
+				continue;
+			}
 
-FileDataProvider::FileDataProvider(void)
+			const char* start = pos;
+			while(pos < last && !isspace(static_cast<unsigned char>(*pos))) pos++;
+			tokens.push_back(string(start, pos));
+		}
+	}
+
+	//______________________________________________________________________________
+	/** Length of the type name that starts the token or 0 */
+	size_t TypeNamePrefix(const string& token)
+	{
+		for(size_t i=0; i<TypeNamesCount; i++)
+		{
+			size_t length = strlen(TypeNames[i]);
+			if(token.compare(0, length, TypeNames[i]) == 0) return length;
+		}
+		return 0;
+	}
+
+	//______________________________________________________________________________
+	/** Order of files: older first, then by name */
+	struct FileIsOlder
+	{
+		template<class File>
+		bool operator()(const File& lhs, const File& rhs) const
+		{
+			if(lhs.Created != rhs.Created) return lhs.Created < rhs.Created;
+			return lhs.FileName < rhs.FileName;
+		}
+	};
+}
+
+namespace ccdb
 {
 
+
+//______________________________________________________________________________
+FileDataProvider::FileDataProvider(void)
+{
+	mIsConnected = false;
+	mRootDir = new Directory(this, this);
+	mDirsAreLoaded = false;
 }
 
 
+//______________________________________________________________________________
 FileDataProvider::~FileDataProvider(void)
 {
+	if(IsConnected())
+	{
+		Disconnect();
+	}
 }
 
+
+//----------------------------------------------------------------------------------------
+//	C O N N E C T I O N
+//----------------------------------------------------------------------------------------
+#pragma region Connection
+
+//______________________________________________________________________________
 bool FileDataProvider::Connect( std::string connectionString )
 {
-	//
+	ClearErrors(); //Clear error in function that can produce new ones
+
+	//check for uri type
+	if(connectionString.find("file://") != 0)
+	{
+		Error(CCDB_ERROR_PARSE_CONNECTION_STRING, "FileDataProvider::Connect()", "Error parse file connection string. The string is not started with file://");
+		return false;
+	}
+
+	if(IsConnected())
+	{
+		Error(CCDB_ERROR_CONNECTION_ALREADY_OPENED, "FileDataProvider::Connect()", "Connection already opened");
+		return false;
+	}
+
+	string root = connectionString.substr(7);
+	while(root.length() > 1 && root[root.length()-1] == '/') root.erase(root.length()-1);
+
+	mRootDirectory = root;
+	mDirectoryPaths.clear();
+	mFiles.clear();
+	mTables.clear();
+	mVariationParents.clear();
+
+	if(!IndexDirectory(root, "/"))
+	{
+		mFiles.clear();
+		mTables.clear();
+		return false;
+	}
+	ReadVariationParents(root + "/variations.txt");
+
+	//ids follow the creation order, so the timeline takes the newest file where they overlap
+	sort(mFiles.begin(), mFiles.end(), FileIsOlder());
+	for(size_t i=0; i<mFiles.size(); i++)
+	{
+		mFiles[i].Id = static_cast<dbkey_t>(i + 1);
+		mTables[mFiles[i].Path].Files.push_back(i);
+	}
+	dbkey_t tableId = 1;
+	for(map<string, TableIndex>::iterator iter = mTables.begin(); iter != mTables.end(); ++iter)
+	{
+		iter->second.Id = tableId++;
+		iter->second.DirectoryPath = PathUtils::ExtractDirectory(iter->first);
+	}
+
+	//a new index, everything built from the previous one is dropped
+	mDirsAreLoaded = false;
+	mVariationsAreLoaded = false;
+	InvalidateTypeTablesCache();
+	InvalidateAssignmentTimelines();
+
+	mConnectionString = connectionString;
+	mIsConnected = true;
+	return true;
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::IndexDirectory(const string& fileDir, const string& path)
+{
+	/** @brief Adds files and subdirectories of the file system directory to the index
+	 *
+	 * @param fileDir - the directory in the file system
+	 * @param path    - the directory in the tree, "/" for the root
+	 */
+#ifndef WIN32
+	DIR *dir = opendir(fileDir.c_str());
+	if(dir == NULL)
+	{
+		Error(CCDB_ERROR_CONNECTION_EXTERNAL_ERROR, "FileDataProvider::Connect()", "Can't open directory '" + fileDir + "'");
+		return false;
+	}
+
+	vector<string> subdirectories;
+	struct dirent *entry;
+	while((entry = readdir(dir)) != NULL)
+	{
+		string name(entry->d_name);
+		if(name.empty() || name[0] == '.') continue;
+
+		string fileName = fileDir + "/" + name;
+		struct stat info;
+		if(stat(fileName.c_str(), &info) != 0) continue;
+
+		if(S_ISDIR(info.st_mode))
+		{
+			subdirectories.push_back(name);
+		}
+		else if(S_ISREG(info.st_mode))
+		{
+			TableFile file;
+			if(!ParseFileName(name, file)) continue;
+			file.FileName = fileName;
+			file.Path = PathUtils::CombinePath(path, file.Path);
+			mFiles.push_back(file);
+		}
+	}
+	closedir(dir);
+
+	sort(subdirectories.begin(), subdirectories.end());
+	for(size_t i=0; i<subdirectories.size(); i++)
+	{
+		string subPath = PathUtils::CombinePath(path, subdirectories[i]);
+		mDirectoryPaths.push_back(subPath);
+		if(!IndexDirectory(fileDir + "/" + subdirectories[i], subPath)) return false;
+	}
+	return true;
+#else
+	Error(CCDB_ERROR_NOT_IMPLEMENTED, "FileDataProvider::Connect()", "Directory listing is not implemented for this platform");
 	return false;
+#endif //WIN32
+}
 
+
+//______________________________________________________________________________
+bool FileDataProvider::ParseFileName(const string& name, TableFile& file)
+{
+	/** @brief Reads <table>.<variation>.<min>-<max>[.<created>].txt
+	 *
+	 * @param [out] file - Path is set to the table name
+	 * @return false if the name is not a name of a table file
+	 */
+	if(name.length() < 4 || name.compare(name.length() - 4, 4, ".txt") != 0) return false;
+
+	vector<string> parts = StringUtils::Split(name.substr(0, name.length() - 4), ".");
+	if(parts.size() != 3 && parts.size() != 4) return false;
+	if(!ValidateName(parts[0]) || !ValidateName(parts[1])) return false;
+
+	size_t dash = parts[2].find('-');
+	if(dash == string::npos || dash == 0) return false;
+	string runMin = parts[2].substr(0, dash);
+	string runMax = parts[2].substr(dash + 1);
+	if(runMin.find_first_not_of("0123456789") != string::npos) return false;
+	if(runMax != "max" && (runMax.empty() || runMax.find_first_not_of("0123456789") != string::npos)) return false;
+
+	file.Path = parts[0];
+	file.Variation = parts[1];
+	file.RunMin = atoi(runMin.c_str());
+	file.RunMax = runMax == "max" ? INT_MAX : atoi(runMax.c_str());
+	file.Created = 0;
+	if(parts.size() == 4)
+	{
+		if(parts[3].empty() || parts[3].find_first_not_of("0123456789") != string::npos) return false;
+		file.Created = static_cast<time_t>(atol(parts[3].c_str()));
+	}
+	return file.RunMin <= file.RunMax;
 }
 
+
+//______________________________________________________________________________
+void FileDataProvider::ReadVariationParents(const string& fileName)
+{
+	FILE *file = fopen(fileName.c_str(), "r");
+	if(file == NULL) return;      //no such file, all variations are children of default
+
+	char line[1024];
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		vector<string> tokens;
+		Tokenize(line, line + strlen(line), tokens);
+		if(tokens.empty() || tokens[0][0] == '#') continue;
+		mVariationParents[tokens[0]] = tokens.size() > 1 ? tokens[1] : string();
+	}
+	fclose(file);
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::IsConnected()
+{
+	return mIsConnected;
+}
+
+
+//______________________________________________________________________________
 void FileDataProvider::Disconnect()
 {
-	//
+	mIsConnected = false;
+	mDirectoryPaths.clear();
+	mFiles.clear();
+	mTables.clear();
+	mVariationParents.clear();
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::CheckConnection( const string& errorSource/*=""*/ )
+{
+	ClearErrors(); //Clear error in function that can produce new ones
+
+	if(!IsConnected())
+	{
+		Error(CCDB_ERROR_NOT_CONNECTED, errorSource.c_str(), "Provider is not connected to a directory of table files.");
+		return false;
+	}
+	return true;
+}
+#pragma endregion Connection
+
+
+//----------------------------------------------------------------------------------------
+//	D I R E C T O R Y   M A N G E M E N T
+//----------------------------------------------------------------------------------------
+#pragma region Directories
+
+//______________________________________________________________________________
+Directory* FileDataProvider::GetDirectory( const string& path )
+{
+	return DataProvider::GetDirectory(path);
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::LoadDirectories()
+{
+	if(!IsConnected()) return false;
+
+	mDirectories.clear();
+	mDirectoriesById.clear();
+
+	//parents are indexed before children, so the id of a parent is always known
+	map<string, dbkey_t> idsByPath;
+	idsByPath["/"] = 0;
+	for(size_t i=0; i<mDirectoryPaths.size(); i++)
+	{
+		const string& path = mDirectoryPaths[i];
+		Directory *dir = new Directory(this, this);
+		dir->SetId(static_cast<dbkey_t>(i + 1));
+		dir->SetName(PathUtils::ExtractObjectname(path));
+		dir->SetParentId(idsByPath[PathUtils::ExtractDirectory(path)]);
+		idsByPath[path] = dir->GetId();
+
+		mDirectories.push_back(dir);
+		mDirectoriesById[dir->GetId()] = dir;
+	}
+
+	//clear root directory (delete all directory structure objects)
+	mRootDir->DisposeSubdirectories();
+	mRootDir->SetFullPath("/");
+
+	BuildDirectoryDependencies();
+
+	mDirsAreLoaded = true;
+	return true;
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::SearchDirectories( vector<Directory *>& resultDirectories, const string& searchPattern, const string& parentPath/*=""*/, int take/*=0*/, int startWith/*=0*/ )
+{
+	if(!CheckConnection("FileDataProvider::SearchDirectories")) return false;
+	UpdateDirectoriesIfNeeded();
+
+	Directory *parentDir = NULL;
+	if(parentPath != "")
+	{
+		parentDir = GetDirectory(parentPath);
+		if(parentDir == NULL)
+		{
+			Error(CCDB_ERROR_DIRECTORY_NOT_FOUND, "FileDataProvider::SearchDirectories", "Path to search is not found");
+			return false;
+		}
+	}
+
+	resultDirectories.clear();
+	int found = 0;
+	for(size_t i=0; i<mDirectories.size(); i++)
+	{
+		Directory *dir = mDirectories[i];
+		if(parentDir && dir->GetParentDirectory() != parentDir) continue;
+		if(!StringUtils::WildCardCheck(searchPattern.c_str(), dir->GetName().c_str())) continue;
+
+		if(found++ < startWith) continue;
+		resultDirectories.push_back(dir);
+		if(take > 0 && (int)resultDirectories.size() >= take) break;
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+vector<Directory *> FileDataProvider::SearchDirectories( const string& searchPattern, const string& parentPath/*=""*/, int take/*=0*/, int startWith/*=0*/ )
+{
+	vector<Directory *> result;
+	SearchDirectories(result, searchPattern, parentPath, take, startWith);
+	return result;
+}
+
+#pragma endregion Directories
+
+
+//----------------------------------------------------------------------------------------
+//	C O N S T A N T   T Y P E   T A B L E
+//----------------------------------------------------------------------------------------
+#pragma region Type Tables
+
+//______________________________________________________________________________
+ConstantsTypeTable * FileDataProvider::GetConstantsTypeTable( const string& name, Directory *parentDir, bool loadColumns/*=false*/ )
+{
+	ClearErrors();
+	if(!CheckConnection("FileDataProvider::GetConstantsTypeTable")) return NULL;
+
+	if(parentDir == NULL)
+	{
+		Error(CCDB_ERROR_NO_PARENT_DIRECTORY, "FileDataProvider::GetConstantsTypeTable", "Parent directory is null");
+		return NULL;
+	}
+
+	string path = PathUtils::CombinePath(parentDir->GetFullPath(), name);
+	map<string, TableIndex>::iterator iter = mTables.find(path);
+	if(iter == mTables.end()) return NULL;
 
+	ConstantsTypeTable *table = new ConstantsTypeTable(this, this);
+	table->SetId(iter->second.Id);
+	table->SetName(name);
+	table->SetDirectoryId(parentDir->GetId());
+	table->SetDirectory(parentDir);
+	table->SetFullPath(path);
+	SetObjectLoaded(table);
 
+	if(loadColumns && !LoadColumns(table))
+	{
+		delete table;
+		return NULL;
+	}
+	return table;
 }
+
+
+//______________________________________________________________________________
+ConstantsTypeTable * FileDataProvider::GetConstantsTypeTable( const string& path, bool loadColumns/*=false*/ )
+{
+	return DataProvider::GetConstantsTypeTable(path, loadColumns);
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::GetConstantsTypeTables( vector<ConstantsTypeTable *>& typeTables, const string& parentDirPath, bool loadColumns/*=false*/ )
+{
+	return SearchConstantsTypeTables(typeTables, "*", parentDirPath, loadColumns);
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::GetConstantsTypeTables( vector<ConstantsTypeTable *>& typeTables, Directory *parentDir, bool loadColumns/*=false*/ )
+{
+	if(parentDir == NULL)
+	{
+		Error(CCDB_ERROR_NO_PARENT_DIRECTORY, "FileDataProvider::GetConstantsTypeTables", "Parent directory is null");
+		return false;
+	}
+	return SearchConstantsTypeTables(typeTables, "*", parentDir->GetFullPath(), loadColumns);
+}
+
+
+//______________________________________________________________________________
+vector<ConstantsTypeTable *> FileDataProvider::GetConstantsTypeTables( Directory *parentDir, bool loadColumns/*=false*/ )
+{
+	vector<ConstantsTypeTable *> tables;
+	GetConstantsTypeTables(tables, parentDir, loadColumns);
+	return tables;
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::SearchConstantsTypeTables( vector<ConstantsTypeTable *>& typeTables, const string& pattern, const string& parentPath /*= ""*/, bool loadColumns/*=false*/, int take/*=0*/, int startWith/*=0 */ )
+{
+	ClearErrors(); //Clear error in function that can produce new ones
+	if(!CheckConnection("FileDataProvider::SearchConstantsTypeTables")) return false;
+
+	string parentFullPath;
+	if(parentPath != "")
+	{
+		Directory *parentDir = GetDirectory(parentPath);
+		if(parentDir == NULL)
+		{
+			Error(CCDB_ERROR_DIRECTORY_NOT_FOUND, "FileDataProvider::SearchConstantsTypeTables", "Path to search is not found");
+			return false;
+		}
+		parentFullPath = parentDir->GetFullPath();
+	}
+
+	//Ok, lets cleanup result list
+	for(size_t i=0; i<typeTables.size(); i++)
+	{
+		if(IsOwner(typeTables[i])) delete typeTables[i];   //delete objects if this provider is owner
+	}
+	typeTables.clear();
+
+	int found = 0;
+	map<string, TableIndex>::iterator iter = mTables.begin();
+	for(; iter != mTables.end(); ++iter)
+	{
+		const TableIndex& index = iter->second;
+		if(!parentFullPath.empty() && index.DirectoryPath != parentFullPath) continue;
+
+		string name = PathUtils::ExtractObjectname(iter->first);
+		if(!StringUtils::WildCardCheck(pattern.c_str(), name.c_str())) continue;
+
+		if(found++ < startWith) continue;
+		ConstantsTypeTable *table = GetConstantsTypeTable(name, GetDirectory(index.DirectoryPath), loadColumns);
+		if(table) typeTables.push_back(table);
+		if(take > 0 && (int)typeTables.size() >= take) break;
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+vector<ConstantsTypeTable *> FileDataProvider::SearchConstantsTypeTables( const string& pattern, const string& parentPath /*= ""*/, bool loadColumns/*=false*/, int take/*=0*/, int startWith/*=0 */ )
+{
+	vector<ConstantsTypeTable *> tables;
+	SearchConstantsTypeTables(tables, pattern, parentPath, loadColumns, take, startWith);
+	return tables;
+}
+
+
+//______________________________________________________________________________
+int FileDataProvider::CountConstantsTypeTables(Directory *dir)
+{
+	if(dir == NULL || !IsConnected()) return 0;
+
+	int count = 0;
+	map<string, TableIndex>::iterator iter = mTables.begin();
+	for(; iter != mTables.end(); ++iter)
+	{
+		if(iter->second.DirectoryPath == dir->GetFullPath()) count++;
+	}
+	return count;
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::LoadColumns( ConstantsTypeTable* table )
+{
+	ClearErrors(); //Clear error in function that can produce new ones
+	if(!CheckConnection("FileDataProvider::LoadColumns")) return false;
+
+	map<string, TableIndex>::iterator iter = mTables.find(table->GetFullPath());
+	if(iter == mTables.end())
+	{
+		Error(CCDB_ERROR_NO_TYPETABLE, "FileDataProvider::LoadColumns", "Type table was not found: '" + table->GetFullPath() + "'");
+		return false;
+	}
+
+	const TableFile& file = mFiles[iter->second.Files.back()];
+	vector<string> names, types, cells;
+	if(!ReadTableFile(file.FileName, names, types, cells))
+	{
+		Error(CCDB_ERROR_CONNECTION_EXTERNAL_ERROR, "FileDataProvider::LoadColumns", "Can't read file '" + file.FileName + "'");
+		return false;
+	}
+	if(names.empty())
+	{
+		Error(CCDB_ERROR_TABLE_NO_COLUMNS, "FileDataProvider::LoadColumns", "File '" + file.FileName + "' has no '# names # types' header");
+		return false;
+	}
+
+	table->ClearColumns();
+	for(size_t i=0; i<names.size(); i++)
+	{
+		table->AddColumn(names[i], types[i]);
+	}
+	table->SetNRows(static_cast<int>(cells.size() / names.size()));
+	return true;
+}
+
+#pragma endregion Type Tables
+
+
+//----------------------------------------------------------------------------------------
+//	T A B L E   F I L E S
+//----------------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+bool FileDataProvider::ReadTableFile(const string& fileName, vector<string>& names, vector<string>& types, vector<string>& cells)
+{
+#ifndef WIN32
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if(fd < 0) return false;
+
+	struct stat info;
+	if(fstat(fd, &info) != 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	size_t size = static_cast<size_t>(info.st_size);
+	if(size == 0)
+	{
+		close(fd);
+		ParseTableText(NULL, NULL, names, types, cells);
+		return true;
+	}
+
+	void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED) return false;
+
+	const char *first = static_cast<const char*>(data);
+	ParseTableText(first, first + size, names, types, cells);
+	munmap(data, size);
+	return true;
+#else
+	FILE *file = fopen(fileName.c_str(), "rb");
+	if(file == NULL) return false;
+
+	string text;
+	char buffer[4096];
+	size_t count;
+	while((count = fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, count);
+	fclose(file);
+
+	ParseTableText(text.data(), text.data() + text.size(), names, types, cells);
+	return true;
+#endif //WIN32
+}
+
+
+//______________________________________________________________________________
+void FileDataProvider::ParseTableText(const char* first, const char* last, vector<string>& names, vector<string>& types, vector<string>& cells)
+{
+	names.clear();
+	types.clear();
+	cells.clear();
+
+	const char *line = first;
+	while(line < last)
+	{
+		const char *end = static_cast<const char*>(memchr(line, '\n', last - line));
+		if(end == NULL) end = last;
+
+		const char *pos = line;
+		while(pos < end && isspace(static_cast<unsigned char>(*pos))) pos++;
+
+		if(pos < end && *pos == '#')
+		{
+			//the first "# names # types" line is the header, other # lines are comments
+			const char *typesStart = static_cast<const char*>(memchr(pos + 1, '#', end - pos - 1));
+			if(names.empty() && typesStart != NULL)
+			{
+				Tokenize(pos + 1, typesStart, names);
+
+				vector<string> tokens;
+				Tokenize(typesStart + 1, end, tokens);
+				size_t typesCount = min(tokens.size(), names.size());
+
+				//without a line break after the header the last type is glued to the first cell
+				if(typesCount > 0 && tokens[typesCount-1].length() > TypeNamePrefix(tokens[typesCount-1]) && TypeNamePrefix(tokens[typesCount-1]) > 0)
+				{
+					string& glued = tokens[typesCount-1];
+					size_t length = TypeNamePrefix(glued);
+					tokens.insert(tokens.begin() + typesCount, glued.substr(length));
+					glued.erase(length);
+				}
+
+				types.assign(tokens.begin(), tokens.begin() + typesCount);
+				types.resize(names.size(), "double");
+				cells.insert(cells.end(), tokens.begin() + typesCount, tokens.end());
+			}
+		}
+		else
+		{
+			Tokenize(pos, end, cells);
+		}
+
+		line = end + 1;
+	}
+}
+
+
+//______________________________________________________________________________
+const FileDataProvider::TableFile* FileDataProvider::FindFile(dbkey_t id) const
+{
+	//ids are positions in mFiles + 1
+	if(id < 1 || static_cast<size_t>(id) > mFiles.size()) return NULL;
+	return &mFiles[id - 1];
+}
+
+
+//----------------------------------------------------------------------------------------
+//	R U N   R A N G E S
+//----------------------------------------------------------------------------------------
+#pragma region Run ranges
+
+//______________________________________________________________________________
+RunRange* FileDataProvider::GetRunRange( int min, int max, const string& name /*= ""*/ )
+{
+	if(!CheckConnection("FileDataProvider::GetRunRange")) return NULL;
+	if(name != "") return NULL;     //files have no named run ranges
+
+	for(size_t i=0; i<mFiles.size(); i++)
+	{
+		if(mFiles[i].RunMin == min && mFiles[i].RunMax == max)
+		{
+			RunRange *runRange = new RunRange(this, this);
+			runRange->SetRange(min, max);
+			return runRange;
+		}
+	}
+	return NULL;
+}
+
+
+//______________________________________________________________________________
+RunRange* FileDataProvider::GetRunRange( const string& /*name*/ )
+{
+	return NULL;
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::GetRunRanges(vector<RunRange*>& resultRunRanges, ConstantsTypeTable* table, const string& variation/*=""*/, int take/*=0*/, int startWith/*=0*/)
+{
+	ClearErrors(); //Clear error in function that can produce new ones
+	if(!CheckConnection("FileDataProvider::GetRunRanges")) return false;
+
+	if(table == NULL || mTables.find(table->GetFullPath()) == mTables.end())
+	{
+		Error(CCDB_ERROR_NO_TYPETABLE, "FileDataProvider::GetRunRanges", "Type table is null or not found");
+		return false;
+	}
+
+	//distinct ranges ordered by the first run, as the SQL providers do
+	set<pair<int, int> > ranges;
+	const vector<size_t>& files = mTables[table->GetFullPath()].Files;
+	for(size_t i=0; i<files.size(); i++)
+	{
+		const TableFile& file = mFiles[files[i]];
+		if(variation != "" && file.Variation != variation) continue;
+		ranges.insert(make_pair(file.RunMin, file.RunMax));
+	}
+
+	resultRunRanges.clear();
+	int found = 0;
+	for(set<pair<int, int> >::iterator iter = ranges.begin(); iter != ranges.end(); ++iter)
+	{
+		if(found++ < startWith) continue;
+		RunRange *runRange = new RunRange(this, this);
+		runRange->SetRange(iter->first, iter->second);
+		resultRunRanges.push_back(runRange);
+		if(take > 0 && (int)resultRunRanges.size() >= take) break;
+	}
+	return true;
+}
+
+#pragma endregion Run ranges
+
+
+//----------------------------------------------------------------------------------------
+//	V A R I A T I O N
+//----------------------------------------------------------------------------------------
+#pragma region Variation
+
+//______________________________________________________________________________
+bool FileDataProvider::LoadVariations()
+{
+	if(!CheckConnection("FileDataProvider::LoadVariations()")) return false;
+
+	//variations of the files and of variations.txt. default goes first, so it gets id 1
+	vector<string> names(1, "default");
+	set<string> known(names.begin(), names.end());
+	for(size_t i=0; i<mFiles.size(); i++)
+	{
+		if(known.insert(mFiles[i].Variation).second) names.push_back(mFiles[i].Variation);
+	}
+	for(map<string, string>::iterator iter = mVariationParents.begin(); iter != mVariationParents.end(); ++iter)
+	{
+		if(known.insert(iter->first).second) names.push_back(iter->first);
+		if(!iter->second.empty() && known.insert(iter->second).second) names.push_back(iter->second);
+	}
+
+	map<string, dbkey_t> idsByName;
+	for(size_t i=0; i<names.size(); i++) idsByName[names[i]] = static_cast<dbkey_t>(i + 1);
+
+	mVariationsById.clear();
+	for(size_t i=0; i<names.size(); i++)
+	{
+		Variation *variation = new Variation(this, this);
+		variation->SetId(idsByName[names[i]]);
+		variation->SetName(names[i]);
+
+		map<string, string>::iterator parentIter = mVariationParents.find(names[i]);
+		string parent = (parentIter != mVariationParents.end()) ? parentIter->second
+		              : (names[i] == "default" ? string() : string("default"));
+		variation->SetParentDbId(parent.empty() ? 0 : idsByName[parent]);
+
+		mVariationsById[variation->GetId()] = variation;
+	}
+
+	BuildVariationDependencies();
+	return true;
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::GetVariations(vector<Variation*>& resultVariations, ConstantsTypeTable* table, int run, int take, int startWith)
+{
+	ClearErrors(); //Clear error in function that can produce new ones
+	if(!CheckConnection("FileDataProvider::GetVariations")) return false;
+
+	if(table == NULL || mTables.find(table->GetFullPath()) == mTables.end())
+	{
+		Error(CCDB_ERROR_NO_TYPETABLE, "FileDataProvider::GetVariations", "Type table is null or not found");
+		return false;
+	}
+
+	set<string> names;
+	const vector<size_t>& files = mTables[table->GetFullPath()].Files;
+	for(size_t i=0; i<files.size(); i++)
+	{
+		const TableFile& file = mFiles[files[i]];
+		if(run != 0 && (run < file.RunMin || run > file.RunMax)) continue;
+		names.insert(file.Variation);
+	}
+
+	resultVariations.clear();
+	int found = 0;
+	for(set<string>::iterator iter = names.begin(); iter != names.end(); ++iter)
+	{
+		Variation *known = GetVariation(*iter);
+		if(known == NULL) continue;
+		if(found++ < startWith) continue;
+
+		//a copy, the provider keeps its variations
+		Variation *variation = new Variation(this, this);
+		variation->SetId(known->GetId());
+		variation->SetName(known->GetName());
+		variation->SetParentDbId(known->GetParentDbId());
+		resultVariations.push_back(variation);
+		if(take > 0 && (int)resultVariations.size() >= take) break;
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+vector<Variation *> FileDataProvider::GetVariations( ConstantsTypeTable *table, int run/*=0*/, int take/*=0*/, int startWith/*=0 */ )
+{
+	vector<Variation *> resultVariations;
+	GetVariations(resultVariations, table, run, take, startWith);
+	return resultVariations;
+}
+
+#pragma endregion Variation
+
+
+//----------------------------------------------------------------------------------------
+//	A S S I G N M E N T S
+//----------------------------------------------------------------------------------------
+#pragma region Assignments
+
+//______________________________________________________________________________
+Assignment* FileDataProvider::GetAssignmentShort(int run, const string& path, const string& variationName, bool loadColumns /*=false*/)
+{
+	return GetAssignmentShort(run, path, 0, variationName, loadColumns);
+}
+
+
+//______________________________________________________________________________
+Assignment* FileDataProvider::GetAssignmentShort(int run, const string& path, time_t time, const string& variationName, bool /*loadColumns =false*/)
+{
+	/** @brief Gets the assignment of the run from the index and reads its file
+	 *
+	 * @param [in] time - files created later are not used. 0 - all files
+	 * @return new Assignment or NULL if no file covers the run
+	 */
+	ClearErrors(); //Clear error in function that can produce new ones
+	if(!CheckConnection("FileDataProvider::GetAssignmentShort")) return NULL;
+
+	//Get type table. It is cached by the provider and shared between assignments
+	ConstantsTypeTable *table = GetCachedConstantsTypeTable(path);
+	if(!table)
+	{
+		Error(CCDB_ERROR_NO_TYPETABLE, "FileDataProvider::GetAssignmentShort", "Type table was not found: '"+path+"'" );
+		return NULL;
+	}
+
+	Variation* variation = GetVariation(variationName);
+	if(!variation)
+	{
+		Error(CCDB_ERROR_VARIATION_INVALID, "FileDataProvider::GetAssignmentShort", "No variation '"+variationName+"' was found");
+		return NULL;
+	}
+
+	const AssignmentTimeline *timeline = GetAssignmentTimeline(table, variation, time);
+	if(!timeline) return NULL;
+
+	const AssignmentTimeline::Interval *interval = timeline->Find(run);
+	if(!interval) return NULL;
+
+	const TableFile *file = FindFile(interval->ConstantSetId);
+	if(file == NULL) return NULL;
+
+	Assignment *assignment = MakeAssignment(*file, false);
+	if(assignment == NULL) return NULL;
+
+	assignment->SetRequestedRun(run);
+	assignment->SetValidRuns(interval->RunMin, interval->RunMax);
+	assignment->SetTypeTable(table);
+	return assignment;
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::LoadAssignmentTimeline(AssignmentTimeline& timeline, ConstantsTypeTable* table, Variation* variation, time_t time)
+{
+	if(!CheckConnection("FileDataProvider::LoadAssignmentTimeline")) return false;
+
+	map<string, TableIndex>::iterator tableIter = mTables.find(table->GetFullPath());
+	if(tableIter == mTables.end()) return true;     //no files, no assignments
+
+	//place of each variation of the chain, 0 is the requested one
+	map<string, int> variationOrders;
+	const vector<dbkey_t>& chain = GetVariationChain(variation);
+	for(size_t i=0; i<chain.size(); i++)
+	{
+		Variation *chainVariation = GetVariationById(chain[i]);
+		if(chainVariation) variationOrders[chainVariation->GetName()] = static_cast<int>(i);
+	}
+
+	const vector<size_t>& files = tableIter->second.Files;
+	for(size_t i=0; i<files.size(); i++)
+	{
+		const TableFile& file = mFiles[files[i]];
+		map<string, int>::iterator orderIter = variationOrders.find(file.Variation);
+		if(orderIter == variationOrders.end()) continue;
+		if(time > 0 && file.Created > time) continue;
+
+		timeline.AddAssignment(file.Id, file.Id, file.RunMin, file.RunMax, orderIter->second);
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+Assignment* FileDataProvider::MakeAssignment(const TableFile& file, bool full)
+{
+	/** @brief Reads the file to a new assignment
+	 *
+	 * @param full - set run range and variation objects too, as GetAssignments does
+	 * @return new Assignment or NULL if the file can't be read
+	 */
+	vector<string> names, types, cells;
+	if(!ReadTableFile(file.FileName, names, types, cells))
+	{
+		Error(CCDB_ERROR_CONNECTION_EXTERNAL_ERROR, "FileDataProvider::MakeAssignment", "Can't read file '" + file.FileName + "'");
+		return NULL;
+	}
+
+	Assignment *assignment = new Assignment(this, this);
+	assignment->SetId(file.Id);
+	assignment->SetDataVaultId(file.Id);
+	assignment->SetCreatedTime(file.Created);
+	assignment->SetRawData(Assignment::VectorToBlob(cells));
+
+	if(full)
+	{
+		RunRange *runRange = new RunRange(assignment, this);
+		runRange->SetRange(file.RunMin, file.RunMax);
+		assignment->SetRunRange(runRange);
+
+		Variation *variation = new Variation(assignment, this);
+		Variation *known = GetVariation(file.Variation);
+		if(known) variation->SetId(known->GetId());
+		variation->SetName(file.Variation);
+		assignment->SetVariation(variation);
+
+		assignment->SetTypeTable(GetCachedConstantsTypeTable(file.Path));
+	}
+	return assignment;
+}
+
+
+//______________________________________________________________________________
+Assignment* FileDataProvider::GetAssignmentFull( int run, const string& path, const string& variation )
+{
+	if(!CheckConnection("FileDataProvider::GetAssignmentFull")) return NULL;
+	return DataProvider::GetAssignmentFull(run, path, variation);
+}
+
+
+//______________________________________________________________________________
+Assignment* FileDataProvider::GetAssignmentFull( int run, const string& path, int version, const string& variation/*= "default"*/)
+{
+	if(!CheckConnection("FileDataProvider::GetAssignmentFull")) return NULL;
+	return DataProvider::GetAssignmentFull(run, path, version, variation);
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::GetAssignments( vector<Assignment *> &assingments,const string& path, int runMin, int runMax, const string& runRangeName, const string& variation, time_t beginTime, time_t endTime, int sortBy/*=0*/,  int take/*=0*/, int startWith/*=0*/ )
+{
+	ClearErrors(); //Clear error in function that can produce new ones
+	if(!CheckConnection("FileDataProvider::GetAssignments")) return false;
+
+	map<string, TableIndex>::iterator tableIter = mTables.find(path);
+	if(tableIter == mTables.end())
+	{
+		Error(CCDB_ERROR_NO_TYPETABLE, "FileDataProvider::GetAssignments", "Type table was not found");
+		return false;
+	}
+
+	//Ok, lets cleanup result list
+	for(size_t i=0; i<assingments.size(); i++)
+	{
+		if(IsOwner(assingments[i])) delete assingments[i];   //delete objects if this provider is owner
+	}
+	assingments.clear();
+
+	if(runRangeName != "") return true;     //files have no named run ranges
+
+	//newest first, unless sortBy == 1
+	vector<size_t> files = tableIter->second.Files;
+	if(sortBy != 1) reverse(files.begin(), files.end());
+
+	int found = 0;
+	for(size_t i=0; i<files.size(); i++)
+	{
+		const TableFile& file = mFiles[files[i]];
+		if((runMin != 0 || runMax != 0) && (file.RunMin > runMin || file.RunMax < runMax)) continue;
+		if(variation != "" && file.Variation != variation) continue;
+		if((beginTime != 0 || endTime != 0) && (file.Created < beginTime || file.Created > endTime)) continue;
+
+		if(found++ < startWith) continue;
+		Assignment *assignment = MakeAssignment(file, true);
+		if(assignment) assingments.push_back(assignment);
+		if(take > 0 && (int)assingments.size() >= take) break;
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::GetAssignments(vector<Assignment*>& assingments, const string& path, int run, const string& variation, time_t date, int take, int startWith)
+{
+	return GetAssignments(assingments, path, run, run, "", variation, 0, date, 0, take, startWith);
+}
+
+
+//______________________________________________________________________________
+vector<Assignment *> FileDataProvider::GetAssignments( const string& path, int run, const string& variation/*=""*/, time_t date/*=0*/, int take/*=0*/, int startWith/*=0*/ )
+{
+	vector<Assignment *> assingments;
+	GetAssignments(assingments, path, run, variation, date, take, startWith);
+	return assingments;
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::GetAssignments( vector<Assignment *> &assingments,const string& path, const string& runName, const string& variation/*=""*/, time_t date/*=0*/, int take/*=0*/, int startWith/*=0*/ )
+{
+	return GetAssignments(assingments, path, 0, 0, runName, variation, 0, date, 0, take, startWith);
+}
+
+
+//______________________________________________________________________________
+vector<Assignment *> FileDataProvider::GetAssignments( const string& path, const string& runName, const string& variation/*=""*/, time_t date/*=0*/, int take/*=0*/, int startWith/*=0*/ )
+{
+	vector<Assignment *> assingments;
+	GetAssignments(assingments, path, runName, variation, date, take, startWith);
+	return assingments;
+}
+
+
+//______________________________________________________________________________
+bool FileDataProvider::FillAssignment(Assignment* assignment)
+{
+	ClearErrors(); //Clear error in function that can produce new ones
+	if(!CheckConnection("FileDataProvider::FillAssignment")) return false;
+
+	const TableFile *file = assignment ? FindFile(assignment->GetId()) : NULL;
+	if(file == NULL)
+	{
+		Error(CCDB_ERROR_ASSIGMENT_INVALID, "FileDataProvider::FillAssignment", "Assignment is NULL or has improper ID");
+		return false;
+	}
+
+	Assignment *read = MakeAssignment(*file, true);
+	if(read == NULL) return false;
+
+	assignment->SetDataVaultId(read->GetDataVaultId());
+	assignment->SetCreatedTime(read->GetCreatedTime());
+	assignment->SetRawData(read->GetRawData());
+	assignment->SetTypeTable(read->GetTypeTable());
+
+	RunRange *runRange = new RunRange(assignment, this);
+	runRange->SetRange(file->RunMin, file->RunMax);
+	assignment->SetRunRange(runRange);
+
+	Variation *variation = new Variation(assignment, this);
+	variation->SetId(read->GetVariation()->GetId());
+	variation->SetName(file->Variation);
+	assignment->SetVariation(variation);
+
+	delete read;
+	return true;
+}
+
+#pragma endregion Assignments
+
 }
@@ -34,7 +34,6 @@ ccdb::MySQLDataProvider::MySQLDataProvider(void)
 	mDirsAreLoaded = false;
 	mLastFullQuerry="";
 	mLastShortQuerry="";
-    mLastVariation = NULL; 
     
 }
 
@@ -117,9 +116,26 @@ bool ccdb::MySQLDataProvider::Connect(MySQLConnectionInfo connection)
 		return false;
 	}
 	mIsConnected = true;
+
+	//a new session starts in the server time zone
+	if(mTimeZone == cUTCTime) return ApplySessionTimeZone();
 	return true;
 }
 
+
+void ccdb::MySQLDataProvider::SetTimeZone(TimeZones timeZone)
+{
+	DataProvider::SetTimeZone(timeZone);
+	if(IsConnected()) ApplySessionTimeZone();
+}
+
+
+bool ccdb::MySQLDataProvider::ApplySessionTimeZone()
+{
+	//FROM_UNIXTIME and the CURRENT_TIMESTAMP default of `created` use the session time zone
+	return QueryCustom((mTimeZone == cUTCTime)? "SET time_zone = '+00:00';" : "SET time_zone = DEFAULT;");
+}
+
 bool ccdb::MySQLDataProvider::ParseConnectionString(std::string conStr, MySQLConnectionInfo &connection)
 {
 	//first check for uri type
@@ -712,6 +728,92 @@ bool ccdb::MySQLDataProvider::LoadColumns( ConstantsTypeTable* table )
 
 	return true;
 }
+
+//______________________________________________________________________________
+bool ccdb::MySQLDataProvider::LoadConstantsTypeTables(const vector<string>& paths)
+{
+	if(!CheckConnection("MySQLDataProvider::LoadConstantsTypeTables(const vector<string>& paths)")) return false;
+
+	set<string> uncachedPaths;
+	vector<dbkey_t> directoryIds;
+	SelectUncachedTypeTables(paths, uncachedPaths, directoryIds);
+	if(uncachedPaths.empty()) return true;
+
+	//select all tables of the directories, keep only the requested ones
+	string query = 
+		"SELECT `id`, UNIX_TIMESTAMP(`created`) as `created`, UNIX_TIMESTAMP(`modified`) as `modified`, `name`, `directoryId`, `nRows`, `nColumns`, `comment` "
+		"FROM `typeTables` WHERE `directoryId` IN (" + PrepareIdListInsertion(directoryIds) + ")";
+
+	if(!QuerySelect(query))
+	{
+		return false;
+	}
+
+	map<dbkey_t, ConstantsTypeTable *> tablesById;
+	while(FetchRow())
+	{
+		map<dbkey_t, Directory *>::iterator dirIter = mDirectoriesById.find(ReadIndex(4));
+		if(dirIter == mDirectoriesById.end()) continue;
+		string fullPath = PathUtils::CombinePath(dirIter->second->GetFullPath(), ReadString(3));
+		if(uncachedPaths.find(fullPath) == uncachedPaths.end()) continue;
+
+		ConstantsTypeTable *table = new ConstantsTypeTable(this, this);
+		table->SetId(ReadULong(0));
+		table->SetCreatedTime(ReadUnixTime(1));
+		table->SetModifiedTime(ReadUnixTime(2));
+		table->SetName(ReadString(3));
+		table->SetDirectoryId(ReadULong(4));
+		table->SetNRows(ReadInt(5));
+		table->SetNColumnsFromDB(ReadInt(6));
+		table->SetComment(ReadString(7));
+		table->SetDirectory(dirIter->second);
+		table->SetFullPath(fullPath);
+		SetObjectLoaded(table); //set object flags that it was just loaded from DB
+
+		tablesById[table->GetId()] = table;
+	}
+	FreeMySQLResult();
+	if(tablesById.empty()) return true;
+
+	//columns of all selected tables
+	vector<dbkey_t> tableIds;
+	for(map<dbkey_t, ConstantsTypeTable *>::iterator iter = tablesById.begin(); iter != tablesById.end(); ++iter)
+	{
+		tableIds.push_back(iter->first);
+	}
+
+	query = 
+		"SELECT `id`, UNIX_TIMESTAMP(`created`) as `created`, UNIX_TIMESTAMP(`modified`) as `modified`, `name`, `columnType`, `comment`, `typeId` "
+		"FROM `columns` WHERE `typeId` IN (" + PrepareIdListInsertion(tableIds) + ") ORDER BY `typeId`, `order`";
+
+	if(!QuerySelect(query))
+	{
+		return false;
+	}
+
+	while(FetchRow())
+	{
+		ConstantsTypeTable *table = tablesById[ReadIndex(6)];
+		ConstantsTypeColumn *column = new ConstantsTypeColumn(table, this);
+		column->SetId(ReadULong(0));
+		column->SetCreatedTime(ReadUnixTime(1));
+		column->SetModifiedTime(ReadUnixTime(2));
+		column->SetName(ReadString(3));
+		column->SetType(ReadString(4));
+		column->SetComment(ReadString(5));
+		column->SetDBTypeTableId(table->GetId());
+		SetObjectLoaded(column); //set object flags that it was just loaded from DB
+		table->AddColumn(column);
+	}
+	FreeMySQLResult();
+
+	//the tables are complete only now
+	for(map<dbkey_t, ConstantsTypeTable *>::iterator iter = tablesById.begin(); iter != tablesById.end(); ++iter)
+	{
+		mTypeTablesByPath[iter->second->GetFullPath()] = iter->second;
+	}
+	return true;
+}
 #pragma endregion Type Tables
 
 #pragma region Run ranges
@@ -990,78 +1092,37 @@ vector<Variation *> ccdb::MySQLDataProvider::GetVariations( ConstantsTypeTable *
 }
 
 
-Variation* ccdb::MySQLDataProvider::GetVariation( const string& name )
-{
-	ClearErrors(); //Clear error in function that can produce new ones
-    if(mLastVariation!=NULL && mLastVariation->GetName()==name) return mLastVariation;
-
-    return SelectVariation("`name`= \"" + name + "\"");
-}
-
-/** @brief Load variation by name
-* 
-* @param     const char * name
-* @return   DVariation*
-*/
-Variation* ccdb::MySQLDataProvider::GetVariationById(int id)
-{
-    if(mVariationsById.find(id) != mVariationsById.end()) return mVariationsById[id];
-    
-    ClearErrors(); //Clear error in function that can produce new ones
-    return SelectVariation("`id`= " + StringUtils::IntToString(id) + "");
-}
-
-/**
-* Get variation by database request
-*/
-Variation* ccdb::MySQLDataProvider::SelectVariation(const string& whereClause)
+bool ccdb::MySQLDataProvider::LoadVariations()
 {
-    //TODO: Implement method
-    string query = "SELECT `id`, UNIX_TIMESTAMP(`created`) as `created`, UNIX_TIMESTAMP(`modified`) as `modified`, `name`, `description`, `comment`, `parentId`"
-        " FROM `variations` WHERE "+whereClause+";";
+	if(!CheckConnection("MySQLDataProvider::LoadVariations()")) return false;
 
-    //query this
-    if(!QuerySelect(query))
+    if(!QuerySelect("SELECT `id`, UNIX_TIMESTAMP(`created`) as `created`, UNIX_TIMESTAMP(`modified`) as `modified`, `name`, `description`, `comment`, `parentId` FROM `variations`"))
     {
         //TODO report error
-        return NULL;
+        return false;
     }
 
-    //Ok! We queried our run range! lets catch it! 
-    if(!FetchRow())
-    {
-        //nothing was selected
-        return NULL;
-    }
+    mVariationsById.clear();
 
-    //ok lets read the data...
-    Variation *result = new Variation(this, this);
-    result->SetId(ReadULong(0));
-    result->SetCreatedTime(ReadUnixTime(1));
-    result->SetModifiedTime(ReadUnixTime(2));
-    result->SetName(ReadString(3));
-    result->SetDescription(ReadString(4));
-    result->SetComment(ReadString(5));
-    result->SetParentDbId(ReadULong(6));
-
-    if(mReturnedRowsNum>1)
+    //Ok! We queried our variations! lets catch them! 
+    while(FetchRow())
     {
-        //TODO warning not uniq row
+        Variation *variation = new Variation(this, this);
+        variation->SetId(ReadULong(0));
+        variation->SetCreatedTime(ReadUnixTime(1));
+        variation->SetModifiedTime(ReadUnixTime(2));
+        variation->SetName(ReadString(3));
+        variation->SetDescription(ReadString(4));
+        variation->SetComment(ReadString(5));
+        variation->SetParentDbId(ReadULong(6));
+
+        mVariationsById[variation->GetId()] = variation;
     }
 
-    result->SetOwner(this, true);
-
-    mVariationsById[result->GetId()] = result;
-    mLastVariation = result;
     FreeMySQLResult();
 
-    //Get parent recursively
-    if(result->GetParentDbId()!=0)
-    {
-        result->SetParent(GetVariationById(result->GetParentDbId()));
-    }
-
-    return result;
+    BuildVariationDependencies();
+    return true;
 }
 
 
@@ -1088,7 +1149,7 @@ Assignment* ccdb::MySQLDataProvider::GetAssignmentShort(int run, const string& p
 }
 
 
-Assignment* ccdb::MySQLDataProvider::GetAssignmentShort(int run, const string& path, time_t time, const string& variationName, bool loadColumns /*=false*/)
+Assignment* ccdb::MySQLDataProvider::GetAssignmentShort(int run, const string& path, time_t time, const string& variationName, bool /*loadColumns =false*/)
 {
     /** @brief Get specified by creation time version of Assignment with data blob only.
      *
@@ -1099,6 +1160,7 @@ Assignment* ccdb::MySQLDataProvider::GetAssignmentShort(int run, const string& p
      * @param [in] path - object path
      * @param [in] time - timestamp, data that is equal or earlier in time than that timestamp is returned
      * @param [in] variation - variation name
+     * @param [in] loadColumns - ignored, the type table comes from the cache of the provider with its columns
      * @return new DAssignment object or 
      */
 
@@ -1106,9 +1168,8 @@ Assignment* ccdb::MySQLDataProvider::GetAssignmentShort(int run, const string& p
 
 	if(!CheckConnection("MySQLDataProvider::GetAssignmentShort( int run, const char* path, const char* variation, int version /*= -1*/ )")) return NULL;
 	        
-    //Get directory. Directories should be cached. So this doesn't make a database request
-    
-    ConstantsTypeTable *table = GetConstantsTypeTable(path, loadColumns);
+    //Get type table. It is cached by the provider and shared between assignments
+    ConstantsTypeTable *table = GetCachedConstantsTypeTable(path);
     if(!table)
     {
         Error(CCDB_ERROR_NO_TYPETABLE, "MySQLDataProvider::GetAssignmentShort", "Type table was not found: '"+path+"'" );
@@ -1126,78 +1187,223 @@ Assignment* ccdb::MySQLDataProvider::GetAssignmentShort(int run, const string& p
         return NULL;
     }
 
-    //run number to string
-    string runStr = StringUtils::IntToString(run);
+    //The effective assignment of the run is found in the cached timeline of the table,
+    //so only the data blob is read from the database
+    const AssignmentTimeline *timeline = GetAssignmentTimeline(table, variation, time);
+    if(!timeline) return NULL;
 
-	//ok now we must build our mighty query...
-	string query=
-        "SELECT `assignments`.`id` AS `asId`, "
-        "`constantSets`.`vault` AS `blob` "
-        "FROM  `assignments` "
-        "USE INDEX (id_UNIQUE) "
-        "INNER JOIN `runRanges` ON `assignments`.`runRangeId`= `runRanges`.`id` "
-        "INNER JOIN `constantSets` ON `assignments`.`constantSetId` = `constantSets`.`id` "
-        "INNER JOIN `typeTables` ON `constantSets`.`constantTypeId` = `typeTables`.`id` "
-        "WHERE  `runRanges`.`runMin` <= '"+runStr+"' "
-        "AND `runRanges`.`runMax` >= '"+runStr+"' "
-        "AND `assignments`.`variationId`= '"+StringUtils::IntToString(variation->GetId())+"' "
-        "AND `constantSets`.`constantTypeId` ='"+StringUtils::IntToString(table->GetId())+"' ";
-    
-    //time in querY?
-    if(time>0)
+    const AssignmentTimeline::Interval *interval = timeline->Find(run);
+    if(!interval)
     {
-        char timeBuf[32];
-        sprintf(timeBuf,"%lu",time);
-        query=query + "AND UNIX_TIMESTAMP(`assignments`.`created`) <= '"+string(timeBuf)+"' ";
+		Error(CCDB_ERROR_NO_ASSIGMENT,"MySQLDataProvider::GetAssignmentShort(int, const string&, time_t, const string&)", 
+            StringUtils::Format("No data was selected. Table '%s' for run='%i', timestampt='%lu' and variation='%s' ", path.c_str(), run, time, variationName.c_str()));
+		return NULL;
     }
 
-    //finish query 
-    query = query + "ORDER BY `assignments`.`id` DESC LIMIT 1 ";
-	
-	//query this
+	string query = "SELECT `vault` FROM `constantSets` WHERE `id` = '"+StringUtils::IntToString(interval->ConstantSetId)+"'";
 	if(!QuerySelect(query))
 	{
 		//TODO report error
 		return NULL;
 	}
 
-    //If We have not found data for this variation, getting data for parent variation
-    if(mReturnedRowsNum==0 && variation->GetParentDbId()!=0)
-    {
-        delete table;
-		return GetAssignmentShort(run, path, time, variation->GetParent()->GetName(), loadColumns);
-    }
-
-	//Ok! We queried our run range! lets catch it! 
 	if(!FetchRow())
 	{
 		Error(CCDB_ERROR_NO_ASSIGMENT,"MySQLDataProvider::GetAssignmentShort(int, const string&, time_t, const string&)", 
             StringUtils::Format("No data was selected. Table '%s' for run='%i', timestampt='%lu' and variation='%s' ", path.c_str(), run, time, variationName.c_str()));
+		FreeMySQLResult();
 		return NULL;
 	}
 
 	//ok lets read the data...
 	Assignment *result = new Assignment(this, this);
-	result->SetId( ReadIndex(0) );
-	result->SetRawData( ReadString(1) );
+	result->SetId( interval->AssignmentId );
+	result->SetRawData( ReadString(0) );
 	
 	//additional fill
 	result->SetRequestedRun(run);
+	result->SetValidRuns(interval->RunMin, interval->RunMax);
 	result->SetVariationId(variation->GetId());
 	
     //type table
     result->SetTypeTable(table);
-    result->BeOwner(table);
-    table->SetOwner(result);
 
-	if(mReturnedRowsNum>1)
+	FreeMySQLResult();
+	return result;
+
+}
+
+//______________________________________________________________________________
+bool ccdb::MySQLDataProvider::LoadAssignmentTimeline(AssignmentTimeline& timeline, ConstantsTypeTable* table, Variation* variation, time_t time)
+{
+	if(!CheckConnection("MySQLDataProvider::LoadAssignmentTimeline(AssignmentTimeline& timeline, ConstantsTypeTable* table, Variation* variation, time_t time)")) return false;
+
+    //Assignments of the variation and of its parents. The variation order is selected
+    //as the first column, so the timeline knows which of them is the nearest
+    string variationWhere, variationOrder;
+    PrepareVariationChainInsertion(variation, "`assignments`.`variationId`", variationWhere, variationOrder);
+
+	string query=
+        "SELECT "+variationOrder+", `assignments`.`id`, `assignments`.`constantSetId`, `runRanges`.`runMin`, `runRanges`.`runMax` "
+        "FROM  `assignments` "
+        "INNER JOIN `runRanges` ON `assignments`.`runRangeId`= `runRanges`.`id` "
+        "INNER JOIN `constantSets` ON `assignments`.`constantSetId` = `constantSets`.`id` "
+        "WHERE  `constantSets`.`constantTypeId` ='"+StringUtils::IntToString(table->GetId())+"' "
+        "AND "+variationWhere+" ";
+
+    //time in querY?
+    if(time>0)
+    {
+        //created is compared as is, so an index on it is used
+        char timeBuf[32];
+        sprintf(timeBuf,"%lu",time);
+        query=query + "AND `assignments`.`created` <= FROM_UNIXTIME('"+string(timeBuf)+"') ";
+    }
+
+	if(!QuerySelect(query))
 	{
-		//TODO warning not uniq row
+		return false;
+	}
+
+	while(FetchRow())
+	{
+		timeline.AddAssignment(ReadIndex(1), ReadIndex(2), ReadInt(3), ReadInt(4), ReadInt(0));
 	}
 
 	FreeMySQLResult();
-	return result;
+	return true;
+}
+
+//______________________________________________________________________________
+bool ccdb::MySQLDataProvider::GetAssignmentsShort(map<string, Assignment*>& assignments, int run, const vector<string>& paths, time_t time/*=0*/, const string& variationName/*="default"*/)
+{
+	ClearErrors(); //Clear error in function that can produce new ones
+
+	if(!CheckConnection("MySQLDataProvider::GetAssignmentsShort(map<string, Assignment*>& assignments, int run, const vector<string>& paths, time_t time, const string& variation)")) return false;
+	if(paths.empty()) return true;
+
+	Variation* variation = GetVariation(variationName);
+	if(!variation)
+	{
+		Error(CCDB_ERROR_VARIATION_INVALID,"MySQLDataProvider::GetAssignmentsShort", "No variation '"+variationName+"' was found");
+		return false;
+	}
+
+	if(!LoadConstantsTypeTables(paths)) return false;
+
+	//type tables by id. Not existing tables are skipped, like GetAssignmentShort returns NULL for them
+	map<dbkey_t, ConstantsTypeTable *> tablesById;
+	map<dbkey_t, string> pathsById;
+	vector<dbkey_t> tableIds;
+	for(size_t i=0; i<paths.size(); i++)
+	{
+		map<string, ConstantsTypeTable *>::iterator iter = mTypeTablesByPath.find(paths[i]);
+		if(iter == mTypeTablesByPath.end()) continue;
+		if(tablesById.find(iter->second->GetId()) != tablesById.end()) continue;
+		tablesById[iter->second->GetId()] = iter->second;
+		pathsById[iter->second->GetId()] = paths[i];
+		tableIds.push_back(iter->second->GetId());
+	}
+	if(tableIds.empty()) return true;
+
+	string variationWhere, variationOrder;
+	PrepareVariationChainInsertion(variation, "`assignments`.`variationId`", variationWhere, variationOrder);
 
+	//The best assignment of each table goes first. Only ids are selected, so
+	//skipped older assignments don't cost reading their data blobs
+	string runStr = StringUtils::IntToString(run);
+	string selectWhat=
+		"SELECT `constantSets`.`constantTypeId`, `assignments`.`id`, `assignments`.`constantSetId`, "
+		"`runRanges`.`runMin`, `runRanges`.`runMax`, "+variationOrder+" "
+		"FROM  `assignments` "
+		"INNER JOIN `runRanges` ON `assignments`.`runRangeId`= `runRanges`.`id` "
+		"INNER JOIN `constantSets` ON `assignments`.`constantSetId` = `constantSets`.`id` ";
+	string commonWhere=
+		"AND "+variationWhere+" "
+		"AND `constantSets`.`constantTypeId` IN ("+PrepareIdListInsertion(tableIds)+") ";
+
+	if(time>0)
+	{
+		//created is compared as is, so an index on it is used
+		char timeBuf[32];
+		sprintf(timeBuf,"%lu",time);
+		commonWhere=commonWhere + "AND `assignments`.`created` <= FROM_UNIXTIME('"+string(timeBuf)+"') ";
+	}
+	string query=
+		selectWhat +
+		"WHERE  `runRanges`.`runMin` <= '"+runStr+"' "
+		"AND `runRanges`.`runMax` >= '"+runStr+"' " +
+		commonWhere +
+		"ORDER BY `constantSets`.`constantTypeId`, "+variationOrder+", `assignments`.`id` DESC";
+
+	if(!QuerySelect(query))
+	{
+		return false;
+	}
+
+	map<dbkey_t, dbkey_t> assignmentIdByTableId;
+	map<dbkey_t, dbkey_t> tableIdBySetId;
+	vector<dbkey_t> setIds;
+	map<dbkey_t, AssignmentTimeline> timelinesByTableId;
+	map<dbkey_t, pair<int, int> > runRangesByTableId;
+	while(FetchRow())
+	{
+		dbkey_t tableId = ReadIndex(0);
+		if(assignmentIdByTableId.find(tableId) != assignmentIdByTableId.end()) continue;
+		assignmentIdByTableId[tableId] = ReadIndex(1);
+		tableIdBySetId[ReadIndex(2)] = tableId;
+		setIds.push_back(ReadIndex(2));
+		timelinesByTableId[tableId].AddAssignment(ReadIndex(1), ReadIndex(2), ReadInt(3), ReadInt(4), ReadInt(5));
+		runRangesByTableId[tableId] = pair<int, int>(ReadInt(3), ReadInt(4));
+	}
+	FreeMySQLResult();
+	if(setIds.empty()) return true;
+
+	//The valid runs of a found assignment are its run range, minus the parts where other
+	//assignments win. Assignments of the run lose everywhere, so only those that don't
+	//include the run but overlap the run range can end the span. @see GetAssignmentShort
+	query=
+		selectWhat +
+		"WHERE  (`runRanges`.`runMax` < '"+runStr+"' OR `runRanges`.`runMin` > '"+runStr+"') " +
+		commonWhere +
+		"AND "+PrepareRunOverlapInsertion(runRangesByTableId);
+
+	if(!QuerySelect(query))
+	{
+		return false;
+	}
+
+	while(FetchRow())
+	{
+		timelinesByTableId[ReadIndex(0)].AddAssignment(ReadIndex(1), ReadIndex(2), ReadInt(3), ReadInt(4), ReadInt(5));
+	}
+	FreeMySQLResult();
+
+	//data blobs of the selected assignments
+	if(!QuerySelect("SELECT `id`, `vault` FROM `constantSets` WHERE `id` IN (" + PrepareIdListInsertion(setIds) + ")"))
+	{
+		return false;
+	}
+
+	while(FetchRow())
+	{
+		dbkey_t tableId = tableIdBySetId[ReadIndex(0)];
+		Assignment *assignment = new Assignment(this, this);
+		assignment->SetId(assignmentIdByTableId[tableId]);
+		assignment->SetRawData(ReadString(1));
+		assignment->SetRequestedRun(run);
+		assignment->SetVariationId(variation->GetId());
+		assignment->SetTypeTable(tablesById[tableId]);
+		assignments[pathsById[tableId]] = assignment;
+
+		AssignmentTimeline &timeline = timelinesByTableId[tableId];
+		timeline.Build();
+		const AssignmentTimeline::Interval *interval = timeline.Find(run);
+		if(interval) assignment->SetValidRuns(interval->RunMin, interval->RunMax);
+	}
+	FreeMySQLResult();
+
+	return true;
 }
 
 Assignment* ccdb::MySQLDataProvider::GetAssignmentFull( int run, const string& path, const string& variation )
@@ -1496,6 +1702,88 @@ void ccdb::MySQLDataProvider::FetchAssignment(Assignment* assignment, ConstantsT
 	if(IsOwner(table)) table->SetOwner(assignment);
 }
 
+
+bool ccdb::MySQLDataProvider::CreateAssignments(const vector<Assignment *>& assignments)
+{
+	if(!CheckConnection("MySQLDataProvider::CreateAssignments")) return false;
+
+	for(size_t i=0; i<assignments.size(); i++)
+	{
+		if(!CheckNewAssignment(assignments[i], "MySQLDataProvider::CreateAssignments")) return false;
+	}
+
+	if(!QueryCustom("START TRANSACTION;")) return false;
+
+	for(size_t i=0; i<assignments.size(); i++)
+	{
+		if(!InsertAssignment(assignments[i]))
+		{
+			QueryCustom("ROLLBACK;");
+			for(size_t j=0; j<=i; j++) assignments[j]->SetId(0);
+			return false;
+		}
+	}
+
+	if(!QueryCustom("COMMIT;"))
+	{
+		QueryCustom("ROLLBACK;");
+		for(size_t i=0; i<assignments.size(); i++) assignments[i]->SetId(0);
+		return false;
+	}
+
+	//timelines built before don't have the new assignments
+	InvalidateAssignmentTimelines();
+	return true;
+}
+
+
+bool ccdb::MySQLDataProvider::InsertAssignment(Assignment* assignment)
+{
+	RunRange *runRange = assignment->GetRunRange();
+	string author = StringUtils::Format("COALESCE((SELECT `id` FROM `users` WHERE `name` = %s), 1)", PrepareStringForInsert(mLogUserName).c_str());
+
+	//the run range without a name, it is added if there is none
+	string query = StringUtils::Format("SELECT `id` FROM `runRanges` WHERE `runMin` = '%i' AND `runMax` = '%i' AND (`name` IS NULL OR `name` = '') LIMIT 1;",
+		runRange->GetMin(), runRange->GetMax());
+	if(!QuerySelect(query)) return false;
+
+	dbkey_t runRangeId = FetchRow() ? ReadIndex(0) : 0;
+	FreeMySQLResult();
+	if(runRangeId <= 0)
+	{
+		query = StringUtils::Format("INSERT INTO `runRanges` (`runMin`, `runMax`, `name`) VALUES ('%i', '%i', '');",
+			runRange->GetMin(), runRange->GetMax());
+		if(!QueryCustom(query)) return false;
+		runRangeId = static_cast<dbkey_t>(mysql_insert_id(mMySQLHnd));
+	}
+	runRange->SetId(runRangeId);
+
+	query = "INSERT INTO `constantSets` (`vault`, `constantTypeId`) VALUES (" + PrepareStringForInsert(assignment->GetRawData()) +
+		StringUtils::Format(", '%i');", assignment->GetTypeTable()->GetId());
+	if(!QueryCustom(query)) return false;
+	dbkey_t constantSetId = static_cast<dbkey_t>(mysql_insert_id(mMySQLHnd));
+
+	query = StringUtils::Format("INSERT INTO `assignments` (`variationId`, `runRangeId`, `constantSetId`, `authorId`, `comment`) VALUES ('%i', '%i', '%i', %s, %s);",
+		assignment->GetVariation()->GetId(), runRangeId, constantSetId, author.c_str(),
+		assignment->GetComment().empty() ? "NULL" : PrepareStringForInsert(assignment->GetComment()).c_str());
+	if(!QueryCustom(query)) return false;
+	mLastInsertedId = mysql_insert_id(mMySQLHnd);
+
+	assignment->SetId(static_cast<dbkey_t>(mLastInsertedId));
+	assignment->SetDataVaultId(constantSetId);
+	assignment->SetRunRangeId(runRangeId);
+	assignment->SetVariationId(assignment->GetVariation()->GetId());
+	assignment->SetCreatedTime(time(NULL));
+
+	//the same log record the python tools add
+	string description = StringUtils::Format("Created assignment '%s:%i-%i:%s'", assignment->GetTypeTable()->GetFullPath().c_str(),
+		runRange->GetMin(), runRange->GetMax(), assignment->GetVariation()->GetName().c_str());
+	query = StringUtils::Format("INSERT INTO `logs` (`affectedIds`, `action`, `description`, `comment`, `authorId`) VALUES ('assignments_%i', 'create', %s, %s, %s);",
+		(int)mLastInsertedId, PrepareStringForInsert(description).c_str(),
+		assignment->GetComment().empty() ? "NULL" : PrepareStringForInsert(assignment->GetComment()).c_str(), author.c_str());
+	return QueryCustom(query);
+}
+
 #pragma endregion Assignment
 
 #pragma region Misc
@@ -1545,6 +1833,18 @@ std::string ccdb::MySQLDataProvider::PrepareCommentForInsert( const string& comm
 
 }
 
+std::string ccdb::MySQLDataProvider::PrepareStringForInsert( const string& str )
+{
+	//mysql_real_escape_string needs a buffer of 2*length+1 bytes
+	vector<char> buffer(str.length()*2 + 1);
+	unsigned long length = mysql_real_escape_string(mMySQLHnd, &buffer[0], str.data(), str.length());
+
+	string result("'");
+	result.append(&buffer[0], length);
+	result.append("'");
+	return result;
+}
+
 #pragma endregion Misc
 
 #pragma region MySQL_Field_Operations
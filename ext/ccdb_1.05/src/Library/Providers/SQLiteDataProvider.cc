@@ -23,9 +23,9 @@ using namespace ccdb;
 ccdb::SQLiteDataProvider::SQLiteDataProvider(void)
 {
 	mIsConnected = false;
+	mIsReadOnly = false;
 	mDatabase=NULL;
 	mStatement=NULL;
-    mLastVariation = NULL;
 	mRootDir = new Directory(this, this);
 	mDirsAreLoaded = false;
 }
@@ -70,7 +70,9 @@ bool ccdb::SQLiteDataProvider::Connect( std::string connectionString )
 	Log::Verbose("ccdb::SQLiteDataProvider::Connect", StringUtils::Format("Connecting to database:\n %s", connectionString.c_str()));
 	
 	//Try to open sqlite database
-	int result = sqlite3_open(connectionString.c_str(), &mDatabase);
+	int result = mIsReadOnly ?
+		sqlite3_open_v2(connectionString.c_str(), &mDatabase, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, NULL) :
+		sqlite3_open(connectionString.c_str(), &mDatabase);
 
 	if (result != SQLITE_OK) 
 	{
@@ -95,6 +97,7 @@ void ccdb::SQLiteDataProvider::Disconnect()
 	if(IsConnected())
 	{
 //		FreeSQLiteResult();	//it would free the result or do nothing
+		FinalizeCachedStatements();
 		
 		sqlite3_close(mDatabase);
 		mDatabase = NULL;
@@ -302,26 +305,20 @@ ConstantsTypeTable * ccdb::SQLiteDataProvider::GetConstantsTypeTable( const stri
 	// prepare the SQL statement from the command line
 	//sqlite3_finalize(mStatement);
 	//int result = sqlite3_prepare_v2(mDatabase,"SELECT `id`, strftime('%s', created , 'localtime') as `created`, strftime('%s', modified , 'localtime') as `modified`, `name`, `directoryId`, `nRows`, `nColumns`, `comments` FROM `typeTables` WHERE `name` = '?1' AND `directoryId` = ?2", -1, &mStatement, 0);
-	int result = sqlite3_prepare_v2(mDatabase,"SELECT `id`, strftime('%s', created , 'localtime') as `created`, strftime('%s', modified , 'localtime') as `modified`, `name`, `directoryId`, `nRows`, `nColumns`, `comment` FROM `typeTables`WHERE `name` = ?1 AND `directoryId` = ?2", -1, &mStatement, 0);
-	if( result )
-	{
-		ComposeSQLiteError("SQLiteDataProvider::GetConstantsTypeTable");
-		sqlite3_finalize(mStatement);
-		return NULL;
-	}
+	if(!GetCachedStatement("SELECT `id`, strftime('%s', created , 'localtime') as `created`, strftime('%s', modified , 'localtime') as `modified`, `name`, `directoryId`, `nRows`, `nColumns`, `comment` FROM `typeTables`WHERE `name` = ?1 AND `directoryId` = ?2", "SQLiteDataProvider::GetConstantsTypeTable")) return NULL;
 
-	result = sqlite3_bind_text(mStatement, 1, name.c_str(), -1, SQLITE_TRANSIENT); /*`name`*/
+	int result = sqlite3_bind_text(mStatement, 1, name.c_str(), -1, SQLITE_TRANSIENT); /*`name`*/
 	if( result )
 	{
 		ComposeSQLiteError("SQLiteDataProvider::GetConstantsTypeTable");
-		sqlite3_finalize(mStatement);
+		ReleaseStatement();
 		return NULL;
 	}
-	sqlite3_bind_int(mStatement, 2, parentDir->GetId()); /*`directoryId`*/
+	result = sqlite3_bind_int(mStatement, 2, parentDir->GetId()); /*`directoryId`*/
 	if( result )
 	{
 		ComposeSQLiteError("SQLiteDataProvider::GetConstantsTypeTable");
-		sqlite3_finalize(mStatement);
+		ReleaseStatement();
 		return NULL;
 	}
 
@@ -358,7 +355,7 @@ ConstantsTypeTable * ccdb::SQLiteDataProvider::GetConstantsTypeTable( const stri
 				//TODO error, name should be not null and not empty
 				Error(CCDB_ERROR_TYPETABLE_HAS_NO_NAME,"SQLiteDataProvider::GetConstantsTypeTable", "");
 				delete table;
-				sqlite3_finalize(mStatement);
+				ReleaseStatement();
 				return NULL;
 			}
 				
@@ -380,8 +377,8 @@ ConstantsTypeTable * ccdb::SQLiteDataProvider::GetConstantsTypeTable( const stri
 	}
 	while(result==SQLITE_ROW );
 
-	// finalize the statement to release resources
-	sqlite3_finalize(mStatement);
+	// reset the statement to release resources
+	ReleaseStatement();
 
 	//load columns if needed
 	if(loadColumns && table) LoadColumns(table);
@@ -619,19 +616,13 @@ bool ccdb::SQLiteDataProvider::LoadColumns( ConstantsTypeTable* table )
 	}
 
 	// prepare the SQL statement from the command line
-	int result = sqlite3_prepare_v2(mDatabase, "SELECT `id`, strftime('%s', created , 'localtime') as `created`, strftime('%s', modified , 'localtime') as `modified`, `name`, `columnType`, `comment` FROM `columns` WHERE `typeId` = ?1 ORDER BY `order`;", -1, &mStatement, 0);
-	if( result )
-	{
-		ComposeSQLiteError("ccdb::SQLiteDataProvider::LoadColumns");
-		sqlite3_finalize(mStatement);
-		return false;
-	}
+	if(!GetCachedStatement("SELECT `id`, strftime('%s', created , 'localtime') as `created`, strftime('%s', modified , 'localtime') as `modified`, `name`, `columnType`, `comment` FROM `columns` WHERE `typeId` = ?1 ORDER BY `order`;", "ccdb::SQLiteDataProvider::LoadColumns")) return false;
 
-	result = sqlite3_bind_int(mStatement, 1, table->GetId());	/*`directoryId`*/
+	int result = sqlite3_bind_int(mStatement, 1, table->GetId());	/*`directoryId`*/
 	if( result )
 	{
 		ComposeSQLiteError("ccdb::SQLiteDataProvider::LoadColumns");
-		sqlite3_finalize(mStatement);
+		ReleaseStatement();
 		return false;
 	}
 
@@ -668,8 +659,105 @@ bool ccdb::SQLiteDataProvider::LoadColumns( ConstantsTypeTable* table )
 	}
 	while(result==SQLITE_ROW );
 
-	// finalize the statement to release resources
+	// reset the statement to release resources
+	ReleaseStatement();
+	return true;
+}
+
+
+bool ccdb::SQLiteDataProvider::LoadConstantsTypeTables(const vector<string>& paths)
+{
+	char thisFunc[] = "ccdb::SQLiteDataProvider::LoadConstantsTypeTables(const vector<string>& paths)";
+	if(!CheckConnection(thisFunc)) return false;
+
+	set<string> uncachedPaths;
+	vector<dbkey_t> directoryIds;
+	SelectUncachedTypeTables(paths, uncachedPaths, directoryIds);
+	if(uncachedPaths.empty()) return true;
+
+	//select all tables of the directories, keep only the requested ones
+	string query = 
+		"SELECT `id`, strftime('%s', created , 'localtime') as `created`, strftime('%s', modified , 'localtime') as `modified`, `name`, `directoryId`, `nRows`, `nColumns`, `comment` "
+		"FROM `typeTables` WHERE `directoryId` IN (" + PrepareIdListInsertion(directoryIds) + ")";
+
+	int result = sqlite3_prepare_v2(mDatabase, query.c_str(), -1, &mStatement, 0);
+	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return false; }
+	mQueryColumns = sqlite3_column_count(mStatement);
+
+	map<dbkey_t, ConstantsTypeTable *> tablesById;
+	do
+	{
+		result = sqlite3_step(mStatement);
+		if(result != SQLITE_ROW) break;
+
+		map<dbkey_t, Directory *>::iterator dirIter = mDirectoriesById.find(ReadIndex(4));
+		if(dirIter == mDirectoriesById.end()) continue;
+		string fullPath = PathUtils::CombinePath(dirIter->second->GetFullPath(), ReadString(3));
+		if(uncachedPaths.find(fullPath) == uncachedPaths.end()) continue;
+
+		ConstantsTypeTable *table = new ConstantsTypeTable(this, this);
+		table->SetId(ReadULong(0));
+		table->SetCreatedTime(ReadUnixTime(1));
+		table->SetModifiedTime(ReadUnixTime(2));
+		table->SetName(ReadString(3));
+		table->SetDirectoryId(ReadULong(4));
+		table->SetNRows(ReadInt(5));
+		table->SetNColumnsFromDB(ReadInt(6));
+		table->SetComment(ReadString(7));
+		table->SetDirectory(dirIter->second);
+		table->SetFullPath(fullPath);
+		SetObjectLoaded(table); //set object flags that it was just loaded from DB
+
+		tablesById[table->GetId()] = table;
+	}
+	while(true);
+
+	sqlite3_finalize(mStatement);
+	if(result != SQLITE_DONE) { ComposeSQLiteError(thisFunc); return false; }
+	if(tablesById.empty()) return true;
+
+	//columns of all selected tables
+	vector<dbkey_t> tableIds;
+	for(map<dbkey_t, ConstantsTypeTable *>::iterator iter = tablesById.begin(); iter != tablesById.end(); ++iter)
+	{
+		tableIds.push_back(iter->first);
+	}
+
+	query = 
+		"SELECT `id`, strftime('%s', created , 'localtime') as `created`, strftime('%s', modified , 'localtime') as `modified`, `name`, `columnType`, `comment`, `typeId` "
+		"FROM `columns` WHERE `typeId` IN (" + PrepareIdListInsertion(tableIds) + ") ORDER BY `typeId`, `order`";
+
+	result = sqlite3_prepare_v2(mDatabase, query.c_str(), -1, &mStatement, 0);
+	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return false; }
+	mQueryColumns = sqlite3_column_count(mStatement);
+
+	do
+	{
+		result = sqlite3_step(mStatement);
+		if(result != SQLITE_ROW) break;
+
+		ConstantsTypeTable *table = tablesById[ReadIndex(6)];
+		ConstantsTypeColumn *column = new ConstantsTypeColumn(table, this);
+		column->SetId(ReadULong(0));
+		column->SetCreatedTime(ReadUnixTime(1));
+		column->SetModifiedTime(ReadUnixTime(2));
+		column->SetName(ReadString(3));
+		column->SetType(ReadString(4));
+		column->SetComment(ReadString(5));
+		column->SetDBTypeTableId(table->GetId());
+		SetObjectLoaded(column); //set object flags that it was just loaded from DB
+		table->AddColumn(column);
+	}
+	while(true);
+
 	sqlite3_finalize(mStatement);
+	if(result != SQLITE_DONE) { ComposeSQLiteError(thisFunc); return false; }
+
+	//the tables are complete only now
+	for(map<dbkey_t, ConstantsTypeTable *>::iterator iter = tablesById.begin(); iter != tablesById.end(); ++iter)
+	{
+		mTypeTablesByPath[iter->second->GetFullPath()] = iter->second;
+	}
 	return true;
 }
 
@@ -958,117 +1046,48 @@ vector<Variation *> ccdb::SQLiteDataProvider::GetVariations( ConstantsTypeTable
 
 
 
-Variation* ccdb::SQLiteDataProvider::GetVariation( const string& name )
+bool ccdb::SQLiteDataProvider::LoadVariations()
 {
-	/** @brief Gets mysql record Id for specified variation name
-	 *         returns -1 if variation with this name is not found
-	 *	 
-	 * @param    [in] variation name
-	 * @return   dbkey_t id of variation or -1 if variation with this name is not found
-	 */
-
-	char thisFunc[] = "ccdb::SQLiteDataProvider::GetVariation( const string& name )";
-
-    ClearErrors(); //Clear error in function that can produce new ones
+	char thisFunc[] = "ccdb::SQLiteDataProvider::LoadVariations()";
 
-    //check that maybe we have this variation id by the last request?
-    if(mLastVariation!=NULL && name == mLastVariation->GetName()) return mLastVariation;
-
-    string query = "SELECT `id`, `parentId`, `name` FROM `variations` WHERE `name`= ?1";
+	if(!CheckConnection(thisFunc)) return false;
 
 	// prepare the SQL statement from the command line
-	int result = sqlite3_prepare_v2(mDatabase, query.c_str(), -1, &mStatement, 0);
-	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return NULL; }
-
-	result = sqlite3_bind_text(mStatement, 1, name.c_str(), -1, SQLITE_TRANSIENT);
-	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return NULL; }
+	int result = sqlite3_prepare_v2(mDatabase, "SELECT `id`, `parentId`, `name` FROM `variations`", -1, &mStatement, 0);
+	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return false; }
 
 	mQueryColumns = sqlite3_column_count(mStatement);
-    //select variation
-    mLastVariation = SelectVariation();
-    return mLastVariation;
-}
-
-
-Variation* ccdb::SQLiteDataProvider::GetVariationById( dbkey_t id )
-{
-	/** @brief Gets mysql record Id for specified variation name
-	 *         returns -1 if variation with this name is not found
-	 *	 
-	 * @param    [in] variation name
-	 * @return   dbkey_t id of variation or -1 if variation with this name is not found
-	 */
-
-	char thisFunc[] = "ccdb::SQLiteDataProvider::GetVariationById( dbkey_t id )";
-
-    ClearErrors(); //Clear error in function that can produce new ones
-
-    //check that maybe we have this variation id by the last request?
-    if(mVariationsById.find(id) != mVariationsById.end()) return mVariationsById[id];
-
-    string query = "SELECT `id`, `parentId`, `name` FROM `variations` WHERE `id`= ?1";
-
-	// prepare the SQL statement from the command line
-	int result = sqlite3_prepare_v2(mDatabase, query.c_str(), -1, &mStatement, 0);
-	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return NULL; }
-
-	result = sqlite3_bind_int(mStatement, 1, id);
-	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return NULL; }
-
-    //select variation
-    mLastVariation = SelectVariation();
-    return mLastVariation;
-}
-
-
-Variation* ccdb::SQLiteDataProvider::SelectVariation()
-{
-    ///* Executes statement and create Variation object. mStatement should be prepared when calling the function
-
-    char thisFunc[] = "ccdb::SQLiteDataProvider::SelectVariation()";
+	mVariationsById.clear();
 
 	// execute the statement
-	dbkey_t id = (dbkey_t)-1;
-    dbkey_t parentId = (dbkey_t)-1;
-    string name;
-    int result;
 	do
 	{
 		result = sqlite3_step(mStatement);
-
+		Variation *variation = NULL;
 		switch( result )
 		{
 		case SQLITE_DONE:
 			break;
-		case SQLITE_ROW:			
-			id =  ReadULong(0);
-            parentId = ReadULong(1);
-            name = ReadString(2);
+		case SQLITE_ROW:
+			variation = new Variation(this, this);
+			variation->SetId(ReadIndex(0));
+			variation->SetParentDbId(ReadULong(1));
+			variation->SetName(ReadString(2));
+			mVariationsById[variation->GetId()] = variation;
 			break;
 		default:
 			ComposeSQLiteError(thisFunc);
-            sqlite3_finalize(mStatement); 
-            return NULL;
-			break;
+			sqlite3_finalize(mStatement);
+			return false;
 		}
 	}
 	while(result==SQLITE_ROW );
 
 	// finalize the statement to release resources
 	sqlite3_finalize(mStatement);
-	
-    Variation *var = new Variation(this, this);
-    var->SetName(name);
-    var->SetId(id);
-    var->SetParentDbId(parentId);
-    
-    //recursive call to get variation parent
-    if(parentId>0) var->SetParent(GetVariationById(parentId));
-    
-    //add to cache
-    if(mVariationsById.find(id) == mVariationsById.end())  mVariationsById[id] = var;
-    
-	return var;
+
+	BuildVariationDependencies();
+	return true;
 }
 
 
@@ -1093,7 +1112,7 @@ Assignment* ccdb::SQLiteDataProvider::GetAssignmentShort(int run, const string&
 }
 
 
-Assignment* ccdb::SQLiteDataProvider::GetAssignmentShort(int run, const string& path, time_t time, const string& variationName, bool loadColumns /*=false*/)
+Assignment* ccdb::SQLiteDataProvider::GetAssignmentShort(int run, const string& path, time_t time, const string& variationName, bool /*loadColumns =false*/)
 {
     /** @brief Get specified by creation time version of Assignment with data blob only.
      *
@@ -1104,6 +1123,7 @@ Assignment* ccdb::SQLiteDataProvider::GetAssignmentShort(int run, const string&
      * @param [in] path - object path
      * @param [in] time - timestamp, data that is equal or earlier in time than that timestamp is returned
      * @param [in] variation - variation name
+     * @param [in] loadColumns - ignored, the type table comes from the cache of the provider with its columns
      * @return new DAssignment object or 
      */
 	char thisFunc[] = "ccdb::SQLiteDataProvider::GetAssignmentShort(int run, const string& path, time_t time, const string& variation, bool loadColumns /*=true*/)";
@@ -1111,8 +1131,8 @@ Assignment* ccdb::SQLiteDataProvider::GetAssignmentShort(int run, const string&
 
 	if(!CheckConnection(thisFunc)) return NULL;
 	
-    //Get type table
-    ConstantsTypeTable *table = GetConstantsTypeTable(path, loadColumns);
+    //Get type table. It is cached by the provider and shared between assignments
+    ConstantsTypeTable *table = GetCachedConstantsTypeTable(path);
     if(!table)
     {
         Error(CCDB_ERROR_NO_TYPETABLE, "SQLiteDataProvider::GetAssignmentShort", "Type table was not found: '"+path+"'" );
@@ -1128,92 +1148,269 @@ Assignment* ccdb::SQLiteDataProvider::GetAssignmentShort(int run, const string&
     }
 
 
-	////ok now we must build our mighty query...
+    //The effective assignment of the run is found in the cached timeline of the table,
+    //so only the data blob is read from the database
+    const AssignmentTimeline *timeline = GetAssignmentTimeline(table, variation, time);
+    if(!timeline) return NULL;
+
+    const AssignmentTimeline::Interval *interval = timeline->Find(run);
+    if(!interval) return NULL;
+
+	if(!GetCachedStatement("SELECT `vault` FROM `constantSets` WHERE `id` = ?1", thisFunc)) return NULL;
+
+	int result = sqlite3_bind_int(mStatement, 1, interval->ConstantSetId);	/*`constantSets`.`id`*/
+	if( result ) { ComposeSQLiteError(thisFunc); ReleaseStatement(); return NULL; }
+
+	mQueryColumns = sqlite3_column_count(mStatement);
+	Assignment *assignment = NULL;
+	result = sqlite3_step(mStatement);
+	switch( result )
+	{
+	case SQLITE_DONE:
+		break;
+	case SQLITE_ROW:
+		assignment = new Assignment(this, this);
+		assignment->SetId( interval->AssignmentId );
+		assignment->SetRawData( ReadString(0) );
+
+		//additional fill
+		assignment->SetRequestedRun(run);
+		assignment->SetValidRuns(interval->RunMin, interval->RunMax);
+		assignment->SetTypeTable(table);
+		break;
+	default:
+		ComposeSQLiteError(thisFunc); 
+		ReleaseStatement(); 
+		return NULL;
+	}
+
+    // reset the statement to release resources
+    ReleaseStatement();
+	return assignment;
+}
+
+
+bool ccdb::SQLiteDataProvider::LoadAssignmentTimeline(AssignmentTimeline& timeline, ConstantsTypeTable* table, Variation* variation, time_t time)
+{
+	char thisFunc[] = "ccdb::SQLiteDataProvider::LoadAssignmentTimeline(AssignmentTimeline& timeline, ConstantsTypeTable* table, Variation* variation, time_t time)";
+	if(!CheckConnection(thisFunc)) return false;
+
+    //Assignments of the variation and of its parents. The variation order is selected
+    //as the first column, so the timeline knows which of them is the nearest
+    string variationWhere, variationOrder;
+    PrepareVariationChainInsertion(variation, "`assignments`.`variationId`", variationWhere, variationOrder);
+
+    //CROSS JOIN makes SQLite start from the constant sets of the table, instead of going
+    //through all assignments of the variation. @see CreateAssignmentsLookupIndex
 	string query(
-        "SELECT `assignments`.`id` AS `asId`, "
-        "`constantSets`.`vault` AS `blob` "
-        "FROM  `assignments` "
+        "SELECT " + variationOrder + ", `assignments`.`id`, `assignments`.`constantSetId`, `runRanges`.`runMin`, `runRanges`.`runMax` "
+        "FROM  `constantSets` "
+        "CROSS JOIN `assignments` ON `assignments`.`constantSetId` = `constantSets`.`id` "
         "INNER JOIN `runRanges` ON `assignments`.`runRangeId`= `runRanges`.`id` "
-        "INNER JOIN `constantSets` ON `assignments`.`constantSetId` = `constantSets`.`id` "
-        "INNER JOIN `typeTables` ON `constantSets`.`constantTypeId` = `typeTables`.`id` "
-        "WHERE  `runRanges`.`runMin` <= ?1 "
-        "AND `runRanges`.`runMax` >= ?1 "
-        "AND `assignments`.`variationId`= ?2 "
-        "AND  `constantSets`.`constantTypeId` =?3 " + 
-        ((time>0)? string("AND  `assignments`.`created` <= datetime(?4, 'unixepoch', 'localtime') ") : string()) +
-        "ORDER BY `assignments`.`id` DESC "
-        "LIMIT 1 ");
-	
-//	cout<<query<<endl;
+        "WHERE  `constantSets`.`constantTypeId` = ?1 "
+        "AND " + variationWhere + " " +
+        ((time>0)? string("AND  `assignments`.`created` <= ?2 ") : string()));
 
-	// prepare the SQL statement from the command line
-	int result = sqlite3_prepare_v2(mDatabase, query.c_str(), -1, &mStatement, 0);
-	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return NULL; }
+	if(!GetCachedStatement(query.c_str(), thisFunc)) return false;
+
+	int result = sqlite3_bind_int(mStatement, 1, table->GetId());	/*`constantSets`.`constantTypeId`*/
+	if( result ) { ComposeSQLiteError(thisFunc); ReleaseStatement(); return false; }
 
-	result = sqlite3_bind_int(mStatement, 1, run);	/*`directoryId`*/
-	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return NULL; }
-	
-	result = sqlite3_bind_int(mStatement, 2, variation->GetId());	/*`variationId`*/
-	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return NULL; }
-			
-	result = sqlite3_bind_int(mStatement, 3, table->GetId());	/*``typeTables`.`directoryId``*/
-	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return NULL; }
-    
     if(time>0)
     {
-        result = sqlite3_bind_int64(mStatement, 4, time);	/*` `assignments`.`created``*/
-        if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return NULL; }
+        string created = FormatDatabaseTime(time);
+        result = sqlite3_bind_text(mStatement, 2, created.c_str(), -1, SQLITE_TRANSIENT);	/*`assignments`.`created`*/
+        if( result ) { ComposeSQLiteError(thisFunc); ReleaseStatement(); return false; }
     }
-	//cout<<endl<<"time "<<time<<endl;
+
 	mQueryColumns = sqlite3_column_count(mStatement);
-    int selectedRows = 0;
-	// execute the statement
-	Assignment *assignment = NULL;
 	do
 	{
 		result = sqlite3_step(mStatement);
-		
-		switch( result )
-		{
-		case SQLITE_DONE:
-			break;
-		case SQLITE_ROW:
-			assignment = new Assignment(this, this);
-			assignment->SetId( ReadIndex(0) );			
-			assignment->SetRawData( ReadString(1) );
+		if(result != SQLITE_ROW) break;
 
-			//additional fill
-			assignment->SetRequestedRun(run);
-            selectedRows++;
-			break;
-		default:
-			ComposeSQLiteError(thisFunc); 
-            sqlite3_finalize(mStatement); 
-            return NULL;
-			break;
-		}
-	} while(result==SQLITE_ROW );
+		timeline.AddAssignment(ReadIndex(1), ReadIndex(2), ReadInt(3), ReadInt(4), ReadInt(0));
+	}
+	while(true);
 
-    // finalize the statement to release resources
-    sqlite3_finalize(mStatement);
-        
-    //If We have not found data for this variation, getting data for parent variation
-    if((assignment == NULL && selectedRows==0) && variation->GetParentDbId()!=0)
-    {
-        return GetAssignmentShort(run, path, time, variation->GetParent()->GetName(), loadColumns);
-    }
-    
-	if(assignment == NULL) 
+	if(result != SQLITE_DONE) { ComposeSQLiteError(thisFunc); ReleaseStatement(); return false; }
+
+	ReleaseStatement();
+	return true;
+}
+
+
+bool ccdb::SQLiteDataProvider::GetAssignmentsShort(map<string, Assignment*>& assignments, int run, const vector<string>& paths, time_t time/*=0*/, const string& variationName/*="default"*/)
+{
+	char thisFunc[] = "ccdb::SQLiteDataProvider::GetAssignmentsShort(map<string, Assignment*>& assignments, int run, const vector<string>& paths, time_t time, const string& variation)";
+	ClearErrors(); //Clear error in function that can produce new ones
+
+	if(!CheckConnection(thisFunc)) return false;
+	if(paths.empty()) return true;
+
+	Variation* variation = GetVariation(variationName);
+	if(!variation)
 	{
-		delete table;
-		return NULL;
+		Error(CCDB_ERROR_VARIATION_INVALID,"SQLiteDataProvider::GetAssignmentsShort", "No variation '"+variationName+"' was found");
+		return false;
 	}
 
-    assignment->SetTypeTable(table);
-    assignment->BeOwner(table);
-    table->SetOwner(assignment);
+	if(!LoadConstantsTypeTables(paths)) return false;
 
-	return assignment;
+	//type tables by id. Not existing tables are skipped, like GetAssignmentShort returns NULL for them
+	map<dbkey_t, ConstantsTypeTable *> tablesById;
+	map<dbkey_t, string> pathsById;
+	vector<dbkey_t> tableIds;
+	for(size_t i=0; i<paths.size(); i++)
+	{
+		map<string, ConstantsTypeTable *>::iterator iter = mTypeTablesByPath.find(paths[i]);
+		if(iter == mTypeTablesByPath.end()) continue;
+		if(tablesById.find(iter->second->GetId()) != tablesById.end()) continue;
+		tablesById[iter->second->GetId()] = iter->second;
+		pathsById[iter->second->GetId()] = paths[i];
+		tableIds.push_back(iter->second->GetId());
+	}
+	if(tableIds.empty()) return true;
+
+	string variationWhere, variationOrder;
+	PrepareVariationChainInsertion(variation, "`assignments`.`variationId`", variationWhere, variationOrder);
+
+	//The best assignment of each table goes first. Only ids are selected, so
+	//skipped older assignments don't cost reading their data blobs.
+	//As in LoadAssignmentTimeline the search starts from the constant sets of the tables
+	string selectWhat(
+		"SELECT `constantSets`.`constantTypeId`, `assignments`.`id`, `assignments`.`constantSetId`, "
+		"`runRanges`.`runMin`, `runRanges`.`runMax`, " + variationOrder + " ");
+	string query(
+		selectWhat +
+		"FROM  `constantSets` "
+		"CROSS JOIN `assignments` ON `assignments`.`constantSetId` = `constantSets`.`id` "
+		"INNER JOIN `runRanges` ON `assignments`.`runRangeId`= `runRanges`.`id` "
+		"WHERE  `runRanges`.`runMin` <= ?1 "
+		"AND `runRanges`.`runMax` >= ?1 "
+		"AND " + variationWhere + " "
+		"AND `constantSets`.`constantTypeId` IN (" + PrepareIdListInsertion(tableIds) + ") " +
+		((time>0)? string("AND  `assignments`.`created` <= ?2 ") : string()) +
+		"ORDER BY `constantSets`.`constantTypeId`, " + variationOrder + ", `assignments`.`id` DESC");
+
+	int result = sqlite3_prepare_v2(mDatabase, query.c_str(), -1, &mStatement, 0);
+	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return false; }
+	mQueryColumns = sqlite3_column_count(mStatement);
+
+	result = sqlite3_bind_int(mStatement, 1, run);
+	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return false; }
+
+	if(time>0)
+	{
+		string created = FormatDatabaseTime(time);
+		result = sqlite3_bind_text(mStatement, 2, created.c_str(), -1, SQLITE_TRANSIENT);	/*`assignments`.`created`*/
+		if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return false; }
+	}
+
+	map<dbkey_t, dbkey_t> assignmentIdByTableId;
+	map<dbkey_t, dbkey_t> tableIdBySetId;
+	vector<dbkey_t> setIds;
+	map<dbkey_t, AssignmentTimeline> timelinesByTableId;
+	map<dbkey_t, pair<int, int> > runRangesByTableId;
+	do
+	{
+		result = sqlite3_step(mStatement);
+		if(result != SQLITE_ROW) break;
+
+		dbkey_t tableId = ReadIndex(0);
+		if(assignmentIdByTableId.find(tableId) != assignmentIdByTableId.end()) continue;
+		assignmentIdByTableId[tableId] = ReadIndex(1);
+		tableIdBySetId[ReadIndex(2)] = tableId;
+		setIds.push_back(ReadIndex(2));
+		timelinesByTableId[tableId].AddAssignment(ReadIndex(1), ReadIndex(2), ReadInt(3), ReadInt(4), ReadInt(5));
+		runRangesByTableId[tableId] = pair<int, int>(ReadInt(3), ReadInt(4));
+	}
+	while(true);
+
+	sqlite3_finalize(mStatement);
+	if(result != SQLITE_DONE) { ComposeSQLiteError(thisFunc); return false; }
+	if(setIds.empty()) return true;
+
+	//The valid runs of a found assignment are its run range, minus the parts where other
+	//assignments win. Assignments of the run lose everywhere, so only those that don't
+	//include the run but overlap the run range can end the span. @see GetAssignmentShort
+	query = selectWhat +
+		"FROM  `constantSets` "
+		"CROSS JOIN `assignments` ON `assignments`.`constantSetId` = `constantSets`.`id` "
+		"INNER JOIN `runRanges` ON `assignments`.`runRangeId`= `runRanges`.`id` "
+		"WHERE  (`runRanges`.`runMax` < ?1 OR `runRanges`.`runMin` > ?1) "
+		"AND " + variationWhere + " "
+		"AND `constantSets`.`constantTypeId` IN (" + PrepareIdListInsertion(tableIds) + ") "
+		"AND " + PrepareRunOverlapInsertion(runRangesByTableId) + " " +
+		((time>0)? string("AND  `assignments`.`created` <= ?2 ") : string());
+
+	result = sqlite3_prepare_v2(mDatabase, query.c_str(), -1, &mStatement, 0);
+	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return false; }
+	mQueryColumns = sqlite3_column_count(mStatement);
+
+	result = sqlite3_bind_int(mStatement, 1, run);
+	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return false; }
+
+	if(time>0)
+	{
+		string created = FormatDatabaseTime(time);
+		result = sqlite3_bind_text(mStatement, 2, created.c_str(), -1, SQLITE_TRANSIENT);	/*`assignments`.`created`*/
+		if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return false; }
+	}
+
+	do
+	{
+		result = sqlite3_step(mStatement);
+		if(result != SQLITE_ROW) break;
+
+		timelinesByTableId[ReadIndex(0)].AddAssignment(ReadIndex(1), ReadIndex(2), ReadInt(3), ReadInt(4), ReadInt(5));
+	}
+	while(true);
+
+	sqlite3_finalize(mStatement);
+	if(result != SQLITE_DONE) { ComposeSQLiteError(thisFunc); return false; }
+
+	//data blobs of the selected assignments
+	query = "SELECT `id`, `vault` FROM `constantSets` WHERE `id` IN (" + PrepareIdListInsertion(setIds) + ")";
+	result = sqlite3_prepare_v2(mDatabase, query.c_str(), -1, &mStatement, 0);
+	if( result ) { ComposeSQLiteError(thisFunc); sqlite3_finalize(mStatement); return false; }
+	mQueryColumns = sqlite3_column_count(mStatement);
+
+	map<dbkey_t, Assignment *> assignmentsByTableId;
+	do
+	{
+		result = sqlite3_step(mStatement);
+		if(result != SQLITE_ROW) break;
+
+		dbkey_t tableId = tableIdBySetId[ReadIndex(0)];
+		Assignment *assignment = new Assignment(this, this);
+		assignment->SetId(assignmentIdByTableId[tableId]);
+		assignment->SetRawData(ReadString(1));
+		assignment->SetRequestedRun(run);
+		assignment->SetTypeTable(tablesById[tableId]);
+		assignmentsByTableId[tableId] = assignment;
+
+		AssignmentTimeline &timeline = timelinesByTableId[tableId];
+		timeline.Build();
+		const AssignmentTimeline::Interval *interval = timeline.Find(run);
+		if(interval) assignment->SetValidRuns(interval->RunMin, interval->RunMax);
+	}
+	while(true);
+
+	sqlite3_finalize(mStatement);
+	if(result != SQLITE_DONE) 
+	{
+		ComposeSQLiteError(thisFunc);
+		for(map<dbkey_t, Assignment *>::iterator iter = assignmentsByTableId.begin(); iter != assignmentsByTableId.end(); ++iter) delete iter->second;
+		return false; 
+	}
+
+	map<dbkey_t, Assignment *>::iterator iter = assignmentsByTableId.begin();
+	for(; iter != assignmentsByTableId.end(); ++iter)
+	{
+		assignments[pathsById[iter->first]] = iter->second;
+	}
+	return true;
 }
 
 
@@ -1525,6 +1722,188 @@ void ccdb::SQLiteDataProvider::FetchAssignment(Assignment* assignment, Constants
 	assignment->SetTypeTable(table);
 	if(IsOwner(table)) table->SetOwner(assignment);
 }
+
+
+bool ccdb::SQLiteDataProvider::CreateAssignments(const vector<Assignment *>& assignments)
+{
+	const char* thisFunc = "ccdb::SQLiteDataProvider::CreateAssignments";
+	if(!CheckConnection(thisFunc)) return false;
+
+	if(mIsReadOnly)
+	{
+		Error(CCDB_ERROR_QUERY_INSERT, thisFunc, "The database is opened read only");
+		return false;
+	}
+
+	for(size_t i=0; i<assignments.size(); i++)
+	{
+		if(!CheckNewAssignment(assignments[i], thisFunc)) return false;
+	}
+
+	//IMMEDIATE takes the write lock at once, so the transaction doesn't fail half way on a busy database
+	if(!ExecuteStatement("BEGIN IMMEDIATE", thisFunc)) return false;
+
+	for(size_t i=0; i<assignments.size(); i++)
+	{
+		if(!InsertAssignment(assignments[i], thisFunc))
+		{
+			ExecuteStatement("ROLLBACK", thisFunc);
+			for(size_t j=0; j<=i; j++) assignments[j]->SetId(0);
+			return false;
+		}
+	}
+
+	if(!ExecuteStatement("COMMIT", thisFunc))
+	{
+		ExecuteStatement("ROLLBACK", thisFunc);
+		for(size_t i=0; i<assignments.size(); i++) assignments[i]->SetId(0);
+		return false;
+	}
+
+	//timelines built before don't have the new assignments
+	InvalidateAssignmentTimelines();
+	return true;
+}
+
+
+bool ccdb::SQLiteDataProvider::InsertAssignment(Assignment* assignment, const char* functionName)
+{
+	RunRange *runRange = assignment->GetRunRange();
+	dbkey_t runRangeId = GetOrInsertRunRange(runRange->GetMin(), runRange->GetMax(), functionName);
+	if(runRangeId == 0) return false;
+	runRange->SetId(runRangeId);
+
+	//created is in the time zone LoadAssignmentTimeline compares it in. @see SetTimeZone
+	string now = FormatDatabaseTime(time(NULL));
+
+	if(!GetCachedStatement("INSERT INTO `constantSets` (`vault`, `constantTypeId`, `created`, `modified`) "
+		"VALUES (?1, ?2, ?3, ?3)", functionName)) return false;
+
+	const string& vault = assignment->GetRawData();
+	int result = sqlite3_bind_text(mStatement, 1, vault.data(), (int)vault.size(), SQLITE_TRANSIENT);	/*`vault`*/
+	if(result == SQLITE_OK) result = sqlite3_bind_int(mStatement, 2, assignment->GetTypeTable()->GetId());	/*`constantTypeId`*/
+	if(result == SQLITE_OK) result = sqlite3_bind_text(mStatement, 3, now.c_str(), -1, SQLITE_TRANSIENT);	/*`created`, `modified`*/
+	if(result == SQLITE_OK) result = sqlite3_step(mStatement);
+	if(result != SQLITE_DONE)
+	{
+		Error(CCDB_ERROR_QUERY_INSERT, functionName, ComposeSQLiteError("INSERT INTO `constantSets`"));
+		ReleaseStatement();
+		return false;
+	}
+	ReleaseStatement();
+	dbkey_t constantSetId = static_cast<dbkey_t>(sqlite3_last_insert_rowid(mDatabase));
+
+	if(!GetCachedStatement("INSERT INTO `assignments` (`variationId`, `runRangeId`, `constantSetId`, `authorId`, `comment`, `created`, `modified`) "
+		"VALUES (?1, ?2, ?3, COALESCE((SELECT `id` FROM `users` WHERE `name` = ?4), 1), ?5, ?6, ?6)", functionName)) return false;
+
+	const string& comment = assignment->GetComment();
+	result = sqlite3_bind_int(mStatement, 1, assignment->GetVariation()->GetId());		/*`variationId`*/
+	if(result == SQLITE_OK) result = sqlite3_bind_int(mStatement, 2, runRangeId);		/*`runRangeId`*/
+	if(result == SQLITE_OK) result = sqlite3_bind_int(mStatement, 3, constantSetId);	/*`constantSetId`*/
+	if(result == SQLITE_OK) result = sqlite3_bind_text(mStatement, 4, mLogUserName.c_str(), -1, SQLITE_TRANSIENT);	/*`users`.`name`*/
+	if(result == SQLITE_OK) result = comment.empty() ?									/*`comment`, NULL if empty*/
+		sqlite3_bind_null(mStatement, 5) :
+		sqlite3_bind_text(mStatement, 5, comment.c_str(), -1, SQLITE_TRANSIENT);
+	if(result == SQLITE_OK) result = sqlite3_bind_text(mStatement, 6, now.c_str(), -1, SQLITE_TRANSIENT);	/*`created`, `modified`*/
+	if(result == SQLITE_OK) result = sqlite3_step(mStatement);
+	if(result != SQLITE_DONE)
+	{
+		Error(CCDB_ERROR_QUERY_INSERT, functionName, ComposeSQLiteError("INSERT INTO `assignments`"));
+		ReleaseStatement();
+		return false;
+	}
+	ReleaseStatement();
+	mLastInsertedId = static_cast<dbkey_t>(sqlite3_last_insert_rowid(mDatabase));
+
+	assignment->SetId(mLastInsertedId);
+	assignment->SetDataVaultId(constantSetId);
+	assignment->SetRunRangeId(runRangeId);
+	assignment->SetVariationId(assignment->GetVariation()->GetId());
+	assignment->SetCreatedTime(time(NULL));
+
+	//the same log record the python tools add
+	if(!GetCachedStatement("INSERT INTO `logs` (`affectedIds`, `action`, `description`, `comment`, `authorId`, `created`) "
+		"VALUES (?1, 'create', ?2, ?3, COALESCE((SELECT `id` FROM `users` WHERE `name` = ?4), 1), ?5)", functionName)) return false;
+
+	string affectedIds = StringUtils::Format("assignments_%i", (int)mLastInsertedId);
+	string description = StringUtils::Format("Created assignment '%s:%i-%i:%s'", assignment->GetTypeTable()->GetFullPath().c_str(),
+		runRange->GetMin(), runRange->GetMax(), assignment->GetVariation()->GetName().c_str());
+	result = sqlite3_bind_text(mStatement, 1, affectedIds.c_str(), -1, SQLITE_TRANSIENT);	/*`affectedIds`*/
+	if(result == SQLITE_OK) result = sqlite3_bind_text(mStatement, 2, description.c_str(), -1, SQLITE_TRANSIENT);	/*`description`*/
+	if(result == SQLITE_OK) result = comment.empty() ?
+		sqlite3_bind_null(mStatement, 3) :
+		sqlite3_bind_text(mStatement, 3, comment.c_str(), -1, SQLITE_TRANSIENT);		/*`comment`*/
+	if(result == SQLITE_OK) result = sqlite3_bind_text(mStatement, 4, mLogUserName.c_str(), -1, SQLITE_TRANSIENT);	/*`users`.`name`*/
+	if(result == SQLITE_OK) result = sqlite3_bind_text(mStatement, 5, now.c_str(), -1, SQLITE_TRANSIENT);	/*`created`*/
+	if(result == SQLITE_OK) result = sqlite3_step(mStatement);
+	if(result != SQLITE_DONE)
+	{
+		Error(CCDB_ERROR_QUERY_INSERT, functionName, ComposeSQLiteError("INSERT INTO `logs`"));
+		ReleaseStatement();
+		return false;
+	}
+	ReleaseStatement();
+	return true;
+}
+
+
+dbkey_t ccdb::SQLiteDataProvider::GetOrInsertRunRange(int runMin, int runMax, const char* functionName)
+{
+	if(!GetCachedStatement("SELECT `id` FROM `runRanges` WHERE `runMin` = ?1 AND `runMax` = ?2 AND (`name` IS NULL OR `name` = '') LIMIT 1", functionName)) return 0;
+
+	int result = sqlite3_bind_int(mStatement, 1, runMin);				/*`runMin`*/
+	if(result == SQLITE_OK) result = sqlite3_bind_int(mStatement, 2, runMax);	/*`runMax`*/
+	if(result == SQLITE_OK) result = sqlite3_step(mStatement);
+
+	dbkey_t id = 0;
+	if(result == SQLITE_ROW)
+	{
+		mQueryColumns = sqlite3_column_count(mStatement);
+		id = ReadIndex(0);
+	}
+	else if(result != SQLITE_DONE)
+	{
+		Error(CCDB_ERROR_OBTAINING_RUNRANGE, functionName, ComposeSQLiteError("SELECT FROM `runRanges`"));
+		ReleaseStatement();
+		return 0;
+	}
+	ReleaseStatement();
+	if(id > 0) return id;
+
+	if(!GetCachedStatement("INSERT INTO `runRanges` (`runMin`, `runMax`, `name`, `created`, `modified`) "
+		"VALUES (?1, ?2, '', ?3, ?3)", functionName)) return 0;
+
+	string now = FormatDatabaseTime(time(NULL));
+	result = sqlite3_bind_int(mStatement, 1, runMin);					/*`runMin`*/
+	if(result == SQLITE_OK) result = sqlite3_bind_int(mStatement, 2, runMax);	/*`runMax`*/
+	if(result == SQLITE_OK) result = sqlite3_bind_text(mStatement, 3, now.c_str(), -1, SQLITE_TRANSIENT);	/*`created`, `modified`*/
+	if(result == SQLITE_OK) result = sqlite3_step(mStatement);
+	if(result != SQLITE_DONE)
+	{
+		Error(CCDB_ERROR_QUERY_INSERT, functionName, ComposeSQLiteError("INSERT INTO `runRanges`"));
+		ReleaseStatement();
+		return 0;
+	}
+	ReleaseStatement();
+	return static_cast<dbkey_t>(sqlite3_last_insert_rowid(mDatabase));
+}
+
+
+bool ccdb::SQLiteDataProvider::CreateAssignmentsLookupIndex()
+{
+	const char* thisFunc = "ccdb::SQLiteDataProvider::CreateAssignmentsLookupIndex";
+	ClearErrors(); //Clear error in function that can produce new ones
+	if(!CheckConnection(thisFunc)) return false;
+
+	if(mIsReadOnly)
+	{
+		Error(CCDB_ERROR_QUERY_INSERT, thisFunc, "The database is opened read only");
+		return false;
+	}
+
+	return ExecuteStatement("CREATE INDEX IF NOT EXISTS \"assignments_lookup_index\" ON \"assignments\" "
+		"(\"constantSetId\", \"variationId\", \"created\", \"runRangeId\")", thisFunc);
+}
 #pragma end region Assignments
 
 std::string ccdb::SQLiteDataProvider::WilcardsToLike( const string& str )
@@ -1671,6 +2050,65 @@ bool ccdb::SQLiteDataProvider::QueryPrepare(const char* query, const char *funct
 	return true;
 }
 
+
+sqlite3_stmt* ccdb::SQLiteDataProvider::GetCachedStatement(const char* query, const char* functionName)
+{
+	map<string, sqlite3_stmt*>::iterator iter = mCachedStatements.find(query);
+	if(iter != mCachedStatements.end())
+	{
+		mStatement = iter->second;
+		sqlite3_reset(mStatement);
+		sqlite3_clear_bindings(mStatement);
+		return mStatement;
+	}
+
+	int result = sqlite3_prepare_v2(mDatabase, query, -1, &mStatement, 0);
+	if( result )
+	{
+		ComposeSQLiteError(functionName);
+		sqlite3_finalize(mStatement);
+		mStatement = NULL;
+		return NULL;
+	}
+
+	mCachedStatements[query] = mStatement;
+	return mStatement;
+}
+
+
+void ccdb::SQLiteDataProvider::ReleaseStatement()
+{
+	if(mStatement) sqlite3_reset(mStatement);
+}
+
+
+bool ccdb::SQLiteDataProvider::ExecuteStatement(const char* query, const char* functionName)
+{
+	if(!GetCachedStatement(query, functionName)) return false;
+
+	int result = sqlite3_step(mStatement);
+	if(result != SQLITE_DONE)
+	{
+		Error(CCDB_ERROR_QUERY_INSERT, functionName, ComposeSQLiteError(query));
+		ReleaseStatement();
+		return false;
+	}
+	ReleaseStatement();
+	return true;
+}
+
+
+void ccdb::SQLiteDataProvider::FinalizeCachedStatements()
+{
+	map<string, sqlite3_stmt*>::iterator iter = mCachedStatements.begin();
+	for(; iter != mCachedStatements.end(); ++iter)
+	{
+		sqlite3_finalize(iter->second);
+	}
+	mCachedStatements.clear();
+	mStatement = NULL;
+}
+
 #pragma endregion
 
 
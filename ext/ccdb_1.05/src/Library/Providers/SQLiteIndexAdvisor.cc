@@ -0,0 +1,359 @@
+#include <sqlite3.h>
+
+#include "CCDB/Providers/SQLiteIndexAdvisor.h"
+#include "CCDB/Helpers/StringUtils.h"
+
+using namespace std;
+
+namespace
+{
+	struct QueryShape
+	{
+		const char* Name;
+		const char* Query;
+	};
+
+	//______________________________________________________________________________
+	/** Queries of SQLiteDataProvider that select by id or name. The provider inserts
+	 *  id lists and variation chains in the text, they are replaced by sample ids here.
+	 *  Keep in line with the provider when its queries change. */
+	const QueryShape QueryShapes[] =
+	{
+		{"type table by name (GetConstantsTypeTable)",
+			"SELECT `id`, `created`, `modified`, `name`, `directoryId`, `nRows`, `nColumns`, `comment` "
+			"FROM `typeTables` WHERE `name` = ?1 AND `directoryId` = ?2"},
+
+		{"type tables of directories (LoadConstantsTypeTables)",
+			"SELECT `id`, `created`, `modified`, `name`, `directoryId`, `nRows`, `nColumns`, `comment` "
+			"FROM `typeTables` WHERE `directoryId` IN (1, 2)"},
+
+		{"columns of a type table (LoadColumns)",
+			"SELECT `id`, `created`, `modified`, `name`, `columnType`, `comment` "
+			"FROM `columns` WHERE `typeId` = ?1 ORDER BY `order`"},
+
+		{"columns of type tables (LoadConstantsTypeTables)",
+			"SELECT `id`, `created`, `modified`, `name`, `columnType`, `comment`, `typeId` "
+			"FROM `columns` WHERE `typeId` IN (1, 2) ORDER BY `typeId`, `order`"},
+
+		{"assignment timeline (LoadAssignmentTimeline)",
+			"SELECT CASE `assignments`.`variationId` WHEN 2 THEN 0 WHEN 1 THEN 1 END, "
+			"`assignments`.`id`, `assignments`.`constantSetId`, `runRanges`.`runMin`, `runRanges`.`runMax` "
+			"FROM  `constantSets` "
+			"CROSS JOIN `assignments` ON `assignments`.`constantSetId` = `constantSets`.`id` "
+			"INNER JOIN `runRanges` ON `assignments`.`runRangeId`= `runRanges`.`id` "
+			"WHERE  `constantSets`.`constantTypeId` = ?1 "
+			"AND `assignments`.`variationId` IN (2, 1) "
+			"AND  `assignments`.`created` <= ?2 "},
+
+		{"assignments of tables for a run (GetAssignmentsShort)",
+			"SELECT `constantSets`.`constantTypeId`, `assignments`.`id`, `assignments`.`constantSetId` "
+			"FROM  `constantSets` "
+			"CROSS JOIN `assignments` ON `assignments`.`constantSetId` = `constantSets`.`id` "
+			"INNER JOIN `runRanges` ON `assignments`.`runRangeId`= `runRanges`.`id` "
+			"WHERE  `runRanges`.`runMin` <= ?1 "
+			"AND `runRanges`.`runMax` >= ?1 "
+			"AND `assignments`.`variationId` IN (2, 1) "
+			"AND `constantSets`.`constantTypeId` IN (1, 2) "
+			"AND  `assignments`.`created` <= ?2 "
+			"ORDER BY `constantSets`.`constantTypeId`, CASE `assignments`.`variationId` WHEN 2 THEN 0 WHEN 1 THEN 1 END, `assignments`.`id` DESC"},
+
+		{"data vault (GetAssignmentShort)",
+			"SELECT `vault` FROM `constantSets` WHERE `id` = ?1"},
+
+		{"data vaults (GetAssignmentsShort)",
+			"SELECT `id`, `vault` FROM `constantSets` WHERE `id` IN (1, 2)"},
+
+		{"assignments of a type table (GetAssignments)",
+			"SELECT `assignments`.`id`, `constantSets`.`vault`, `runRanges`.`runMin`, `runRanges`.`runMax`, `variations`.`name` "
+			"FROM `runRanges` "
+			"INNER JOIN `assignments` ON `assignments`.`runRangeId`= `runRanges`.`id` "
+			"INNER JOIN `variations` ON `assignments`.`variationId`= `variations`.`id` "
+			"INNER JOIN `constantSets` ON `assignments`.`constantSetId` = `constantSets`.`id` "
+			"INNER JOIN `typeTables` ON `constantSets`.`constantTypeId` = `typeTables`.`id` "
+			"WHERE  `typeTables`.`id` = ?1 ORDER BY `assignments`.`created` DESC"},
+
+		{"run range of new assignments (CreateAssignments)",
+			"SELECT `id` FROM `runRanges` WHERE `runMin` = ?1 AND `runMax` = ?2 AND (`name` IS NULL OR `name` = '') LIMIT 1"}
+	};
+	const size_t QueryShapesCount = sizeof(QueryShapes)/sizeof(QueryShapes[0]);
+
+	struct IndexShape
+	{
+		const char* Name;
+		const char* Table;
+		const char* Columns;    //comma separated
+	};
+
+	//______________________________________________________________________________
+	/** The first is the index of SQLiteDataProvider::CreateAssignmentsLookupIndex */
+	const IndexShape IndexShapes[] =
+	{
+		{"assignments_lookup_index", "assignments", "constantSetId,variationId,created,runRangeId"},
+		{"constantSets_fk_constantSets_constantTypes1_idx", "constantSets", "constantTypeId"},
+		{"runRanges_run search", "runRanges", "runMin,runMax"},
+		{"typeTables_fk_constantTypes_directories1_idx", "typeTables", "directoryId"},
+		{"columns_fk_columns_constantTypes1_idx", "columns", "typeId"}
+	};
+	const size_t IndexShapesCount = sizeof(IndexShapes)/sizeof(IndexShapes[0]);
+
+	//______________________________________________________________________________
+	/** "name" quoted for SQL */
+	string Quote(const string& name)
+	{
+		return "\"" + ccdb::StringUtils::Replace("\"", "\"\"", name) + "\"";
+	}
+}
+
+namespace ccdb
+{
+
+//______________________________________________________________________________
+SQLiteIndexAdvisor::SQLiteIndexAdvisor():
+	mDatabase(NULL)
+{
+}
+
+
+//______________________________________________________________________________
+SQLiteIndexAdvisor::~SQLiteIndexAdvisor()
+{
+	Close();
+}
+
+
+//______________________________________________________________________________
+bool SQLiteIndexAdvisor::Open(const string& fileName, bool readOnly)
+{
+	Close();
+	mErrorMessage.clear();
+
+	int flags = readOnly? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE;
+	if(sqlite3_open_v2(fileName.c_str(), &mDatabase, flags, NULL) != SQLITE_OK)
+	{
+		SetError("Can't open '" + fileName + "'");
+		Close();
+		return false;
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+void SQLiteIndexAdvisor::Close()
+{
+	if(mDatabase != NULL) sqlite3_close(mDatabase);
+	mDatabase = NULL;
+}
+
+
+//______________________________________________________________________________
+vector<SQLiteIndexAdvisor::Index> SQLiteIndexAdvisor::GetIndexes()
+{
+	vector<Index> indexes(IndexShapesCount);
+	for(size_t i=0; i<IndexShapesCount; i++)
+	{
+		indexes[i].Name = IndexShapes[i].Name;
+		indexes[i].Table = IndexShapes[i].Table;
+		indexes[i].Columns = StringUtils::Split(IndexShapes[i].Columns, ",");
+	}
+	return indexes;
+}
+
+
+//______________________________________________________________________________
+bool SQLiteIndexAdvisor::ExplainQueries(vector<QueryPlan>& plans)
+{
+	plans.clear();
+	if(!IsOpen())
+	{
+		mErrorMessage = "The database is not opened";
+		return false;
+	}
+
+	for(size_t i=0; i<QueryShapesCount; i++)
+	{
+		QueryPlan plan;
+		plan.Name = QueryShapes[i].Name;
+		plan.Query = QueryShapes[i].Query;
+		plan.HasFullScan = false;
+
+		sqlite3_stmt* statement = NULL;
+		string query = string("EXPLAIN QUERY PLAN ") + QueryShapes[i].Query;
+		if(sqlite3_prepare_v2(mDatabase, query.c_str(), -1, &statement, NULL) != SQLITE_OK)
+		{
+			SetError(StringUtils::Format("Can't explain the query of %s", QueryShapes[i].Name));
+			sqlite3_finalize(statement);
+			return false;
+		}
+
+		//the last column is the step, the older versions of SQLite have 4 columns, the newer have more
+		int detailColumn = sqlite3_column_count(statement) - 1;
+		int result;
+		while((result = sqlite3_step(statement)) == SQLITE_ROW)
+		{
+			const unsigned char* detail = sqlite3_column_text(statement, detailColumn);
+			string step = detail? reinterpret_cast<const char*>(detail) : "";
+			plan.Steps.push_back(step);
+
+			//"SCAN TABLE x" before SQLite 3.24, "SCAN x" after. "SCAN CONSTANT ROW" reads nothing
+			if(step.compare(0, 5, "SCAN ") == 0 && step.find("CONSTANT ROW") == string::npos)
+			{
+				plan.HasFullScan = true;
+			}
+		}
+		sqlite3_finalize(statement);
+		if(result != SQLITE_DONE)
+		{
+			SetError(StringUtils::Format("Can't explain the query of %s", QueryShapes[i].Name));
+			return false;
+		}
+		plans.push_back(plan);
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+bool SQLiteIndexAdvisor::ReadIndexColumns(const string& table, vector<vector<string> >& indexes)
+{
+	/** @brief Reads the columns of each index of the table */
+
+	indexes.clear();
+	vector<string> names;
+
+	sqlite3_stmt* statement = NULL;
+	string query = "PRAGMA index_list(" + Quote(table) + ")";
+	if(sqlite3_prepare_v2(mDatabase, query.c_str(), -1, &statement, NULL) != SQLITE_OK)
+	{
+		SetError("Can't list the indexes of `" + table + "`");
+		sqlite3_finalize(statement);
+		return false;
+	}
+	while(sqlite3_step(statement) == SQLITE_ROW)
+	{
+		names.push_back(reinterpret_cast<const char*>(sqlite3_column_text(statement, 1)));	/*name*/
+	}
+	sqlite3_finalize(statement);
+
+	for(size_t i=0; i<names.size(); i++)
+	{
+		query = "PRAGMA index_info(" + Quote(names[i]) + ")";
+		if(sqlite3_prepare_v2(mDatabase, query.c_str(), -1, &statement, NULL) != SQLITE_OK)
+		{
+			SetError("Can't read the index '" + names[i] + "'");
+			sqlite3_finalize(statement);
+			return false;
+		}
+
+		//rows are in the order of the columns in the index
+		vector<string> columns;
+		while(sqlite3_step(statement) == SQLITE_ROW)
+		{
+			const unsigned char* name = sqlite3_column_text(statement, 2);	/*name, NULL for expressions*/
+			columns.push_back(name? reinterpret_cast<const char*>(name) : "");
+		}
+		sqlite3_finalize(statement);
+		indexes.push_back(columns);
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+bool SQLiteIndexAdvisor::FindMissingIndexes(vector<Index>& missing)
+{
+	missing.clear();
+	if(!IsOpen())
+	{
+		mErrorMessage = "The database is not opened";
+		return false;
+	}
+
+	vector<Index> indexes = GetIndexes();
+	for(size_t i=0; i<indexes.size(); i++)
+	{
+		vector<vector<string> > existing;
+		if(!ReadIndexColumns(indexes[i].Table, existing)) return false;
+
+		bool found = false;
+		for(size_t j=0; j<existing.size() && !found; j++)
+		{
+			const vector<string>& columns = existing[j];
+			if(columns.size() < indexes[i].Columns.size()) continue;
+
+			found = true;
+			for(size_t k=0; k<indexes[i].Columns.size(); k++)
+			{
+				if(columns[k] != indexes[i].Columns[k]) found = false;
+			}
+		}
+		if(!found) missing.push_back(indexes[i]);
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+bool SQLiteIndexAdvisor::CreateMissingIndexes(vector<Index>& created)
+{
+	created.clear();
+	vector<Index> missing;
+	if(!FindMissingIndexes(missing)) return false;
+
+	if(sqlite3_db_readonly(mDatabase, "main") == 1)
+	{
+		mErrorMessage = "The database is opened read only";
+		return false;
+	}
+
+	if(!Execute("BEGIN IMMEDIATE")) return false;
+	for(size_t i=0; i<missing.size(); i++)
+	{
+		string columns;
+		for(size_t j=0; j<missing[i].Columns.size(); j++)
+		{
+			if(j>0) columns += ", ";
+			columns += Quote(missing[i].Columns[j]);
+		}
+
+		//an index of the name may exist on other columns
+		string name = missing[i].Name;
+		if(!Execute("CREATE INDEX IF NOT EXISTS " + Quote(name) + " ON " + Quote(missing[i].Table) + " (" + columns + ")"))
+		{
+			Execute("ROLLBACK");
+			return false;
+		}
+	}
+	if(!Execute("COMMIT"))
+	{
+		Execute("ROLLBACK");
+		return false;
+	}
+	created = missing;
+
+	//statistics let the planner choose between the indexes
+	return Execute("ANALYZE");
+}
+
+
+//______________________________________________________________________________
+bool SQLiteIndexAdvisor::Execute(const string& query)
+{
+	char* error = NULL;
+	if(sqlite3_exec(mDatabase, query.c_str(), NULL, NULL, &error) != SQLITE_OK)
+	{
+		mErrorMessage = query + " failed: " + (error? error : "");
+		sqlite3_free(error);
+		return false;
+	}
+	return true;
+}
+
+
+//______________________________________________________________________________
+void SQLiteIndexAdvisor::SetError(const string& what)
+{
+	mErrorMessage = what + ": " + (mDatabase? sqlite3_errmsg(mDatabase) : "out of memory");
+}
+
+}
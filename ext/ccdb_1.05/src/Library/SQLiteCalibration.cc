@@ -48,6 +48,8 @@ bool SQLiteCalibration::Connect( std::string connectionString )
 	 * @param connectionString the Connection String
 	 * @return true if connected
 	 */
+    int poolSize = ExtractPoolSize(connectionString);
+
     Lock();
 
     UpdateActivityTime();
@@ -93,6 +95,7 @@ bool SQLiteCalibration::Connect( std::string connectionString )
     }
 
     bool result = mProvider->Connect(connectionString);
+    if(result) result = ConnectProviderPool(connectionString, poolSize);
     Unlock();
     return result;
     //TODO decide maybe to throw an exception here?
@@ -117,6 +120,16 @@ void SQLiteCalibration::Disconnect()
     }
 
     mProvider->Disconnect();
+    if(mProviderPool) mProviderPool->Disconnect();
+}
+
+
+//______________________________________________________________________________
+DataProvider * SQLiteCalibration::CreatePoolProvider()
+{
+    SQLiteDataProvider *provider = new SQLiteDataProvider();
+    provider->SetReadOnly(true);
+    return provider;
 }
 
 
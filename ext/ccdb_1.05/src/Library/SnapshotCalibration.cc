@@ -0,0 +1,243 @@
+#include <stdexcept>
+
+#include "CCDB/SnapshotCalibration.h"
+#include "CCDB/Helpers/PathUtils.h"
+#include "CCDB/Helpers/StringUtils.h"
+#include "CCDB/Model/ConstantsTypeTable.h"
+
+namespace ccdb
+{
+
+
+//______________________________________________________________________________
+SnapshotCalibration::SnapshotCalibration()
+{
+}
+
+//______________________________________________________________________________
+SnapshotCalibration::SnapshotCalibration( int defaultRun, string defaultVariation/*="default"*/ , time_t defaultTime/*=0*/ )
+    :Calibration(defaultRun,defaultVariation, defaultTime)
+{
+}
+
+
+//______________________________________________________________________________
+SnapshotCalibration::~SnapshotCalibration()
+{
+    ClearTypeTables();
+}
+
+
+//______________________________________________________________________________
+bool SnapshotCalibration::Connect( std::string connectionString )
+{
+    /**
+     * @brief Maps the snapshot file
+     *
+     * @param connectionString snapshot://<path to the snapshot file>
+     * @return true if the file is a valid snapshot
+     */
+
+    if(connectionString.find("snapshot://") != 0)
+    {
+        throw std::logic_error("Snapshot connection string should start with snapshot://. The connection string: " + connectionString);
+    }
+
+    Lock();
+    UpdateActivityTime();
+
+    if(mSnapshot.IsOpen())
+    {
+        Unlock();
+        if(mConnectionString == connectionString) return true;
+
+        //The connection is open to another source
+        throw std::logic_error(ERRMSG_CONNECTED_TO_ANOTHER);
+    }
+
+    bool result = mSnapshot.Open(connectionString.substr(11));
+    if(result)
+    {
+        //all assignments of a table share its type table. The file of the same
+        //connection string doesn't change, so the tables are made on the first connect
+        if(mConnectionString != connectionString) mTypeTables.clear();
+        const map<string, SnapshotFile::Table>& tables = mSnapshot.GetTables();
+        map<string, SnapshotFile::Table>::const_iterator iter = tables.begin();
+        for(; iter != tables.end(); ++iter)
+        {
+            const SnapshotFile::Table& table = iter->second;
+            if(mTypeTables.find(table.Path) != mTypeTables.end()) continue;
+
+            ConstantsTypeTable *typeTable = new ConstantsTypeTable();
+            typeTable->SetFullPath(table.Path);
+            typeTable->SetName(table.Path.substr(table.Path.rfind('/') + 1));
+            typeTable->SetNRows(table.RowsCount);
+            for(size_t col=0; col<table.ColumnNames.size(); col++)
+            {
+                typeTable->AddColumn(table.ColumnNames[col], table.ColumnTypes[col]);
+            }
+            mTypeTables[table.Path] = typeTable;
+            mOwnedTypeTables.push_back(typeTable);
+        }
+        mConnectionString = connectionString;
+    }
+
+    Unlock();
+    return result;
+}
+
+
+//______________________________________________________________________________
+void SnapshotCalibration::Disconnect()
+{
+    /** @brief Unmaps the snapshot file
+     *
+     * The type tables are kept, assignments that were returned before stay valid
+     */
+
+    Lock();
+    mSnapshot.Close();
+    Unlock();
+}
+
+
+//______________________________________________________________________________
+bool SnapshotCalibration::IsConnected()
+{
+    return mSnapshot.IsOpen();
+}
+
+
+//______________________________________________________________________________
+string SnapshotCalibration::GetConnectionString() const
+{
+    return mConnectionString;
+}
+
+
+//______________________________________________________________________________
+void SnapshotCalibration::ClearTypeTables()
+{
+    for(size_t i=0; i<mOwnedTypeTables.size(); i++) delete mOwnedTypeTables[i];
+    mOwnedTypeTables.clear();
+    mTypeTables.clear();
+}
+
+
+//______________________________________________________________________________
+Assignment * SnapshotCalibration::MakeAssignment(const string& namepath)
+{
+    /** @brief Copies the table of the namepath out of the snapshot
+     *
+     * @exception logic_error if the namepath asks for a variation, time or run
+     *            that the snapshot doesn't hold
+     * @return the assignment owned by the caller or NULL if the snapshot has no such table
+     */
+
+    RequestParseResult result = PathUtils::ParseRequest(namepath);
+    string variation = (result.WasParsedVariation ? result.Variation : mDefaultVariation);
+    int run  = (result.WasParsedRunNumber ? result.RunNumber : mDefaultRun);
+    string path = PathUtils::MakeAbsolute(result.Path);
+    time_t time = (result.WasParsedTime ? result.Time : mDefaultTime);
+
+    if(variation != mSnapshot.GetVariation() || time != mSnapshot.GetTime())
+    {
+        throw std::logic_error(StringUtils::Format("Request '%s' asks for variation '%s' time %lu, but snapshot '%s' holds variation '%s' time %lu",
+            namepath.c_str(), variation.c_str(), (unsigned long)time,
+            mSnapshot.GetFileName().c_str(), mSnapshot.GetVariation().c_str(), (unsigned long)mSnapshot.GetTime()));
+    }
+
+    const SnapshotFile::Table* table = mSnapshot.FindTable(path);
+    if(table == NULL) return NULL;
+
+    if(run < table->ValidRunMin || run > table->ValidRunMax)
+    {
+        throw std::logic_error(StringUtils::Format("Request '%s' asks for run %i, but snapshot '%s' holds the table for runs %i-%i",
+            namepath.c_str(), run, mSnapshot.GetFileName().c_str(), table->ValidRunMin, table->ValidRunMax));
+    }
+
+    Assignment *assignment = new Assignment();
+    assignment->SetId(table->AssignmentId);
+    assignment->SetRequestedRun(run);
+    assignment->SetValidRuns(table->ValidRunMin, table->ValidRunMax);
+    assignment->SetTypeTable(mTypeTables[path]);
+    if(!assignment->SetBinaryData(table->Data, table->Data + table->DataSize))
+    {
+        delete assignment;
+        throw std::logic_error("Data of table '" + path + "' in snapshot '" + mSnapshot.GetFileName() + "' is corrupted");
+    }
+    return assignment;
+}
+
+
+//______________________________________________________________________________
+Assignment * SnapshotCalibration::GetAssignment(const string& namepath, bool /*loadColumns =true*/)
+{
+    /** @brief Gets the assignment of a table of the snapshot
+     *
+     * The columns are always there, loadColumns is ignored
+     *
+     * @return the assignment owned by the caller or NULL if the snapshot has no such table
+     */
+
+    UpdateActivityTime();
+    CheckConnection();  // Check if is connected and reconnect if needed (and allowed)
+
+    return MakeAssignment(namepath);
+}
+
+
+//______________________________________________________________________________
+bool SnapshotCalibration::GetAssignments(map<string, Assignment *> &assignments, const vector<string>& namepaths)
+{
+    UpdateActivityTime();
+    CheckConnection();
+
+    for(size_t i=0; i<namepaths.size(); i++)
+    {
+        if(assignments.find(namepaths[i]) != assignments.end()) continue;
+        Assignment *assignment = MakeAssignment(namepaths[i]);
+        if(assignment) assignments[namepaths[i]] = assignment;
+    }
+    return true;
+}
+
+
+//______________________________________________________________________________
+bool SnapshotCalibration::GetDirectoryAssignments(map<string, Assignment *> &assignments, const string& directoryPath)
+{
+    UpdateActivityTime();
+    CheckConnection();
+
+    string prefix = directoryPath;
+    prefix = PathUtils::MakeAbsolute(prefix);
+    if(prefix[prefix.length()-1] != '/') prefix += '/';
+
+    vector<string> paths;
+    const map<string, SnapshotFile::Table>& tables = mSnapshot.GetTables();
+    map<string, SnapshotFile::Table>::const_iterator iter = tables.begin();
+    for(; iter != tables.end(); ++iter)
+    {
+        if(iter->first.compare(0, prefix.length(), prefix) == 0) paths.push_back(iter->first);
+    }
+
+    return GetAssignments(assignments, paths);
+}
+
+
+//______________________________________________________________________________
+void SnapshotCalibration::GetListOfNamepaths( vector<string> &namepaths )
+{
+    UpdateActivityTime();
+    CheckConnection();
+
+    const map<string, SnapshotFile::Table>& tables = mSnapshot.GetTables();
+    map<string, SnapshotFile::Table>::const_iterator iter = tables.begin();
+    for(; iter != tables.end(); ++iter)
+    {
+        //without '/' in the beginning, as Calibration::GetListOfNamepaths
+        namepaths.push_back(iter->first.substr(1));
+    }
+}
+
+}
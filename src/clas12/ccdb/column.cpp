@@ -0,0 +1,267 @@
+#include "column.hpp"
+
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <stdexcept>
+#include <vector>
+
+namespace clas12
+{
+namespace ccdb
+{
+
+using std::string;
+using std::vector;
+
+using ::ccdb::ConstantsTypeColumn;
+
+namespace detail
+{
+
+string format_value(int val)           { return std::to_string(val); }
+string format_value(unsigned int val)  { return std::to_string(val); }
+string format_value(long val)          { return std::to_string(val); }
+string format_value(unsigned long val) { return std::to_string(val); }
+string format_value(bool val)          { return val ? "true" : "false"; }
+
+namespace
+{
+
+/// snprintf with the decimal point of the C locale whatever the current one is
+void print_double(char* buf, size_t size, int prec, double val)
+{
+    std::snprintf(buf, size, "%.*g", prec, val);
+    const char point = std::localeconv()->decimal_point[0];
+    if (point != '.')
+    {
+        for (char* c=buf; *c; c++)
+        {
+            if (*c == point)
+            {
+                *c = '.';
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+/** shortest of %.15g, %.16g and %.17g that reads back as the same
+ *  double. Whole numbers below 1e15 print as integers under %.15g, so
+ *  they are written directly.
+ **/
+size_t print_value(char* buf, double val)
+{
+    if (val == std::floor(val) && std::fabs(val) < 1e15
+        && !(val == 0 && std::signbit(val)))
+    {
+        long long whole = static_cast<long long>(val);
+        unsigned long long mag = whole < 0 ? -static_cast<unsigned long long>(whole) : whole;
+        char digits[20];
+        size_t nd = 0;
+        do
+        {
+            digits[nd++] = static_cast<char>('0' + mag % 10);
+            mag /= 10;
+        } while (mag != 0);
+        size_t len = 0;
+        if (whole < 0)
+        {
+            buf[len++] = '-';
+        }
+        while (nd > 0)
+        {
+            buf[len++] = digits[--nd];
+        }
+        buf[len] = '\0';
+        return len;
+    }
+
+    for (int prec=15; prec<17; prec++)
+    {
+        print_double(buf, double_text_size, prec, val);
+        size_t len = std::strlen(buf);
+        double back;
+        if (::ccdb::NumericParser::ParseExact(buf, buf+len, back)
+            && back == val)
+        {
+            return len;
+        }
+    }
+    print_double(buf, double_text_size, 17, val);
+    return std::strlen(buf);
+}
+
+string format_value(double val)
+{
+    char buf[double_text_size];
+    return string(buf, print_value(buf, val));
+}
+
+void conversion_error(const string& str)
+{
+    stringstream ss;
+    ss << "Could not convert: '"
+       << str
+       << "' to a numeric type.";
+    throw std::invalid_argument(ss.str());
+}
+
+bool parse_integral_double(const string& str, double lo, double hi, double& val)
+{
+    double d;
+    if (::ccdb::NumericParser::ParseExact(str, d)
+        && d == std::floor(d) && d >= lo && d <= hi)
+    {
+        val = d;
+        return true;
+    }
+    return false;
+}
+
+} // namespace clas12::ccdb::detail
+
+template <typename T>
+void Column::fill(const vector<string>& cells)
+{
+    unique_ptr<detail::ColumnBuffer<T>> buf(new detail::ColumnBuffer<T>(n));
+    T* out = buf->data.get();
+    for (size_t i=0; i<n; i++)
+    {
+        out[i] = detail::converter<T>::from(cells[i]);
+    }
+    buffers[detail::native_column<T>::type] = std::move(buf);
+}
+
+Column::Column(ColumnType type, const vector<string>& cells)
+: storage(type)
+, n(cells.size())
+{
+    try
+    {
+        switch (storage)
+        {
+            case ConstantsTypeColumn::cIntColumn:    fill<int>(cells);           break;
+            case ConstantsTypeColumn::cUIntColumn:   fill<unsigned int>(cells);  break;
+            case ConstantsTypeColumn::cLongColumn:   fill<long>(cells);          break;
+            case ConstantsTypeColumn::cULongColumn:  fill<unsigned long>(cells); break;
+            case ConstantsTypeColumn::cDoubleColumn: fill<double>(cells);        break;
+            case ConstantsTypeColumn::cBoolColumn:   fill<bool>(cells);          break;
+            default:
+                storage = ConstantsTypeColumn::cStringColumn;
+                fill<string>(cells);
+                break;
+        }
+    }
+    catch (const std::invalid_argument&)
+    {
+        // the cells do not match the declared type:
+        // keep the text and let the accessors report it
+        storage = ConstantsTypeColumn::cStringColumn;
+        fill<string>(cells);
+    }
+}
+
+template <typename T, typename From>
+void Column::fill_typed(const vector<From>& cells)
+{
+    unique_ptr<detail::ColumnBuffer<T>> buf(new detail::ColumnBuffer<T>(n));
+    std::copy(cells.begin(), cells.end(), buf->data.get());
+    buffers[detail::native_column<T>::type] = std::move(buf);
+}
+
+Column::Column(const ::ccdb::BinaryBlob::Column& cells)
+: storage(cells.Type)
+{
+    switch (storage)
+    {
+        case ConstantsTypeColumn::cIntColumn:
+            n = cells.Ints.size();
+            fill_typed<int>(cells.Ints);
+            break;
+        case ConstantsTypeColumn::cUIntColumn:
+            n = cells.UInts.size();
+            fill_typed<unsigned int>(cells.UInts);
+            break;
+        case ConstantsTypeColumn::cLongColumn:
+            n = cells.Longs.size();
+            fill_typed<long>(cells.Longs);
+            break;
+        case ConstantsTypeColumn::cULongColumn:
+            n = cells.ULongs.size();
+            fill_typed<unsigned long>(cells.ULongs);
+            break;
+        case ConstantsTypeColumn::cDoubleColumn:
+            n = cells.Doubles.size();
+            fill_typed<double>(cells.Doubles);
+            break;
+        case ConstantsTypeColumn::cBoolColumn:
+            n = cells.Bools.size();
+            fill_typed<bool>(cells.Bools);
+            break;
+        default:
+            storage = ConstantsTypeColumn::cStringColumn;
+            n = cells.Strings.size();
+            fill_typed<string>(cells.Strings);
+            break;
+    }
+}
+
+namespace
+{
+
+/// copies the primary buffer of one column into another
+struct primary_copier
+{
+    unique_ptr<detail::ColumnBufferBase> result;
+    size_t n;
+
+    template <typename T>
+    void operator()(const T* data)
+    {
+        detail::ColumnBuffer<T>* buf = new detail::ColumnBuffer<T>(n);
+        std::copy(data, data+n, buf->data.get());
+        result.reset(buf);
+    }
+};
+
+} // anonymous namespace
+
+Column::Column(const Column& that)
+: storage(that.storage)
+, n(that.n)
+{
+    primary_copier c;
+    c.n = n;
+    that.visit(c);
+    buffers[storage] = std::move(c.result);
+}
+
+Column& Column::operator=(const Column& that)
+{
+    if (this != &that)
+    {
+        Column tmp(that);
+        *this = std::move(tmp);
+    }
+    return *this;
+}
+
+void Column::invalidate()
+{
+    for (unsigned int i=0; i<detail::n_column_types; i++)
+    {
+        if (i != static_cast<unsigned int>(storage))
+        {
+            buffers[i].reset();
+        }
+    }
+}
+
+} // namespace clas12::ccdb
+} // namespace clas12
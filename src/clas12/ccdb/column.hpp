@@ -0,0 +1,581 @@
+#ifndef CLAS12_CCDB_COLUMN_HPP
+#define CLAS12_CCDB_COLUMN_HPP
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "CCDB/Helpers/BinaryBlob.h"
+#include "CCDB/Helpers/NumericParser.h"
+#include "CCDB/Model/ConstantsTypeColumn.h"
+
+namespace clas12
+{
+namespace ccdb
+{
+
+using std::size_t;
+using std::string;
+using std::stringstream;
+using std::vector;
+using std::unique_ptr;
+
+typedef ::ccdb::ConstantsTypeColumn::ColumnTypes ColumnType;
+
+namespace detail
+{
+
+/** \brief maps a C++ type onto the CCDB column type that stores it
+ * natively. Types not listed here (float, short, ...) are converted
+ * on access.
+ **/
+template <typename T>
+struct native_column
+{
+    static const bool value = false;
+};
+
+#define CLAS12_CCDB_NATIVE_COLUMN(T, TYPE) \
+    template <> \
+    struct native_column<T> \
+    { \
+        static const bool value = true; \
+        static const ColumnType type = ::ccdb::ConstantsTypeColumn::TYPE; \
+    };
+
+CLAS12_CCDB_NATIVE_COLUMN(int,           cIntColumn)
+CLAS12_CCDB_NATIVE_COLUMN(unsigned int,  cUIntColumn)
+CLAS12_CCDB_NATIVE_COLUMN(long,          cLongColumn)
+CLAS12_CCDB_NATIVE_COLUMN(unsigned long, cULongColumn)
+CLAS12_CCDB_NATIVE_COLUMN(double,        cDoubleColumn)
+CLAS12_CCDB_NATIVE_COLUMN(bool,          cBoolColumn)
+CLAS12_CCDB_NATIVE_COLUMN(string,        cStringColumn)
+
+#undef CLAS12_CCDB_NATIVE_COLUMN
+
+/// number of storage types (size of ColumnType)
+const unsigned int n_column_types = ::ccdb::ConstantsTypeColumn::cStringColumn + 1;
+
+/** \brief text form of a stored value as written to the database
+ **/
+string format_value(int val);
+string format_value(unsigned int val);
+string format_value(long val);
+string format_value(unsigned long val);
+string format_value(double val);
+string format_value(bool val);
+inline string format_value(const string& val) { return val; }
+
+/// size of the buffer print_value() needs
+const size_t double_text_size = 32;
+
+/** \brief writes the text form of val, as format_value(val) would,
+ *  to buf which must hold double_text_size characters.
+ *
+ * \return number of characters written (not counting the final '\0')
+ **/
+size_t print_value(char* buf, double val);
+
+template <typename T>
+string format_value(const T& val)
+{
+    stringstream ss;
+    ss << val;
+    return ss.str();
+}
+
+/** \brief reports a cell that could not be converted
+ *
+ * \throw std::invalid_argument always
+ **/
+void conversion_error(const string& str);
+
+/** \brief types read by the locale independent ::ccdb::NumericParser
+ **/
+template <typename T> struct fast_parse { static const bool value = false; };
+template <> struct fast_parse<int>                { static const bool value = true; };
+template <> struct fast_parse<unsigned int>       { static const bool value = true; };
+template <> struct fast_parse<long>               { static const bool value = true; };
+template <> struct fast_parse<unsigned long>      { static const bool value = true; };
+template <> struct fast_parse<long long>          { static const bool value = true; };
+template <> struct fast_parse<unsigned long long> { static const bool value = true; };
+template <> struct fast_parse<double>             { static const bool value = true; };
+template <> struct fast_parse<float>              { static const bool value = true; };
+template <> struct fast_parse<bool>               { static const bool value = true; };
+
+/** \brief reads an integer written in floating point form ("1.0",
+ *  "1e3") into val. Fractions and values out of the range [lo, hi]
+ *  are rejected.
+ **/
+bool parse_integral_double(const string& str, double lo, double hi, double& val);
+
+/** \brief parses a table cell into a numeric type. The whole cell
+ *  must be the number.
+ *
+ * \throw std::invalid_argument if str could not be converted
+ **/
+template <typename T>
+typename std::enable_if<fast_parse<T>::value, T>::type
+parse_value(const string& str)
+{
+    T ret;
+    if (::ccdb::NumericParser::ParseExact(str, ret))
+    {
+        return ret;
+    }
+
+    double dval;
+    if (std::is_integral<T>::value && !std::is_same<T,bool>::value
+        && parse_integral_double(str,
+               static_cast<double>(std::numeric_limits<T>::min()),
+               static_cast<double>(std::numeric_limits<T>::max()),
+               dval))
+    {
+        return static_cast<T>(dval);
+    }
+
+    conversion_error(str);
+    return T();
+}
+
+/** \brief generic version of parse_value() for types that are not
+ *  handled by the numeric parser.
+ **/
+template <typename T>
+typename std::enable_if<!fast_parse<T>::value, T>::type
+parse_value(const string& str)
+{
+    T ret;
+    if (!(stringstream(str) >> ret))
+    {
+        conversion_error(str);
+    }
+    return ret;
+}
+
+/** \brief converts a stored value of one type to another: numbers
+ * are cast, strings are parsed and anything else goes through the
+ * text form.
+ **/
+template <typename To, typename Enable = void>
+struct converter
+{
+    template <typename From>
+    static To from(const From& val)
+    {
+        return parse_value<To>(format_value(val));
+    }
+};
+
+template <typename To>
+struct converter<To, typename std::enable_if<std::is_arithmetic<To>::value>::type>
+{
+    template <typename From>
+    static To from(const From& val,
+        typename std::enable_if<std::is_arithmetic<From>::value>::type* = 0)
+    {
+        return static_cast<To>(val);
+    }
+
+    static To from(const string& val)
+    {
+        return parse_value<To>(val);
+    }
+};
+
+template <>
+struct converter<string>
+{
+    template <typename From>
+    static string from(const From& val)
+    {
+        return format_value(val);
+    }
+};
+
+/** \brief base of the typed buffers so they can share one slot array
+ **/
+class ColumnBufferBase
+{
+  public:
+    virtual ~ColumnBufferBase() {}
+};
+
+/** \brief contiguous storage for one column. unique_ptr<T[]> is
+ *  used rather than vector<T> so that bool columns are contiguous
+ *  too.
+ **/
+template <typename T>
+class ColumnBuffer : public ColumnBufferBase
+{
+  public:
+    unique_ptr<T[]> data;
+    size_t size;
+
+    explicit ColumnBuffer(size_t size)
+    : data(new T[size]())
+    , size(size)
+    {}
+};
+
+/** \brief mutex guarding data built on demand by const members. It
+ *  is not shared: a copy or an assignment of its owner gets its own,
+ *  so the owner keeps its default copy and move.
+ **/
+class OwnMutex
+{
+  public:
+    std::mutex mutex;
+
+    OwnMutex() {}
+    OwnMutex(const OwnMutex&) {}
+    OwnMutex& operator=(const OwnMutex&) { return *this; }
+};
+
+} // namespace clas12::ccdb::detail
+
+/** \brief non-owning, read-only view of a contiguous column of type T
+ *
+ *  A view does not copy the cells. It stays valid as long as the
+ *  table it came from is alive and the column is not modified.
+ **/
+template <typename T>
+class ColumnView
+{
+  private:
+    const T* first;
+    size_t n;
+
+  public:
+    typedef T value_type;
+    typedef const T* const_iterator;
+    typedef const T* iterator;
+
+    ColumnView()
+    : first(nullptr)
+    , n(0)
+    {}
+
+    ColumnView(const T* first, size_t n)
+    : first(first)
+    , n(n)
+    {}
+
+    const T* data() const { return first; }
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    const T* begin() const { return first; }
+    const T* end() const { return first + n; }
+
+    const T& operator[](size_t i) const { return first[i]; }
+
+    /** \return element i
+     * \throw std::out_of_range if i is not less than size()
+     **/
+    const T& at(size_t i) const
+    {
+        if (i >= n)
+        {
+            throw std::out_of_range("ColumnView::at");
+        }
+        return first[i];
+    }
+};
+
+/** \brief a single column of a ConstantsTable held as a contiguous
+ *  typed buffer.
+ *
+ *  The cells are parsed once, when the column is built, into a buffer
+ *  of the type declared for the column in the database. Should a cell
+ *  not parse as that type, the column is kept as strings and the
+ *  conversion is tried (and may throw) on access instead.
+ *
+ *  Access as a different type is converted per element by get<T>(),
+ *  or for a whole column by data<T>() which keeps the converted copy
+ *  around until the column is modified.
+ **/
+class Column
+{
+  private:
+    /// type of the primary buffer
+    ColumnType storage;
+
+    /// number of rows
+    size_t n;
+
+    /** primary buffer (at index storage) followed by any converted
+     *  copies requested through data<T>()
+     **/
+    mutable unique_ptr<detail::ColumnBufferBase> buffers[detail::n_column_types];
+
+    /// serializes making the converted copies in data<T>() const
+    mutable detail::OwnMutex conversion;
+
+    template <typename T>
+    detail::ColumnBuffer<T>* buffer() const
+    {
+        return static_cast<detail::ColumnBuffer<T>*>(
+            buffers[detail::native_column<T>::type].get() );
+    }
+
+    template <typename T>
+    const T* primary() const
+    {
+        return buffer<T>()->data.get();
+    }
+
+    template <typename T>
+    T* primary()
+    {
+        return buffer<T>()->data.get();
+    }
+
+    template <typename T>
+    void fill(const vector<string>& cells);
+
+    template <typename T, typename From>
+    void fill_typed(const vector<From>& cells);
+
+    /// drops every converted copy, keeping only the primary buffer
+    void invalidate();
+
+    /** \brief calls f(primary_buffer) with the primary buffer cast to
+     *  its stored type.
+     **/
+    template <typename F>
+    void visit(F& f) const
+    {
+        switch (storage)
+        {
+            case ::ccdb::ConstantsTypeColumn::cIntColumn:    f(primary<int>());           break;
+            case ::ccdb::ConstantsTypeColumn::cUIntColumn:   f(primary<unsigned int>());  break;
+            case ::ccdb::ConstantsTypeColumn::cLongColumn:   f(primary<long>());          break;
+            case ::ccdb::ConstantsTypeColumn::cULongColumn:  f(primary<unsigned long>()); break;
+            case ::ccdb::ConstantsTypeColumn::cDoubleColumn: f(primary<double>());        break;
+            case ::ccdb::ConstantsTypeColumn::cBoolColumn:   f(primary<bool>());          break;
+            default:                                         f(primary<string>());        break;
+        }
+    }
+
+    template <typename T>
+    struct getter
+    {
+        size_t row;
+        T result;
+        template <typename From>
+        void operator()(const From* data) { result = detail::converter<T>::from(data[row]); }
+    };
+
+    template <typename T>
+    struct copier
+    {
+        T* out;
+        size_t n;
+        template <typename From>
+        void operator()(const From* data)
+        {
+            for (size_t i=0; i<n; i++)
+            {
+                out[i] = detail::converter<T>::from(data[i]);
+            }
+        }
+    };
+
+    template <typename T>
+    struct setter
+    {
+        const Column* column;
+        size_t row;
+        const T* val;
+        /// the primary buffer is owned (and only modified) by the column
+        template <typename To>
+        void operator()(const To* data)
+        {
+            const_cast<To*>(data)[row] = column->narrow<To>(*val);
+        }
+    };
+
+    /** \brief converts a value to be stored into the column's type
+     *
+     * \throw std::invalid_argument if a number would not survive the
+     * round trip (for example 1.5 stored into an int column)
+     **/
+    template <typename To, typename From>
+    To narrow(const From& val,
+        typename std::enable_if<std::is_arithmetic<To>::value
+                             && std::is_arithmetic<From>::value>::type* = 0) const
+    {
+        To ret = static_cast<To>(val);
+        if (static_cast<From>(ret) != val || (val < From()) != (ret < To()))
+        {
+            stringstream ss;
+            ss << "Value: " << val << " does not fit in a column of type "
+               << ::ccdb::ConstantsTypeColumn::TypeToString(storage) << ".";
+            throw std::invalid_argument(ss.str());
+        }
+        return ret;
+    }
+
+    template <typename To, typename From>
+    To narrow(const From& val,
+        typename std::enable_if<!(std::is_arithmetic<To>::value
+                               && std::is_arithmetic<From>::value)>::type* = 0) const
+    {
+        return detail::converter<To>::from(val);
+    }
+
+  public:
+    /** \brief builds the column from the cells of the table as read
+     *  from the database, parsing them according to type.
+     **/
+    Column(ColumnType type, const vector<string>& cells);
+
+    /** \brief builds the column from a column of a binary constant
+     *  set, which is already typed: nothing is parsed.
+     **/
+    explicit Column(const ::ccdb::BinaryBlob::Column& cells);
+
+    Column(const Column& that);
+    Column& operator=(const Column& that);
+    Column(Column&& that) = default;
+    Column& operator=(Column&& that) = default;
+
+    /** \return the type the cells are stored as
+     **/
+    ColumnType type() const { return storage; }
+
+    /** \return number of cells in this column
+     **/
+    size_t size() const { return n; }
+
+    /** \return the cell at row converted to type T
+     **/
+    template <typename T>
+    T get(size_t row) const
+    {
+        if (row >= n)
+        {
+            throw std::out_of_range("Column::get");
+        }
+        getter<T> g;
+        g.row = row;
+        visit(g);
+        return g.result;
+    }
+
+    /** \return the text form of the cell at row
+     **/
+    string text(size_t row) const
+    {
+        return get<string>(row);
+    }
+
+    /** \return pointer to the contiguous cells of this column as type
+     *  T. If T is not the stored type, the converted copy is made on
+     *  the first call and kept until the column is modified.
+     *
+     *  Concurrent calls on a const column are safe, the copy is made
+     *  once under a lock.
+     **/
+    template <typename T>
+    const T* data() const
+    {
+        static_assert(detail::native_column<T>::value,
+            "Column::data<T>() requires T to be one of the CCDB column types");
+        if (detail::native_column<T>::type == storage)
+        {
+            return primary<T>();
+        }
+
+        std::lock_guard<std::mutex> lock(conversion.mutex);
+        if (!buffers[detail::native_column<T>::type])
+        {
+            unique_ptr<detail::ColumnBuffer<T>> buf(new detail::ColumnBuffer<T>(n));
+            copier<T> c;
+            c.out = buf->data.get();
+            c.n = n;
+            visit(c);
+            buffers[detail::native_column<T>::type] = std::move(buf);
+        }
+        return primary<T>();
+    }
+
+    /** \return a view of the cells of this column as type T, see
+     *  data<T>()
+     **/
+    template <typename T>
+    ColumnView<T> view() const
+    {
+        return ColumnView<T>(data<T>(), n);
+    }
+
+    /** \brief copies the column converted to type T into out
+     **/
+    template <typename T>
+    void copy_to(vector<T>& out) const
+    {
+        out.resize(n);
+        copier<T> c;
+        c.out = out.data();
+        c.n = n;
+        visit(c);
+    }
+
+    /** \brief overwrites the cell at row, converting val to the stored
+     *  type.
+     **/
+    template <typename T>
+    void set(size_t row, const T& val)
+    {
+        if (row >= n)
+        {
+            throw std::out_of_range("Column::set");
+        }
+        setter<T> s;
+        s.column = this;
+        s.row = row;
+        s.val = &val;
+        visit(s);
+        invalidate();
+    }
+
+    /** \brief overwrites every cell of the column with vals which
+     *  must have at least size() elements.
+     **/
+    template <typename T>
+    void set(const vector<T>& vals)
+    {
+        if (vals.size() < n)
+        {
+            throw std::out_of_range("Column::set");
+        }
+        setter<T> s;
+        s.column = this;
+        for (s.row=0; s.row<n; s.row++)
+        {
+            s.val = &vals[s.row];
+            visit(s);
+        }
+        invalidate();
+    }
+};
+
+/// vector<bool> has no contiguous storage
+template <>
+inline void Column::copy_to<bool>(vector<bool>& out) const
+{
+    const bool* d = data<bool>();
+    out.assign(d, d+n);
+}
+
+} // namespace clas12::ccdb
+} // namespace clas12
+
+#endif // CLAS12_CCDB_COLUMN_HPP
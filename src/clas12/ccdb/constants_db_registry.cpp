@@ -0,0 +1,58 @@
+#include "constants_db_registry.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "CCDB/CalibrationGenerator.h"
+
+namespace clas12
+{
+namespace ccdb
+{
+
+using ::ccdb::CalibrationGenerator;
+
+ConstantsDBRegistry& ConstantsDBRegistry::instance()
+{
+    static ConstantsDBRegistry registry;
+    return registry;
+}
+
+shared_ptr<ConstantsDB> ConstantsDBRegistry::get(
+    const string& connection_string,
+    int run,
+    const string& variation,
+    time_t timestamp)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Key key(connection_string, run, variation, timestamp);
+    auto it = dbs.find(key);
+    if (it != dbs.end())
+    {
+        return it->second;
+    }
+
+    // CreateCalibration() does not keep the Calibration it makes,
+    // so the registry is its only owner
+    shared_ptr<ConstantsDB> db(CalibrationGenerator::CreateCalibration(
+        connection_string, run, variation, timestamp ) );
+    dbs[key] = db;
+    return db;
+}
+
+size_t ConstantsDBRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return dbs.size();
+}
+
+void ConstantsDBRegistry::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    dbs.clear();
+}
+
+} // namespace clas12::ccdb
+} // namespace clas12
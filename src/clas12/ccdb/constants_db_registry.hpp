@@ -0,0 +1,79 @@
+#ifndef CLAS12_CCDB_CONSTANTS_DB_REGISTRY_HPP
+#define CLAS12_CCDB_CONSTANTS_DB_REGISTRY_HPP
+
+#include <cstddef>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "CCDB/Calibration.h"
+
+namespace clas12
+{
+namespace ccdb
+{
+
+typedef ::ccdb::Calibration ConstantsDB;
+
+using std::shared_ptr;
+using std::size_t;
+using std::string;
+using std::time_t;
+
+/** \brief process-wide cache of open database connections.
+ *
+ *  get_constants_db() asks the registry for a ConstantsDB. The first
+ *  request for a (connection string, run, variation, timestamp)
+ *  creates and connects it. Later requests, from any module or thread,
+ *  get a handle to the same object. A ConstantsDB lives until both the
+ *  registry and every caller have released their handles.
+ *
+ *  All methods are thread safe.
+ **/
+class ConstantsDBRegistry
+{
+  private:
+    typedef std::tuple<string, int, string, time_t> Key;
+
+    mutable std::mutex mutex;
+    std::map<Key, shared_ptr<ConstantsDB>> dbs;
+
+    ConstantsDBRegistry() {}
+    ConstantsDBRegistry(const ConstantsDBRegistry&) = delete;
+    ConstantsDBRegistry& operator=(const ConstantsDBRegistry&) = delete;
+
+  public:
+    /** \return the registry shared by the whole process
+     **/
+    static ConstantsDBRegistry& instance();
+
+    /** \brief finds or creates the ConstantsDB for the given
+     *  connection string and constant set.
+     *
+     * \throw std::logic_error if the connection could not be made
+     * \return shared handle to the connected ConstantsDB
+     **/
+    shared_ptr<ConstantsDB> get(
+        const string& connection_string,
+        int run,
+        const string& variation,
+        time_t timestamp);
+
+    /** \return number of ConstantsDB objects held by the registry
+     **/
+    size_t size() const;
+
+    /** \brief releases the registry's handles. Connections still used
+     *  elsewhere stay open until their last handle goes away; the
+     *  next get() opens a new one.
+     **/
+    void clear();
+};
+
+} // namespace clas12::ccdb
+} // namespace clas12
+
+#endif // CLAS12_CCDB_CONSTANTS_DB_REGISTRY_HPP
@@ -0,0 +1,99 @@
+#include "constants_manager.hpp"
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace clas12
+{
+namespace ccdb
+{
+
+using std::string;
+using std::stringstream;
+using std::unique_ptr;
+using std::vector;
+
+using ::ccdb::Assignment;
+
+ConstantsManager::ConstantsManager(
+    const shared_ptr<ConstantsDB>& db,
+    const vector<string>& table_paths)
+: db(db)
+, current_run(db->GetDefaultRun())
+{
+    if (!db->IsConnected())
+    {
+        db->Connect(db->GetConnectionString());
+    }
+    for (const auto& path : table_paths)
+    {
+        load(path, current_run);
+    }
+}
+
+void ConstantsManager::load(const string& table_path, int run)
+{
+    // the run in the request overrides the run of db
+    stringstream namepath;
+    namepath << table_path << ":" << run;
+
+    unique_ptr<Assignment> assignment(
+        db->GetAssignment(namepath.str(), true) );
+    if (!assignment)
+    {
+        stringstream err;
+        err << "No constants found for table: '" << table_path
+            << "' and run " << run;
+        throw std::invalid_argument(err.str());
+    }
+
+    tables.erase(table_path);
+    tables.emplace(table_path, ConstantsTable(*assignment, table_path));
+}
+
+void ConstantsManager::add_table(const string& table_path)
+{
+    if (tables.find(table_path) == tables.end())
+    {
+        load(table_path, current_run);
+    }
+}
+
+unsigned int ConstantsManager::set_run(int run)
+{
+    vector<string> stale;
+    for (const auto& t : tables)
+    {
+        if (!t.second.valid_for_run(run))
+        {
+            stale.push_back(t.first);
+        }
+    }
+    for (const auto& path : stale)
+    {
+        load(path, run);
+    }
+    current_run = run;
+    return stale.size();
+}
+
+int ConstantsManager::run() const
+{
+    return current_run;
+}
+
+ConstantsTable& ConstantsManager::table(const string& table_path)
+{
+    return tables.at(table_path);
+}
+
+const ConstantsTable& ConstantsManager::table(const string& table_path) const
+{
+    return tables.at(table_path);
+}
+
+} // namespace clas12::ccdb
+} // namespace clas12
@@ -0,0 +1,94 @@
+#ifndef CLAS12_CCDB_CONSTANTS_MANAGER_HPP
+#define CLAS12_CCDB_CONSTANTS_MANAGER_HPP
+
+#include <climits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "constants_table.hpp"
+
+namespace clas12
+{
+namespace ccdb
+{
+
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+/** \brief keeps a set of ConstantsTable objects up to date while
+ *  the run changes.
+ *
+ *  Every loaded table knows the runs for which the database has the
+ *  same constants. On set_run() only the tables that are not valid
+ *  for the new run are loaded again, the others keep their parsed
+ *  columns. Variation and timestamp are those of the ConstantsDB.
+ *
+ * typical usage, when merging files of many runs:
+ *
+ * auto db = get_constants_db(conn, ConstantSetInfo(first_run));
+ * ConstantsManager constants(db, {"/calibration/ftof/status",
+ *                                 "/geometry/target"});
+ * for (auto run : runs)
+ * {
+ *     constants.set_run(run);
+ *     auto& status = constants.table("/calibration/ftof/status");
+ *     ...
+ * }
+ **/
+class ConstantsManager
+{
+  private:
+    /// database the tables are loaded from
+    shared_ptr<ConstantsDB> db;
+
+    /// run of the loaded tables
+    int current_run;
+
+    /// the tables by table path
+    std::map<string, ConstantsTable> tables;
+
+    /// loads the table at table_path for run
+    void load(const string& table_path, int run);
+
+  public:
+    /** \brief loads the tables for the run of db.
+     *
+     * \throw std::invalid_argument if a table has no constants
+     **/
+    ConstantsManager(
+        const shared_ptr<ConstantsDB>& db,
+        const vector<string>& table_paths);
+
+    /** \brief adds a table to the managed set, loading it for the
+     *  current run.
+     *
+     * \throw std::invalid_argument if the table has no constants
+     **/
+    void add_table(const string& table_path);
+
+    /** \brief changes the run, reloading only the tables that are not
+     *  valid for it.
+     *
+     * \throw std::invalid_argument if a table has no constants
+     * \return number of tables that were loaded again
+     **/
+    unsigned int set_run(int run);
+
+    /** \return the run of the loaded tables
+     **/
+    int run() const;
+
+    /** \throw std::out_of_range if the table is not managed
+     *  \return the table at table_path for the current run
+     **/
+    ConstantsTable& table(const string& table_path);
+    const ConstantsTable& table(const string& table_path) const;
+};
+
+} // namespace clas12::ccdb
+} // namespace clas12
+
+#endif // CLAS12_CCDB_CONSTANTS_MANAGER_HPP
@@ -2,19 +2,26 @@
 
 #include <algorithm>
 #include <climits>
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
-#include <iomanip>
-#include <fstream>
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <stdexcept>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <boost/filesystem.hpp>
 
 #include "CCDB/CalibrationGenerator.h"
 #include "CCDB/Calibration.h"
+#include "CCDB/Helpers/PathUtils.h"
+#include "CCDB/Model/RunRange.h"
+#include "CCDB/Model/Variation.h"
 
 namespace clas12
 {
@@ -28,10 +35,13 @@ using std::stringstream;
 using std::time;
 using std::time_t;
 using std::vector;
-using std::setw;
 
 using ::ccdb::CalibrationGenerator;
 using ::ccdb::Assignment;
+using ::ccdb::ConstantsTypeTable;
+using ::ccdb::PathUtils;
+using ::ccdb::RunRange;
+using ::ccdb::Variation;
 
 typedef ::ccdb::Calibration ConstantsDB;
 
@@ -45,13 +55,15 @@ ConnectionInfoMySQL::ConnectionInfoMySQL(
     const string& password ,
     const string& host     ,
           int     port     ,
-    const string& database
+    const string& database ,
+          int     pool_size
 )
 : user(user)
 , password(password)
 , host(host)
 , port(port)
 , database(database)
+, pool_size(pool_size)
 {}
 
 string ConnectionInfoMySQL::connection_string() const
@@ -66,11 +78,16 @@ string ConnectionInfoMySQL::connection_string() const
     ss << "@" << host;
     ss << ":" << port;
     ss << "/" << database;
+    if (pool_size > 1)
+    {
+        ss << "?pool=" << pool_size;
+    }
     return ss.str();
 }
 
-ConnectionInfoSQLite::ConnectionInfoSQLite(string filepath)
+ConnectionInfoSQLite::ConnectionInfoSQLite(string filepath, int pool_size)
 : filepath(filepath)
+, pool_size(pool_size)
 {}
 
 string ConnectionInfoSQLite::connection_string() const
@@ -86,12 +103,47 @@ string ConnectionInfoSQLite::connection_string() const
         throw std::invalid_argument( "Path: '" +
             path.string() + "' is not a regular file." );
     }
+    else if (pool_size > 1)
+    {
+        return "sqlite://" + path.string() + "?pool=" +
+            std::to_string(pool_size);
+    }
     else
     {
         return "sqlite://" + path.string();
     }
 }
 
+ConnectionInfoSnapshot::ConnectionInfoSnapshot(string filepath)
+: filepath(filepath)
+{}
+
+string ConnectionInfoSnapshot::connection_string() const
+{
+    fs::path path(filepath);
+    if (! fs::is_regular_file(path))
+    {
+        throw std::invalid_argument( "Snapshot: '" +
+            path.string() + "' could not be found." );
+    }
+    return "snapshot://" + path.string();
+}
+
+ConnectionInfoFiles::ConnectionInfoFiles(string dirpath)
+: dirpath(dirpath)
+{}
+
+string ConnectionInfoFiles::connection_string() const
+{
+    fs::path path(dirpath);
+    if (! fs::is_directory(path))
+    {
+        throw std::invalid_argument( "Files: '" +
+            path.string() + "' is not a directory." );
+    }
+    return "file://" + path.string();
+}
+
 
 ConstantSetInfo::ConstantSetInfo(
           int     run      ,
@@ -134,24 +186,61 @@ string ConstantSetInfo::constant_set_string(const string& table_path) const
     return ss.str();
 }
 
-unique_ptr<ConstantsDB> get_constants_db()
+shared_ptr<ConstantsDB> get_constants_db()
 {
     auto cinfo = ConnectionInfoMySQL();
     auto csinfo = ConstantSetInfo();
     return get_constants_db(cinfo,csinfo);
 }
 
-unsigned int ConstantsTable::find_column(const string& colname)
+unsigned int ConstantsTable::find_column(const string& colname) const
 {
-    return distance(
-        columns.begin(),
-        find(columns.begin(), columns.end(), colname) );
+    auto it = column_index.find(colname);
+    if (it == column_index.end())
+    {
+        throw std::invalid_argument( "No such column: '" +
+            colname + "' in table " + table_path );
+    }
+    return it->second;
+}
+
+namespace
+{
+
+typedef std::map<string, Assignment*> Assignments;
+
+/// makes tables from the assignments, which are deleted
+ConstantsTables make_tables(const Assignments& assignments)
+{
+    std::map<string, unique_ptr<Assignment>> owned;
+    for (const auto& a : assignments)
+    {
+        owned[a.first].reset(a.second);
+    }
+
+    ConstantsTables tables;
+    for (const auto& a : owned)
+    {
+        tables.emplace(a.first, ConstantsTable(*a.second, a.first));
+    }
+    return tables;
 }
 
+void ensure_connected(const shared_ptr<ConstantsDB>& db)
+{
+    if (!db->IsConnected())
+    {
+        db->Connect(db->GetConnectionString());
+    }
+}
+
+} // anonymous namespace
+
 ConstantsTable::ConstantsTable(
-    const unique_ptr<ConstantsDB>& db,
+    const shared_ptr<ConstantsDB>& db,
     const string& table_path )
-: table_path(table_path)
+: n_rows(0)
+, table_path(table_path)
 {
     bool disconnect = false;
     if (!db->IsConnected())
@@ -162,133 +251,358 @@ ConstantsTable::ConstantsTable(
 
     unique_ptr<Assignment> assignment(
         db->GetAssignment(table_path, true) );
-    values = assignment->GetData();
-    auto* type_table = assignment->GetTypeTable();
-    columns = type_table->GetColumnNames();
-    column_types = type_table->GetColumnTypeStrings();
+    if (!assignment)
+    {
+        throw std::invalid_argument( "No constants found for table: '" +
+            table_path + "'" );
+    }
+    load(*assignment);
 }
 
-string ConstantsTable::write_to_file(const string& fname, bool header)
+ConstantsTable::ConstantsTable(
+    const Assignment& assignment,
+    const string& table_path )
+: n_rows(0)
+, table_path(table_path)
 {
-    fs::path filepath;
-    if (fname == "")
+    load(assignment);
+}
+
+void ConstantsTable::load(const Assignment& assignment)
+{
+    valid_run_min = assignment.GetValidRunMin();
+    valid_run_max = assignment.GetValidRunMax();
+
+    auto* type_table = assignment.GetTypeTable();
+    columns = type_table->GetColumnNames();
+    column_types = type_table->GetColumnTypeStrings();
+
+    for (unsigned int c=0; c<columns.size(); c++)
     {
-        // dump data into a temporary file
-        filepath = std::tmpnam(nullptr);
+        column_index[columns[c]] = c;
     }
-    else
+
+    // binary constant sets are stored typed: take the columns as they are
+    const auto& binary_columns = assignment.GetBinaryColumns();
+    if (assignment.IsBinaryData() && binary_columns.size() == columns.size())
     {
-        filepath = fname;
-        if (fs::exists(filepath))
+        for (const auto& cells : binary_columns)
         {
-            stringstream err;
-            err << "Output file already exists: " << filepath << endl;
-            throw std::invalid_argument(err.str());
+            table.emplace_back(cells);
         }
+        n_rows = table.empty() ? 0 : table[0].size();
+        return;
     }
 
-    std::ofstream fout(filepath.string().c_str());
-    if (header)
+    // parse each column once into a buffer of its declared type,
+    // reading the cells in place so only one column is copied at a time
+    const auto& type_columns = type_table->GetColumns();
+    n_rows = type_columns.empty() ? 0
+           : assignment.GetCellsCount() / type_columns.size();
+    ColumnData cells(n_rows);
+    for (unsigned int c=0; c<type_columns.size(); c++)
     {
-        int maxwidth = 0;
-        for (auto c: this->columns)
+        for (unsigned int r=0; r<n_rows; r++)
         {
-            if (c.size() > maxwidth)
-            {
-                maxwidth = c.size();
-            }
+            cells[r] = assignment.GetCellView(r, c).ToString();
         }
-        for (auto t: this->column_types)
+        table.emplace_back(type_columns[c]->GetType(), cells);
+    }
+}
+
+ConstantsTables load_constants_tables(
+    const shared_ptr<ConstantsDB>& db,
+    const vector<string>& table_paths)
+{
+    ensure_connected(db);
+
+    Assignments assignments;
+    db->GetAssignments(assignments, table_paths);
+    ConstantsTables tables = make_tables(assignments);
+
+    for (const auto& path : table_paths)
+    {
+        if (tables.find(path) == tables.end())
         {
-            if (t.size() > maxwidth)
+            throw std::invalid_argument( "No constants found for table: '" +
+                path + "'" );
+        }
+    }
+    return tables;
+}
+
+ConstantsTables load_constants_directory(
+    const shared_ptr<ConstantsDB>& db,
+    const string& directory)
+{
+    ensure_connected(db);
+
+    Assignments assignments;
+    db->GetDirectoryAssignments(assignments, directory);
+    return make_tables(assignments);
+}
+
+void add_to_database(
+    const shared_ptr<ConstantsDB>& db,
+    const ConstantsTables& tables,
+    const string& variation,
+    const long int run_min,
+    const long int run_max,
+    const string& comment)
+{
+    ensure_connected(db);
+
+    // the type tables only carry the path, the provider finds them
+    vector<unique_ptr<ConstantsTypeTable>> type_tables;
+    vector<unique_ptr<Assignment>> owned;
+    vector<Assignment*> assignments;
+    for (const auto& t : tables)
+    {
+        const ConstantsTable& table = t.second;
+        string path = PathUtils::ParseRequest(t.first).Path;
+        path = PathUtils::MakeAbsolute(path);
+
+        vector<string> cells;
+        cells.reserve(table.nrows() * table.ncols());
+        for (unsigned int r=0; r<table.nrows(); r++)
+        {
+            for (unsigned int c=0; c<table.ncols(); c++)
             {
-                maxwidth = t.size();
+                cells.push_back(table.table[c].text(r));
             }
         }
-        maxwidth += 1;
 
-        fout << "#";
-        for (auto c : this->columns)
+        type_tables.emplace_back(new ConstantsTypeTable());
+        type_tables.back()->SetFullPath(path);
+
+        owned.emplace_back(new Assignment());
+        Assignment* assignment = owned.back().get();
+        assignment->SetTypeTable(type_tables.back().get());
+        assignment->SetRawData(Assignment::VectorToBlob(cells));
+        assignment->SetComment(comment);
+
+        // run range and variation are owned by the assignment
+        RunRange* run_range = new RunRange(assignment);
+        run_range->SetRange(run_min, run_max);
+        assignment->SetRunRange(run_range);
+        Variation* assignment_variation = new Variation(assignment);
+        assignment_variation->SetName(variation);
+        assignment->SetVariation(assignment_variation);
+
+        assignments.push_back(assignment);
+    }
+
+    if (! db->CreateAssignments(assignments))
+    {
+        stringstream err;
+        err << "Could not add " << tables.size() << " tables to '"
+            << db->GetConnectionString() << "'";
+        if (db->GetProvider() != nullptr)
         {
-            fout << setw(maxwidth) << c;
+            err << ", error " << db->GetProvider()->GetLastError();
         }
-        fout << "#";
-        for (auto t : this->column_types)
+        throw std::runtime_error(err.str());
+    }
+}
+
+namespace
+{
+
+/// column and its stored cells as handed to write_cell()
+struct CellSource
+{
+    ColumnType type;
+    const void* data;
+};
+
+void write_cell(TextWriter& out, const CellSource& src, size_t row)
+{
+    switch (src.type)
+    {
+        case ::ccdb::ConstantsTypeColumn::cIntColumn:
+            out.write(static_cast<const int*>(src.data)[row]); break;
+        case ::ccdb::ConstantsTypeColumn::cUIntColumn:
+            out.write(static_cast<const unsigned int*>(src.data)[row]); break;
+        case ::ccdb::ConstantsTypeColumn::cLongColumn:
+            out.write(static_cast<const long*>(src.data)[row]); break;
+        case ::ccdb::ConstantsTypeColumn::cULongColumn:
+            out.write(static_cast<const unsigned long*>(src.data)[row]); break;
+        case ::ccdb::ConstantsTypeColumn::cDoubleColumn:
+            out.write(static_cast<const double*>(src.data)[row]); break;
+        case ::ccdb::ConstantsTypeColumn::cBoolColumn:
+            out.write(static_cast<const bool*>(src.data)[row]); break;
+        default:
+            out.write(static_cast<const string*>(src.data)[row]); break;
+    }
+}
+
+/// writes the names right aligned in fields of width after a '#'
+void write_header_line(TextWriter& out, const vector<string>& names, size_t width)
+{
+    out.put('#');
+    for (const auto& name : names)
+    {
+        if (name.size() < width)
         {
-            fout << setw(maxwidth) << t;
+            out.fill(' ', width - name.size());
         }
+        out.write(name);
     }
+}
 
-    for (int r=0; r<nrows(); r++)
+} // anonymous namespace
+
+void ConstantsTable::write(TextWriter& out, bool header) const
+{
+    if (header)
     {
-        for (int c=0; c<ncols(); c++)
+        size_t maxwidth = 0;
+        for (const auto& c : columns)
+        {
+            maxwidth = std::max(maxwidth, c.size());
+        }
+        for (const auto& t : column_types)
+        {
+            maxwidth = std::max(maxwidth, t.size());
+        }
+        maxwidth += 1;
+
+        write_header_line(out, columns, maxwidth);
+        write_header_line(out, column_types, maxwidth);
+        out.put('\n');
+    }
+
+    vector<CellSource> sources(ncols());
+    for (size_t c=0; c<sources.size(); c++)
+    {
+        const Column& column = table[c];
+        sources[c].type = column.type();
+        switch (column.type())
+        {
+            case ::ccdb::ConstantsTypeColumn::cIntColumn:    sources[c].data = column.data<int>();           break;
+            case ::ccdb::ConstantsTypeColumn::cUIntColumn:   sources[c].data = column.data<unsigned int>();  break;
+            case ::ccdb::ConstantsTypeColumn::cLongColumn:   sources[c].data = column.data<long>();          break;
+            case ::ccdb::ConstantsTypeColumn::cULongColumn:  sources[c].data = column.data<unsigned long>(); break;
+            case ::ccdb::ConstantsTypeColumn::cDoubleColumn: sources[c].data = column.data<double>();        break;
+            case ::ccdb::ConstantsTypeColumn::cBoolColumn:   sources[c].data = column.data<bool>();          break;
+            default:                                         sources[c].data = column.data<string>();        break;
+        }
+    }
+
+    for (size_t r=0; r<nrows(); r++)
+    {
+        for (size_t c=0; c<sources.size(); c++)
         {
             if (c>0)
             {
-                fout << " ";
+                out.put(' ');
             }
-            fout << values[r][c];
+            write_cell(out, sources[c], r);
         }
-        fout << endl;
+        out.put('\n');
     }
-    fout.close();
-
-    return filepath.string();
 }
 
-void ConstantsTable::add_to_database(
-    const unique_ptr<ConstantsDB>& db,
-    const string& variation,
-    const long int run_min ,
-    const long int run_max )
+string ConstantsTable::write_to_file(const string& fname, bool header)
 {
-    fs::path filepath(this->write_to_file());
-
-    // fix connection string for python API
-    string connstr = db->GetConnectionString();
-    if (connstr.find("sqlite") != string::npos)
+    string filepath;
+    int fd;
+    if (fname == "")
     {
-        connstr.insert(7,"/");
+        // dump data into a new temporary file
+        filepath = (fs::temp_directory_path() / "clas12_ccdb_XXXXXX").string();
+        vector<char> name(filepath.begin(), filepath.end());
+        name.push_back('\0');
+        fd = ::mkstemp(name.data());
+        filepath = name.data();
     }
-
-    // build system call
-    stringstream cmd;
-    cmd << "clas12-ccdb"
-        << " -c " + connstr
-        << " add"
-        << " '" + table_path + "'"
-        << " -v '" + variation + "'";
-    if (run_min != 0)
+    else
     {
-        cmd << " -r " << run_min;
-        if (run_max != INT_MAX)
+        filepath = fname;
+        fd = ::open(filepath.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd < 0 && errno == EEXIST)
         {
-            cmd << "-" << run_max;
+            throw std::invalid_argument(
+                "Output file already exists: " + filepath);
         }
     }
-    else if (run_max != INT_MAX)
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not create output file: "
+            + filepath + ": " + std::strerror(errno));
+    }
+
+    try
     {
-        cmd << " -r -" << run_max;
+        TextWriter out(fd);
+        write(out, header);
+        out.flush();
     }
-    cmd << " " << filepath.string();
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0)
+    {
+        throw std::runtime_error("Could not write output file: "
+            + filepath + ": " + std::strerror(errno));
+    }
+
+    return filepath;
+}
 
-    // make system call
-    std::system(cmd.str().c_str());
+string ConstantsTable::to_string(bool header) const
+{
+    string ret;
+    {
+        TextWriter out(ret);
+        write(out, header);
+        out.flush();
+    }
+    return ret;
+}
 
-    // remove temporary file
-    fs::remove(filepath);
+void write_tables(
+    TextWriter& out,
+    const ConstantsTables& tables,
+    bool header)
+{
+    for (const auto& entry : tables)
+    {
+        out.write("#table ", 7).write(entry.first).put('\n');
+        entry.second.write(out, header);
+    }
+}
+
+void ConstantsTable::add_to_database(
+    const shared_ptr<ConstantsDB>& db,
+    const string& variation,
+    const long int run_min,
+    const long int run_max,
+    const string& comment)
+{
+    ConstantsTables tables;
+    tables.emplace(table_path, *this);
+    clas12::ccdb::add_to_database(db, tables, variation, run_min, run_max,
+                                  comment);
+}
+
+bool ConstantsTable::valid_for_run(int run) const
+{
+    return valid_run_min <= run && run <= valid_run_max;
 }
 
 unsigned int ConstantsTable::nrows() const
 {
-    return values.size();
+    return n_rows;
 }
 
 unsigned int ConstantsTable::ncols() const
 {
     if (this->nrows() > 0)
     {
-        return values.at(0).size();
+        return table.size();
     }
     else
     {
@@ -311,6 +625,11 @@ string ConstantsTable::coltype(const string& colname)
     return coltype(find_column(colname));
 }
 
+string ConstantsTable::coltype(const ColumnHandle& handle)
+{
+    return coltype(handle.index());
+}
+
 string ConstantsTable::coltype(const char* colname)
 {
     return coltype(string(colname));
@@ -322,5 +641,34 @@ unsigned int ConstantsTable::row(const string& colname, const char* val)
     return row<string>(colname, string(val));
 }
 
+const RowIndex& ConstantsTable::index(const vector<string>& colnames) const
+{
+    vector<unsigned int> key(colnames.size());
+    for (unsigned int k=0; k<colnames.size(); k++)
+    {
+        key[k] = find_column(colnames[k]);
+    }
+
+    std::lock_guard<std::mutex> lock(row_indexes_mutex.mutex);
+    auto& idx = row_indexes[key];
+    if (!idx)
+    {
+        vector<const Column*> key_columns;
+        for (auto c : key)
+        {
+            key_columns.push_back(&table.at(c));
+        }
+        idx.reset(new RowIndex(key_columns, colnames));
+    }
+    return *idx;
+}
+
+ColumnView<unsigned int> ConstantsTable::rows(
+    const vector<string>& colnames,
+    const vector<long>& keys) const
+{
+    return index(colnames).find(keys);
+}
+
 } // namespace clas12::ccdb
 } // namespace clas12
@@ -7,14 +7,23 @@
 #include <cstdlib>
 #include <ctime>
 #include <fstream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
 
 #include "CCDB/CalibrationGenerator.h"
 #include "CCDB/Calibration.h"
 
+#include "column.hpp"
+#include "constants_db_registry.hpp"
+#include "row_index.hpp"
+#include "text_writer.hpp"
+
 namespace clas12
 {
 namespace ccdb
@@ -28,6 +37,7 @@ using std::stringstream;
 using std::time;
 using std::time_t;
 using std::vector;
+using std::shared_ptr;
 using std::unique_ptr;
 
 typedef vector<string> ColumnData;
@@ -47,7 +57,8 @@ class ConnectionInfo
  *
  * forms the string:
  *     "mysql://clas12reader@clasdb.jlab.org:3306/clas12"
- * by default.
+ * by default. With pool_size > 1 the ConstantsDB loads tables of
+ * many threads at once through pool_size connections.
  *
  * \return the MySQL connection string
  **/
@@ -59,13 +70,15 @@ class ConnectionInfoMySQL : public ConnectionInfo
     string host;
     int port;
     string database;
+    int pool_size;
 
     ConnectionInfoMySQL(
         const string& user     = "clas12reader",
         const string& password = "",
         const string& host     = "clasdb.jlab.org",
               int     port     = 3306,
-        const string& database = "clas12");
+        const string& database = "clas12",
+              int     pool_size = 1);
 
     string connection_string() const;
 };
@@ -75,7 +88,8 @@ class ConnectionInfoMySQL : public ConnectionInfo
  *
  * forms the string:
  *     "sqlite:///clas12_ccdb.sqlite"
- * by default.
+ * by default. With pool_size > 1 the file is opened read only by
+ * pool_size connections, used by threads loading tables at once.
  *
  * \return the SQLite connection string
  **/
@@ -83,7 +97,46 @@ class ConnectionInfoSQLite : public ConnectionInfo
 {
   public:
     string filepath;
-    ConnectionInfoSQLite(string filepath = "clas12_ccdb.sqlite");
+    int pool_size;
+    ConnectionInfoSQLite(
+        string filepath = "clas12_ccdb.sqlite",
+        int pool_size = 1);
+    string connection_string() const;
+};
+
+/** \brief creates the connection string of a snapshot file made by
+ * clas12-ccdb-snapshot, to be used by SnapshotCalibration::Connect().
+ *
+ * forms the string:
+ *     "snapshot://clas12_ccdb.snapshot"
+ * by default. The snapshot holds the tables of one run, variation and
+ * time, the ConstantSetInfo has to ask for the same ones.
+ *
+ * \return the snapshot connection string
+ **/
+class ConnectionInfoSnapshot : public ConnectionInfo
+{
+  public:
+    string filepath;
+    ConnectionInfoSnapshot(string filepath = "clas12_ccdb.snapshot");
+    string connection_string() const;
+};
+
+/** \brief creates the connection string of a directory of table files,
+ * to be used by FileCalibration::Connect().
+ *
+ * forms the string:
+ *     "file://clas12_ccdb"
+ * by default. The directory has a file per assignment, named like
+ * "calibration/ftof/status.default.0-max.txt", see FileDataProvider.
+ *
+ * \return the file connection string
+ **/
+class ConnectionInfoFiles : public ConnectionInfo
+{
+  public:
+    string dirpath;
+    ConnectionInfoFiles(string dirpath = "clas12_ccdb");
     string connection_string() const;
 };
 
@@ -102,19 +155,46 @@ struct ConstantSetInfo
     string constant_set_string(const string& table_path) const;
 };
 
+/** \brief gets the ConstantsDB for a connection and constant set
+ *  from the process-wide ConstantsDBRegistry, connecting on the first
+ *  request.
+ *
+ * \return shared handle to the ConstantsDB
+ **/
 template <class ConnectionInfoType>
-unique_ptr<ConstantsDB> get_constants_db(
+shared_ptr<ConstantsDB> get_constants_db(
     const ConnectionInfoType& conn,
     const ConstantSetInfo& csinfo)
 {
     auto cinfo = dynamic_cast<const ConnectionInfo*>(&conn);
     string connstr = cinfo->connection_string();
-    CalibrationGenerator calibgen;
-    return unique_ptr<ConstantsDB>(calibgen.MakeCalibration(
-        connstr, csinfo.run, csinfo.variation, csinfo.timestamp ) );
+    return ConstantsDBRegistry::instance().get(
+        connstr, csinfo.run, csinfo.variation, csinfo.timestamp );
 }
 
-unique_ptr<ConstantsDB> get_constants_db();
+shared_ptr<ConstantsDB> get_constants_db();
+
+/** \brief a column of a ConstantsTable resolved by name with
+ *  ConstantsTable::handle(). Accessing a column through its handle
+ *  skips the name lookup, so code reading the same column many times
+ *  should look up the handle once and keep it.
+ **/
+class ColumnHandle
+{
+  private:
+    unsigned int idx;
+
+    explicit ColumnHandle(unsigned int idx)
+    : idx(idx)
+    {}
+
+    friend class ConstantsTable;
+
+  public:
+    /** \return index of the column in the table
+     **/
+    unsigned int index() const { return idx; }
+};
 
 /** \brief ConstantsTable is a conatiner class for any constants
  *  set. It will connect to the database when load_constants()
@@ -125,63 +205,161 @@ unique_ptr<ConstantsDB> get_constants_db();
 class ConstantsTable
 {
   private:
-    /// the table as filled by Calibration*
-    TableData values;
+    /// the table as filled by Calibration*, one typed buffer per column
+    vector<Column> table;
+
+    /// number of rows in the table
+    unsigned int n_rows;
 
     /// the names of the columns
     ColumnNames columns;
 
+    /// column index by name
+    std::unordered_map<string, unsigned int> column_index;
+
     /// the types of the columns in string form
     ColumnTypes column_types;
 
     /// table path in database
     string table_path;
 
-    /** \brief find the index of the column associated with the name
-     *  colname.
-     *
-     * \return column index of the column identified by colname
+    /** runs for which the database has the same constants as loaded.
+     *  Unknown if valid_run_min > valid_run_max.
      **/
-    unsigned int find_column(const string& colname);
+    int valid_run_min;
+    int valid_run_max;
 
-    /** \brief generic function to convert a string to any type (T)
-     *
+    /** row indexes built on demand by index(), by key column indices.
+     *  Dropped whenever the table is modified.
+     **/
+    mutable std::map<vector<unsigned int>, std::shared_ptr<const RowIndex>> row_indexes;
+
+    /// guards row_indexes against concurrent index() calls
+    mutable detail::OwnMutex row_indexes_mutex;
+
+    /** row() for integer values goes through the row index, unless
+     *  the column is stored as doubles or strings, which the index
+     *  does not take
      **/
     template <typename T>
-    T lexical_cast(const string& str)
+    unsigned int find_row(const string& colname, const T& val, std::true_type)
     {
-        T ret;
-        if (!(stringstream(str) >> ret))
+        auto type = table[find_column(colname)].type();
+        if (type == ::ccdb::ConstantsTypeColumn::cDoubleColumn
+         || type == ::ccdb::ConstantsTypeColumn::cStringColumn)
         {
-            stringstream ss;
-            ss << "Could not convert: '"
-               << str
-               << "' to a numeric type.";
-            throw std::invalid_argument(ss.str());
+            return find_row(colname, val, std::false_type());
         }
-        return ret;
+        auto found = index(vector<string>(1, colname)).find(static_cast<long>(val));
+        if (found.empty() || static_cast<T>(static_cast<long>(val)) != val)
+        {
+            no_such_value(colname, val);
+        }
+        return found[0];
     }
 
+    /// row() for anything else compares the cells one by one
     template <typename T>
-    string to_string(const T& val)
+    unsigned int find_row(const string& colname, const T& val, std::false_type)
+    {
+        ColumnHandle h = handle(colname);
+        for (unsigned int i=0; i<nrows(); i++)
+        {
+            if (elem<T>(h,i) == val)
+            {
+                return i;
+            }
+        }
+        no_such_value(colname, val);
+        return 0;
+    }
+
+    template <typename T>
+    void no_such_value(const string& colname, const T& val)
     {
         stringstream ss;
-        ss << val;
-        return ss.str();
+        ss << "No such value: " << val << " in column " << colname;
+        throw std::invalid_argument(ss.str());
     }
 
+    /** \brief find the index of the column associated with the name
+     *  colname.
+     *
+     * \throw std::invalid_argument if there is no such column
+     * \return column index of the column identified by colname
+     **/
+    unsigned int find_column(const string& colname) const;
+
+    /// fills the table from the data and the type table of assignment
+    void load(const ::ccdb::Assignment& assignment);
+
   public:
+    /** \brief loads the table at table_path for the run, variation
+     *  and timestamp of db.
+     *
+     * \throw std::invalid_argument if there are no constants for the table
+     **/
     ConstantsTable(
-        const unique_ptr<ConstantsDB>& db,
+        const shared_ptr<ConstantsDB>& db,
         const string& table_path );
 
+    /** \brief makes the table from an assignment already loaded from
+     *  the database, for example by load_constants_tables().
+     **/
+    ConstantsTable(
+        const ::ccdb::Assignment& assignment,
+        const string& table_path );
+
+    /** \brief writes the table as text, one row per line with the
+     *  cells separated by spaces. With header, the rows follow a line
+     *  "# names # types" of the column names and then the column
+     *  types, which FileDataProvider reads back.
+     *
+     * The cells are formatted from the typed columns straight into
+     * the buffer of out, see TextWriter.
+     **/
+    void write(TextWriter& out, bool header = true) const;
+
+    /** \brief writes the table as text, see write(), to the new file
+     *  fname, or to a new temporary file if fname is empty.
+     *
+     * \throw std::invalid_argument if the file already exists
+     * \throw std::runtime_error if the file could not be written
+     * \return path to the file written
+     **/
     string write_to_file(const string& fname = "", bool header = true);
 
+    /** \return the table as text, see write()
+     **/
+    string to_string(bool header = true) const;
+
+    /** \brief adds this table to the database of db for the run range
+     *  and variation, see add_to_database(db, tables, ...).
+     *
+     * \throw std::runtime_error if the table could not be added
+     **/
     void add_to_database(
-        const unique_ptr<ConstantsDB>& db,
+        const shared_ptr<ConstantsDB>& db,
         const string& variation = "default",
         const long int run_min  = 0,
-        const long int run_max  = INT_MAX);
+        const long int run_max  = INT_MAX,
+        const string& comment   = "");
+
+    friend void add_to_database(
+        const shared_ptr<ConstantsDB>& db,
+        const std::map<string, ConstantsTable>& tables,
+        const string& variation,
+        const long int run_min,
+        const long int run_max,
+        const string& comment);
+
+    /** \brief tells if the constants loaded for one run are the same
+     *  the database has for run. Known only for tables loaded one by
+     *  one through a ConstantsDB; false for any other table.
+     *
+     * \return true if the table is valid for run
+     **/
+    bool valid_for_run(int run) const;
 
     /** \return number of rows in this data set.
      *
@@ -208,12 +386,36 @@ class ConstantsTable
      **/
     string coltype(const string& colname);
 
+    /** \return the column type of the column identified by handle
+     *
+     **/
+    string coltype(const ColumnHandle& handle);
+
     /** \brief specialization of coltype() for const char*
      *
      * \return the column type of the column identified by colname
      **/
     string coltype(const char* colname);
 
+    /** \brief resolves a column name once so that the column can be
+     *  accessed without looking the name up again.
+     *
+     * typical usage:
+     *
+     * auto left = table.handle("left");
+     * for (unsigned int i=0; i<nhits; i++)
+     * {
+     *     table.elem(left, i);
+     * }
+     *
+     * \throw std::invalid_argument if there is no such column
+     * \return ColumnHandle for the column identified by colname
+     **/
+    ColumnHandle handle(const string& colname) const
+    {
+        return ColumnHandle(find_column(colname));
+    }
+
     /** \return vector<T=double> of a column identified by the
      *  colname.
      **/
@@ -221,17 +423,57 @@ class ConstantsTable
     vector<T> col(const string& colname)
     {
         vector<T> ret;
+        table.at(find_column(colname)).copy_to(ret);
+        return ret;
+    }
 
-        unsigned int col_idx = find_column(colname);
+    /** \return vector<T=double> of a column identified by handle
+     **/
+    template <typename T=double>
+    vector<T> col(const ColumnHandle& handle)
+    {
+        vector<T> ret;
+        table.at(handle.index()).copy_to(ret);
+        return ret;
+    }
 
-        for (int row_idx=0; row_idx<nrows(); row_idx++)
-        {
-            ret.push_back(
-                lexical_cast<T>(
-                    values.at(row_idx).at(col_idx) ) );
-        }
+    /** \brief read-only view over the column identified by colname,
+     *  converted to T (default: double) without copying into a new
+     *  vector.
+     *
+     * Only the column types (int, unsigned int, long, unsigned long,
+     * double, bool and string) can be viewed. Viewing a column as its
+     * own type costs nothing; any other type is converted once and
+     * kept with the table. The view is invalidated by modifying the
+     * column or destroying the table.
+     *
+     * typical usage:
+     *
+     * auto xdist = table.view("xdist");
+     * for (double x : xdist) { ... }
+     *
+     * \return ColumnView<T> over the column
+     **/
+    template <typename T=double>
+    ColumnView<T> view(const string& colname) const
+    {
+        return table.at(find_column(colname)).view<T>();
+    }
 
-        return ret;
+    /** \brief view over the column identified by index
+     **/
+    template <typename T=double>
+    ColumnView<T> view(const unsigned int& col) const
+    {
+        return table.at(col).view<T>();
+    }
+
+    /** \brief view over the column identified by handle
+     **/
+    template <typename T=double>
+    ColumnView<T> view(const ColumnHandle& handle) const
+    {
+        return table.at(handle.index()).view<T>();
     }
 
     /** \brief finds the element in the table associated with column
@@ -241,8 +483,7 @@ class ConstantsTable
     template <typename T=double>
     T elem(const unsigned int& col, const unsigned int& row=0)
     {
-        return lexical_cast<T>(
-            values.at(row).at(col) );
+        return table.at(col).get<T>(row);
     }
 
     /** \brief finds the element in the table associated with column
@@ -268,8 +509,16 @@ class ConstantsTable
     template <typename T=double>
     T elem(const string& colname, const unsigned int& row=0)
     {
-        return lexical_cast<T>(
-            values.at(row).at(find_column(colname)) );
+        return table.at(find_column(colname)).get<T>(row);
+    }
+
+    /** \brief finds the element in the table associated with column
+     * identified by handle and row specified (default row: 0)
+     **/
+    template <typename T=double>
+    T elem(const ColumnHandle& handle, const unsigned int& row=0)
+    {
+        return table.at(handle.index()).get<T>(row);
     }
 
     /** \brief find the first row of a specified column that has a
@@ -287,16 +536,7 @@ class ConstantsTable
     template <typename T>
     unsigned int row(const string& colname, const T& val)
     {
-        for (unsigned int i=0; i<nrows(); i++)
-        {
-            if (elem<T>(colname,i) == val)
-            {
-                return i;
-            }
-        }
-        stringstream ss;
-        ss << "No such value: " << val << " in column " << colname;
-        throw std::invalid_argument(ss.str());
+        return find_row(colname, val, std::is_integral<T>());
     }
 
     /** \brief specialization for char* (converting to string)
@@ -304,16 +544,56 @@ class ConstantsTable
      **/
     unsigned int row(const string& colname, const char* val);
 
+    /** \brief index of the rows by the values of one or more integer
+     *  key columns. The index is built on the first call for a set of
+     *  columns and kept until the table is modified.
+     *
+     * typical usage, for each hit:
+     *
+     * const RowIndex& idx = table.index({"sector","layer","component"});
+     * for (unsigned int r : idx.find(sector, layer, component))
+     * {
+     *     table.elem(ped, r);
+     * }
+     *
+     * index() and rows() may be called from several threads on a
+     * shared const table.
+     *
+     * \throw std::invalid_argument if a column does not exist or does
+     * not hold integers
+     * \return RowIndex over the columns identified by colnames
+     **/
+    const RowIndex& index(const vector<string>& colnames) const;
+
+    /** \brief finds all rows where the columns identified by colnames
+     *  have the values keys, using index().
+     *
+     * example:
+     *   table.rows({"sector","layer","component"}, {1,2,3})
+     *
+     * \return indices of the matching rows in increasing order (empty
+     * if there are none)
+     **/
+    ColumnView<unsigned int> rows(const vector<string>& colnames,
+                                  const vector<long>& keys) const;
+
     /** Overwrite values in a specific column with
      **/
     template <typename T>
     ConstantsTable& col(const string& colname, const vector<T>& coldata)
     {
-        unsigned int col_idx = find_column(colname);
-        for (int row_idx=0; row_idx<nrows(); row_idx++)
-        {
-            values[row_idx][col_idx] = to_string(coldata[row_idx]);
-        }
+        table.at(find_column(colname)).set(coldata);
+        row_indexes.clear();
+        return *this;
+    }
+
+    /** Overwrite values in the column identified by handle
+     **/
+    template <typename T>
+    ConstantsTable& col(const ColumnHandle& handle, const vector<T>& coldata)
+    {
+        table.at(handle.index()).set(coldata);
+        row_indexes.clear();
         return *this;
     }
 
@@ -324,12 +604,95 @@ class ConstantsTable
                          const unsigned int& row,
                          T val)
     {
-        values[row][find_column(colname)] = to_string(val);
+        table.at(find_column(colname)).set(row, val);
+        row_indexes.clear();
+        return *this;
+    }
+
+    /** Overwrite value in the column identified by handle
+     **/
+    template <typename T>
+    ConstantsTable& elem(const ColumnHandle& handle,
+                         const unsigned int& row,
+                         T val)
+    {
+        table.at(handle.index()).set(row, val);
+        row_indexes.clear();
         return *this;
     }
 
 };
 
+typedef std::map<string, ConstantsTable> ConstantsTables;
+
+/** \brief loads many tables of the constant set of db at once.
+ *
+ * All tables are resolved together with a few database queries,
+ * instead of several queries per table as one ConstantsTable at a
+ * time would do. The table paths may carry their own run, variation
+ * and timestamp as in "/path/to/table:run:variation:timestamp".
+ *
+ * typical usage, on each run change:
+ *
+ * auto db = get_constants_db(conn, ConstantSetInfo(run));
+ * auto tables = load_constants_tables(db, {"/calibration/ftof/status",
+ *                                          "/geometry/target"});
+ * tables.at("/geometry/target").elem("x");
+ *
+ * \throw std::invalid_argument if a table has no constants
+ * \return tables by table path as given
+ **/
+ConstantsTables load_constants_tables(
+    const shared_ptr<ConstantsDB>& db,
+    const vector<string>& table_paths);
+
+/** \brief loads all tables in directory and its subdirectories at
+ *  once, like load_constants_tables(). Tables with no constants for
+ *  the run are left out.
+ *
+ * \return tables by absolute table path
+ **/
+ConstantsTables load_constants_directory(
+    const shared_ptr<ConstantsDB>& db,
+    const string& directory);
+
+/** \brief writes many tables as text, each table as write() does
+ *  following a line "#table <path>", for example a whole run to
+ *  standard output for comparison with another run:
+ *
+ * TextWriter out(TextWriter::standard_output);
+ * write_tables(out, load_constants_directory(db, "/"));
+ * out.flush();
+ **/
+void write_tables(
+    TextWriter& out,
+    const ConstantsTables& tables,
+    bool header = true);
+
+/** \brief adds many tables to the database of db in one transaction,
+ *  all for the same run range and variation.
+ *
+ * The tables are written by the database provider directly: the run
+ * range is created if it is not in the database, then the constant
+ * set and assignment of each table are inserted. Either all tables
+ * are added or none.
+ *
+ * typical usage, at the end of a calibration pass:
+ *
+ * ConstantsTables tables = load_constants_directory(db, "/calibration/ftof");
+ * tables.at("/calibration/ftof/status").elem("left", 0, 1);
+ * add_to_database(db, tables, "pass1", 5000, 5100);
+ *
+ * \throw std::runtime_error if the tables could not be added
+ **/
+void add_to_database(
+    const shared_ptr<ConstantsDB>& db,
+    const ConstantsTables& tables,
+    const string& variation = "default",
+    const long int run_min  = 0,
+    const long int run_max  = INT_MAX,
+    const string& comment   = "");
+
 } // namespace clas12::ccdb
 } // namespace clas12
 
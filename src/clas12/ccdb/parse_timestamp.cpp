@@ -1,10 +1,8 @@
 #include "parse_timestamp.hpp"
 
-#include <algorithm>
-#include <cctype>
-
-#include <boost/xpressive/xpressive.hpp>
-#include <boost/lexical_cast.hpp>
+#include <cstddef>
+#include <ctime>
+#include <string>
 
 
 namespace clas12
@@ -12,98 +10,144 @@ namespace clas12
 namespace ccdb
 {
 
-namespace xpr = boost::xpressive;
-
+using std::size_t;
 using std::string;
 using std::time_t;
 
 using std::tm;
 using std::mktime;
-using std::remove_if;
 
-using boost::lexical_cast;
-using xpr::sregex;
-using xpr::smatch;
-using xpr::regex_match;
+namespace
+{
+
+bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
 
 /**
- * convert to time_t object from string like:
+ * reads a string like:
  *
  * YYYY-MM-DD-hh-mm-ss
  *
- * where the "-" above are any non-digit characters.
- * For example, this is a valid string:
+ * into t, where the "-" above are any single non-digit character or
+ * nothing. For example, these are valid strings:
  *
  * 2015-03-20/00:00:00
+ * 20150320000000
+ * 2015-03
+ *
+ * Fields left out from the end are set to the end of the period
+ * given: month 12, day 31, 23:59:59. A single separator may follow
+ * the date when no more than two fields are given. The fields are
+ * not checked for range, mktime() normalizes them.
  *
+ * \return false if input is not a timestamp
  **/
-time_t parse_timestamp(const string& input)
+bool parse_fields(const char* input, size_t length, tm& t)
 {
-    string str = R"(
-    (\d{4})
-    (?:
-        [^\d]?
-        (\d{2})
-        (?:
-            [^\d]?
-            (\d{2})
-        )?
-    )?
-    [^\d]?
-    (?:
-        (\d{2})
-        (?:
-            [^\d]?
-            (\d{2})
-            (?:
-                [^\d]?
-                (\d{2})
-            )?
-        )?
-    )?
-    )";
-    str.erase(
-        remove_if(str.begin(), str.end(), ::isspace),
-        str.end() );
-
-    sregex re = sregex::compile(str);
-
-    tm t;
+    t = tm();
     t.tm_mon = 11;
     t.tm_mday = 31;
     t.tm_hour = 23;
     t.tm_min = 59;
     t.tm_sec = 59;
-
     t.tm_isdst = -1;
 
-    time_t ret(0);
-    smatch what;
-    if(regex_match(input, what, re))
+    const char* p = input;
+    const char* last = input + length;
+
+    if (last - p < 4)
+    {
+        return false;
+    }
+    int year = 0;
+    for (int i=0; i<4; i++, p++)
+    {
+        if (!is_digit(*p))
+        {
+            return false;
+        }
+        year = year*10 + (*p - '0');
+    }
+    t.tm_year = year - 1900;
+
+    int* fields[] = {&t.tm_mon, &t.tm_mday, &t.tm_hour, &t.tm_min, &t.tm_sec};
+    int nfields = 0;
+    while (p != last && nfields < 5)
     {
-        t.tm_year = lexical_cast<int>(what[1]) - 1900;
-        if (what[2] != "")
+        const char* field = is_digit(*p) ? p : p + 1;
+        if (last - field < 2 || !is_digit(field[0]) || !is_digit(field[1]))
         {
-            t.tm_mon = lexical_cast<int>(what[2]) - 1;
-            if (what[3] != "")
-            {
-                t.tm_mday = lexical_cast<int>(what[3]);
-                if (what[4] != "")
-                {
-                    t.tm_hour = lexical_cast<int>(what[4]);
-                    if (what[5] != "")
-                    {
-                        t.tm_min = lexical_cast<int>(what[5]);
-                        if (what[6] != "")
-                        {
-                            t.tm_sec = lexical_cast<int>(what[6]);
-                        }
-                    }
-                }
-            }
+            break;
         }
-        ret = mktime(&t);
+        int val = (field[0] - '0')*10 + (field[1] - '0');
+        *fields[nfields] = nfields == 0 ? val - 1 : val;
+        nfields++;
+        p = field + 2;
+    }
+
+    // the separator before the hour may end the string
+    if (p != last && nfields <= 2 && !is_digit(*p))
+    {
+        p++;
+    }
+    return p == last;
+}
+
+/// days since 1970-01-01 of the proleptic Gregorian date
+long days_from_civil(long y, long m, long d)
+{
+    y -= m <= 2;
+    const long era = (y >= 0 ? y : y - 399) / 400;
+    const long yoe = y - era * 400;
+    const long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+} // anonymous namespace
+
+time_t parse_timestamp(const char* input, size_t length)
+{
+    tm t;
+    if (!parse_fields(input, length, t))
+    {
+        return time_t(0);
+    }
+    time_t ret = mktime(&t);
+    if (ret == -1)
+    {
+        ret = time_t(0);
+    }
+    return ret;
+}
+
+time_t parse_timestamp(const string& input)
+{
+    return parse_timestamp(input.data(), input.size());
+}
+
+time_t parse_timestamp_utc(const char* input, size_t length)
+{
+    tm t;
+    if (!parse_fields(input, length, t))
+    {
+        return time_t(0);
+    }
+    // months out of range carry into the year as mktime() would;
+    // days, hours and so on simply add up
+    long year = t.tm_year + 1900L + t.tm_mon / 12;
+    long mon = t.tm_mon % 12;
+    if (mon < 0)
+    {
+        mon += 12;
+        year--;
     }
+    long days = days_from_civil(year, mon + 1, 1) + t.tm_mday - 1;
+    time_t ret = static_cast<time_t>(days) * 86400
+               + t.tm_hour * 3600L + t.tm_min * 60L + t.tm_sec;
+    // as parse_timestamp(), which can not tell -1 from a failure
     if (ret == -1)
     {
         ret = time_t(0);
@@ -111,5 +155,10 @@ time_t parse_timestamp(const string& input)
     return ret;
 }
 
+time_t parse_timestamp_utc(const string& input)
+{
+    return parse_timestamp_utc(input.data(), input.size());
+}
+
 } // namespace clas12::ccdb
 } // namespace clas12
@@ -1,6 +1,7 @@
 #ifndef CLAS12_CCDB_PARSE_TIMESTAMP_HPP
 #define CLAS12_CCDB_PARSE_TIMESTAMP_HPP
 
+#include <cstddef>
 #include <ctime>
 #include <string>
 
@@ -9,8 +10,24 @@ namespace clas12
 namespace ccdb
 {
 
+/** \brief local time of a string like "2015-03-20/00:00:00", see
+ *  parse_timestamp.cpp for the accepted forms.
+ *
+ * \return the time, or 0 if input is not a timestamp
+ **/
 std::time_t parse_timestamp(const std::string& input);
 
+/** \brief parse_timestamp() of the length characters at input, which
+ *  need not be null terminated.
+ **/
+std::time_t parse_timestamp(const char* input, std::size_t length);
+
+/** \brief like parse_timestamp() with input taken as UTC, which does
+ *  not need the time zone of the process.
+ **/
+std::time_t parse_timestamp_utc(const std::string& input);
+std::time_t parse_timestamp_utc(const char* input, std::size_t length);
+
 } // namespace clas12::ccdb
 } // namespace clas12
 
@@ -0,0 +1,137 @@
+#include "row_index.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace clas12
+{
+namespace ccdb
+{
+
+using std::string;
+using std::stringstream;
+using std::vector;
+
+namespace
+{
+
+/// orders rows by their keys and probes against rows
+struct key_less
+{
+    const long* keys;
+    size_t n;
+
+    bool operator()(unsigned int a, unsigned int b) const
+    {
+        const long* ka = keys + a*n;
+        const long* kb = keys + b*n;
+        for (size_t i=0; i<n; i++)
+        {
+            if (ka[i] != kb[i])
+            {
+                return ka[i] < kb[i];
+            }
+        }
+        return a < b;
+    }
+
+    bool operator()(unsigned int row, const long* key) const
+    {
+        return std::lexicographical_compare(
+            keys + row*n, keys + (row+1)*n, key, key+n);
+    }
+
+    bool operator()(const long* key, unsigned int row) const
+    {
+        return std::lexicographical_compare(
+            key, key+n, keys + row*n, keys + (row+1)*n);
+    }
+};
+
+} // anonymous namespace
+
+RowIndex::RowIndex(
+    const vector<const Column*>& key_columns,
+    const vector<string>& key_names)
+: n_keys(key_columns.size())
+{
+    if (n_keys == 0)
+    {
+        throw std::invalid_argument("No key columns given for row index.");
+    }
+
+    size_t n_rows = key_columns[0]->size();
+    keys.resize(n_rows * n_keys);
+    for (size_t k=0; k<n_keys; k++)
+    {
+        if (key_columns[k]->type() == ::ccdb::ConstantsTypeColumn::cDoubleColumn)
+        {
+            throw std::invalid_argument( "Column: '" + key_names[k] +
+                "' is not an integer column and can not be used as a key." );
+        }
+        for (size_t r=0; r<n_rows; r++)
+        {
+            keys[r*n_keys + k] = key_columns[k]->get<long>(r);
+        }
+    }
+
+    order.resize(n_rows);
+    for (size_t r=0; r<n_rows; r++)
+    {
+        order[r] = r;
+    }
+    key_less less = { keys.data(), n_keys };
+    std::sort(order.begin(), order.end(), less);
+}
+
+void RowIndex::check_nkeys(size_t nk) const
+{
+    if (nk != n_keys)
+    {
+        stringstream ss;
+        ss << "Row index has " << n_keys << " key columns, "
+           << nk << " keys given.";
+        throw std::invalid_argument(ss.str());
+    }
+}
+
+ColumnView<unsigned int> RowIndex::find(const long* key) const
+{
+    key_less less = { keys.data(), n_keys };
+    auto range = std::equal_range(order.begin(), order.end(), key, less);
+    return ColumnView<unsigned int>(
+        order.data() + (range.first - order.begin()),
+        range.second - range.first);
+}
+
+ColumnView<unsigned int> RowIndex::find(const vector<long>& key) const
+{
+    check_nkeys(key.size());
+    return find(key.data());
+}
+
+ColumnView<unsigned int> RowIndex::find(long k0) const
+{
+    check_nkeys(1);
+    return find(&k0);
+}
+
+ColumnView<unsigned int> RowIndex::find(long k0, long k1) const
+{
+    check_nkeys(2);
+    long key[] = {k0, k1};
+    return find(key);
+}
+
+ColumnView<unsigned int> RowIndex::find(long k0, long k1, long k2) const
+{
+    check_nkeys(3);
+    long key[] = {k0, k1, k2};
+    return find(key);
+}
+
+} // namespace clas12::ccdb
+} // namespace clas12
@@ -0,0 +1,78 @@
+#ifndef CLAS12_CCDB_ROW_INDEX_HPP
+#define CLAS12_CCDB_ROW_INDEX_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "column.hpp"
+
+namespace clas12
+{
+namespace ccdb
+{
+
+using std::size_t;
+using std::string;
+using std::vector;
+
+/** \brief sorted index of the rows of a table by the values of one or
+ *  more integer key columns, for example (sector, layer, component).
+ *
+ *  The key of every row is read once when the index is built and the
+ *  rows are sorted by it, so that a lookup is a binary search. All
+ *  rows matching a key are returned, in table order.
+ **/
+class RowIndex
+{
+  private:
+    /// number of key columns
+    size_t n_keys;
+
+    /// keys of all rows, n_keys values per row
+    vector<long> keys;
+
+    /// row indices sorted by key (and by row for equal keys)
+    vector<unsigned int> order;
+
+    /// throws unless nk keys were given
+    void check_nkeys(size_t nk) const;
+
+  public:
+    /** \brief builds the index over the given key columns which must
+     *  hold integers.
+     *
+     * \throw std::invalid_argument if a column is a floating point
+     * column or has cells that are not integers
+     **/
+    RowIndex(const vector<const Column*>& key_columns,
+             const vector<string>& key_names);
+
+    /** \return number of key columns
+     **/
+    size_t nkeys() const { return n_keys; }
+
+    /** \return the rows whose key columns equal key[0..nkeys()-1]
+     **/
+    ColumnView<unsigned int> find(const long* key) const;
+
+    /** \return the rows whose key columns equal key
+     * \throw std::invalid_argument if key.size() != nkeys()
+     **/
+    ColumnView<unsigned int> find(const vector<long>& key) const;
+
+    /** \brief lookups by one, two or three keys without building a
+     *  vector for the key.
+     *
+     * \throw std::invalid_argument if the index has a different number
+     * of key columns
+     **/
+    ColumnView<unsigned int> find(long k0) const;
+    ColumnView<unsigned int> find(long k0, long k1) const;
+    ColumnView<unsigned int> find(long k0, long k1, long k2) const;
+};
+
+} // namespace clas12::ccdb
+} // namespace clas12
+
+#endif // CLAS12_CCDB_ROW_INDEX_HPP
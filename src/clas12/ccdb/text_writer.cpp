@@ -0,0 +1,179 @@
+#include "text_writer.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include "column.hpp"
+
+namespace clas12
+{
+namespace ccdb
+{
+
+using std::string;
+using std::stringstream;
+
+namespace
+{
+
+/// write() of all n characters, retried when interrupted or partial
+void write_all(int fd, const char* data, size_t n)
+{
+    while (n > 0)
+    {
+        ssize_t written = ::write(fd, data, n);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            stringstream ss;
+            ss << "Could not write to file descriptor " << fd
+               << ": " << std::strerror(errno);
+            throw std::runtime_error(ss.str());
+        }
+        data += written;
+        n -= written;
+    }
+}
+
+} // anonymous namespace
+
+const int TextWriter::standard_output;
+const size_t TextWriter::default_capacity;
+
+TextWriter::TextWriter(int fd, size_t capacity)
+: fd(fd)
+, str(nullptr)
+, buf(new char[capacity < 64 ? 64 : capacity])
+, capacity(capacity < 64 ? 64 : capacity)
+, used(0)
+{}
+
+TextWriter::TextWriter(string& out, size_t capacity)
+: fd(-1)
+, str(&out)
+, buf(new char[capacity < 64 ? 64 : capacity])
+, capacity(capacity < 64 ? 64 : capacity)
+, used(0)
+{}
+
+TextWriter::~TextWriter()
+{
+    try
+    {
+        flush();
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+}
+
+void TextWriter::flush()
+{
+    if (used == 0)
+    {
+        return;
+    }
+    size_t n = used;
+    used = 0;
+    if (str != nullptr)
+    {
+        str->append(buf.get(), n);
+    }
+    else
+    {
+        write_all(fd, buf.get(), n);
+    }
+}
+
+TextWriter& TextWriter::write(const char* data, size_t n)
+{
+    if (n > capacity - used)
+    {
+        flush();
+        if (n >= capacity)
+        {
+            // too large to be worth copying
+            if (str != nullptr)
+            {
+                str->append(data, n);
+            }
+            else
+            {
+                write_all(fd, data, n);
+            }
+            return *this;
+        }
+    }
+    std::memcpy(buf.get() + used, data, n);
+    used += n;
+    return *this;
+}
+
+TextWriter& TextWriter::fill(char c, size_t n)
+{
+    while (n > 0)
+    {
+        reserve(1);
+        size_t chunk = capacity - used < n ? capacity - used : n;
+        std::memset(buf.get() + used, c, chunk);
+        used += chunk;
+        n -= chunk;
+    }
+    return *this;
+}
+
+template <typename Unsigned>
+void TextWriter::put_unsigned(Unsigned val)
+{
+    char digits[3*sizeof(Unsigned)];
+    size_t nd = 0;
+    do
+    {
+        digits[nd++] = static_cast<char>('0' + val % 10);
+        val /= 10;
+    } while (val != 0);
+
+    reserve(nd);
+    while (nd > 0)
+    {
+        buf[used++] = digits[--nd];
+    }
+}
+
+TextWriter& TextWriter::write(long val)
+{
+    if (val < 0)
+    {
+        put('-');
+        put_unsigned(-static_cast<unsigned long>(val));
+    }
+    else
+    {
+        put_unsigned(static_cast<unsigned long>(val));
+    }
+    return *this;
+}
+
+TextWriter& TextWriter::write(unsigned long val)
+{
+    put_unsigned(val);
+    return *this;
+}
+
+TextWriter& TextWriter::write(double val)
+{
+    reserve(detail::double_text_size);
+    used += detail::print_value(buf.get() + used, val);
+    return *this;
+}
+
+} // namespace clas12::ccdb
+} // namespace clas12
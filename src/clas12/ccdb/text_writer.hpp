@@ -0,0 +1,118 @@
+#ifndef CLAS12_CCDB_TEXT_WRITER_HPP
+#define CLAS12_CCDB_TEXT_WRITER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace clas12
+{
+namespace ccdb
+{
+
+using std::size_t;
+using std::string;
+using std::unique_ptr;
+
+/** \brief buffered writer of table text to a file descriptor or to a
+ *  string.
+ *
+ *  Numbers are formatted directly into one reusable buffer which is
+ *  handed to the output with a single write() once it is full, so
+ *  writing a table costs a system call per buffer rather than per row
+ *  or per cell. Doubles are written as ConstantsTable::elem<string>()
+ *  shows them.
+ *
+ *  typical usage, dumping tables to standard output:
+ *
+ *  TextWriter out(TextWriter::standard_output);
+ *  write_tables(out, tables);
+ *  out.flush();
+ **/
+class TextWriter
+{
+  private:
+    /// file descriptor written to, or -1 when writing to str
+    int fd;
+
+    /// string appended to when fd is -1
+    string* str;
+
+    unique_ptr<char[]> buf;
+    size_t capacity;
+    size_t used;
+
+    /// makes room for at least n more characters
+    void reserve(size_t n)
+    {
+        if (capacity - used < n)
+        {
+            flush();
+        }
+    }
+
+    template <typename Unsigned>
+    void put_unsigned(Unsigned val);
+
+  public:
+    static const int standard_output = 1;
+    static const size_t default_capacity = 1 << 16;
+
+    /** \brief writes to the open file descriptor fd, which is not
+     *  closed by the writer.
+     **/
+    explicit TextWriter(int fd, size_t capacity = default_capacity);
+
+    /** \brief appends to out, which must outlive the writer
+     **/
+    explicit TextWriter(string& out, size_t capacity = default_capacity);
+
+    /** \brief flushes what is left, ignoring errors; call flush()
+     *  first to have them reported.
+     **/
+    ~TextWriter();
+
+    TextWriter(const TextWriter&) = delete;
+    TextWriter& operator=(const TextWriter&) = delete;
+
+    /** \brief hands the buffered text to the output
+     *
+     * \throw std::runtime_error if the file could not be written
+     **/
+    void flush();
+
+    TextWriter& put(char c)
+    {
+        reserve(1);
+        buf[used++] = c;
+        return *this;
+    }
+
+    TextWriter& write(const char* data, size_t n);
+
+    TextWriter& write(const string& val)
+    {
+        return write(val.data(), val.size());
+    }
+
+    TextWriter& write(const char* val)
+    {
+        return write(val, std::strlen(val));
+    }
+
+    /// writes c n times
+    TextWriter& fill(char c, size_t n);
+
+    TextWriter& write(int val)           { return write(static_cast<long>(val)); }
+    TextWriter& write(unsigned int val)  { return write(static_cast<unsigned long>(val)); }
+    TextWriter& write(long val);
+    TextWriter& write(unsigned long val);
+    TextWriter& write(double val);
+    TextWriter& write(bool val)          { return val ? write("true", 4) : write("false", 5); }
+};
+
+} // namespace clas12::ccdb
+} // namespace clas12
+
+#endif // CLAS12_CCDB_TEXT_WRITER_HPP
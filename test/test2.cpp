@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "clas12/ccdb/constants_table.hpp"
+
+using namespace std;
+using namespace clas12::ccdb;
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+/** microbenchmark: reading a column through col<double>(), which
+ *  copies into a new vector on each call, against view<double>().
+ *
+ *  usage: test2 [table path] [column name] [iterations]
+ **/
+int main(int argc, char** argv)
+{
+    string table_path = argc > 1 ? argv[1] : "/calibration/ftof/status";
+    string colname    = argc > 2 ? argv[2] : "right";
+    int niter         = argc > 3 ? atoi(argv[3]) : 100000;
+
+    auto cinfo = ConnectionInfoSQLite("clas12.sqlite");
+    auto csinfo = ConstantSetInfo(0);
+    auto db = get_constants_db(cinfo, csinfo);
+
+    auto table = ConstantsTable(db, table_path);
+
+    double sum_col = 0;
+    auto start = steady_clock::now();
+    for (int i=0; i<niter; i++)
+    {
+        for (double x : table.col<double>(colname))
+        {
+            sum_col += x;
+        }
+    }
+    duration<double> t_col = steady_clock::now() - start;
+
+    double sum_view = 0;
+    start = steady_clock::now();
+    for (int i=0; i<niter; i++)
+    {
+        for (double x : table.view<double>(colname))
+        {
+            sum_view += x;
+        }
+    }
+    duration<double> t_view = steady_clock::now() - start;
+
+    cout << table_path << ":" << colname
+         << " (" << table.nrows() << " rows, "
+         << niter << " iterations)\n";
+    cout << setw(20) << "col<double>():"
+         << setw(12) << t_col.count() << " s  (sum " << sum_col << ")\n";
+    cout << setw(20) << "view<double>():"
+         << setw(12) << t_view.count() << " s  (sum " << sum_view << ")\n";
+
+    return sum_col == sum_view ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clas12/ccdb/constants_table.hpp"
+
+using namespace std;
+using namespace clas12::ccdb;
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+/** multi-threaded benchmark: many threads loading tables of a range
+ *  of runs through one shared ConstantsDB. After the first pass the
+ *  assignments come from the cache of the ConstantsDB, so the
+ *  throughput should grow with the number of threads. With a pool
+ *  size > 1 loads that miss the cache use that many connections.
+ *
+ *  usage: test3 [table path] [max threads] [loads per thread] [runs]
+ *               [pool size]
+ **/
+int main(int argc, char** argv)
+{
+    string table_path = argc > 1 ? argv[1] : "/calibration/ftof/status";
+    unsigned int max_threads = argc > 2 ? atoi(argv[2])
+                             : max(1u, thread::hardware_concurrency());
+    int nloads = argc > 3 ? atoi(argv[3]) : 2000;
+    int nruns  = argc > 4 ? atoi(argv[4]) : 100;
+    int pool_size = argc > 5 ? atoi(argv[5]) : 1;
+
+    auto cinfo = ConnectionInfoSQLite("clas12.sqlite", pool_size);
+    auto csinfo = ConstantSetInfo(0);
+    auto db = get_constants_db(cinfo, csinfo);
+
+    // first pass fills the cache
+    for (int run=0; run<nruns; run++)
+    {
+        ConstantsTable(db, table_path + ":" + to_string(run));
+    }
+
+    cout << table_path << " (" << nloads << " loads per thread, "
+         << nruns << " runs)\n";
+    cout << setw(10) << "threads" << setw(14) << "loads/s"
+         << setw(10) << "speedup" << "\n";
+
+    double single = 0;
+    for (unsigned int nthreads=1; nthreads<=max_threads; nthreads*=2)
+    {
+        atomic<long> nrows(0);
+        vector<thread> threads;
+        auto start = steady_clock::now();
+        for (unsigned int t=0; t<nthreads; t++)
+        {
+            threads.emplace_back([&, t]()
+            {
+                for (int i=0; i<nloads; i++)
+                {
+                    int run = (t*nloads + i) % nruns;
+                    ConstantsTable table(db, table_path + ":" + to_string(run));
+                    nrows += table.nrows();
+                }
+            });
+        }
+        for (auto& th : threads)
+        {
+            th.join();
+        }
+        duration<double> elapsed = steady_clock::now() - start;
+
+        double rate = nthreads * nloads / elapsed.count();
+        if (nthreads == 1)
+        {
+            single = rate;
+        }
+        cout << setw(10) << nthreads << setw(14) << fixed << setprecision(0)
+             << rate << setw(10) << setprecision(2) << rate/single << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "clas12/ccdb/constants_table.hpp"
+
+using namespace std;
+using namespace clas12::ccdb;
+
+/** round trip: a table read from clas12.sqlite is written with
+ *  write_to_file() into a directory tree in the layout of
+ *  FileDataProvider, read back through file:// and compared with the
+ *  original, cell by cell as text.
+ *
+ *  usage: test4 [table path]
+ **/
+int main(int argc, char** argv)
+{
+    string table_path = argc > 1 ? argv[1] : "/calibration/ftof/status";
+
+    auto db = get_constants_db(ConnectionInfoSQLite("clas12.sqlite"),
+                               ConstantSetInfo(0));
+    auto table = ConstantsTable(db, table_path);
+
+    char rootname[] = "/tmp/clas12_ccdb_test4_XXXXXX";
+    if (::mkdtemp(rootname) == nullptr)
+    {
+        cerr << "could not create a temporary directory\n";
+        return 1;
+    }
+    string root = rootname;
+
+    // one directory per level of the table path
+    string dir = root;
+    size_t pos = 1;
+    size_t slash;
+    while ((slash = table_path.find('/', pos)) != string::npos)
+    {
+        dir += table_path.substr(pos - 1, slash - pos + 1);
+        ::mkdir(dir.c_str(), 0755);
+        pos = slash + 1;
+    }
+    string fname = dir + "/" + table_path.substr(pos) + ".default.0-max.txt";
+    table.write_to_file(fname);
+
+    auto filedb = get_constants_db(ConnectionInfoFiles(root),
+                                   ConstantSetInfo(0));
+    auto copy = ConstantsTable(filedb, table_path);
+
+    bool same = copy.nrows() == table.nrows()
+             && copy.to_string() == table.to_string();
+
+    cout << table_path << " (" << table.nrows() << " rows) through "
+         << fname << ": " << (same ? "same" : "different") << "\n";
+
+    ::unlink(fname.c_str());
+    for (; dir.size() > root.size(); dir.erase(dir.rfind('/')))
+    {
+        ::rmdir(dir.c_str());
+    }
+    ::rmdir(root.c_str());
+
+    return same ? 0 : 1;
+}
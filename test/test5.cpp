@@ -0,0 +1,42 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "clas12/ccdb/constants_table.hpp"
+
+using namespace std;
+using namespace clas12::ccdb;
+
+/** load_constants_tables() with one table asked for through several
+ *  namepaths that resolve to the same run, variation and time: each
+ *  namepath gets its own copy of the table.
+ *
+ *  usage: test5 [table path]
+ **/
+int main(int argc, char** argv)
+{
+    string table_path = argc > 1 ? argv[1] : "/calibration/ftof/status";
+
+    auto db = get_constants_db(ConnectionInfoSQLite("clas12.sqlite"),
+                               ConstantSetInfo(0));
+    auto table = ConstantsTable(db, table_path);
+
+    vector<string> namepaths = {
+        table_path,
+        table_path + "::default",
+        table_path + ":0",
+        table_path + ":0:default" };
+    auto tables = load_constants_tables(db, namepaths);
+
+    bool same = tables.size() == namepaths.size();
+    for (const auto& namepath : namepaths)
+    {
+        auto found = tables.find(namepath);
+        bool ok = found != tables.end()
+               && found->second.to_string() == table.to_string();
+        cout << namepath << ": " << (ok ? "same" : "different") << "\n";
+        same = same && ok;
+    }
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <unistd.h>
+
+#include "CCDB/CalibrationGenerator.h"
+#include "CCDB/Calibration.h"
+#include "CCDB/Helpers/SnapshotFile.h"
+#include "CCDB/Model/Assignment.h"
+#include "CCDB/Providers/DataProvider.h"
+
+using namespace std;
+
+using ::ccdb::Assignment;
+using ::ccdb::Calibration;
+using ::ccdb::CalibrationGenerator;
+using ::ccdb::SnapshotFile;
+
+/** the tables of a directory are written to a snapshot, as
+ *  clas12-ccdb-snapshot does, and the run span of each entry is
+ *  compared with the one of the same table read alone from
+ *  clas12.sqlite.
+ *
+ *  usage: test6 [run] [directory]
+ **/
+int main(int argc, char** argv)
+{
+    int run = argc > 1 ? atoi(argv[1]) : 12;
+    string directory = argc > 2 ? argv[2] : "/calibration/ftof";
+
+    unique_ptr<Calibration> calib(CalibrationGenerator::CreateCalibration(
+        string("sqlite://clas12.sqlite"), run, "default", 0));
+
+    map<string, Assignment*> assignments;
+    bool ok = calib->GetDirectoryAssignments(assignments, directory);
+
+    char fname[] = "/tmp/clas12_ccdb_test6_XXXXXX";
+    int fd = ::mkstemp(fname);
+    string error;
+    ok = ok && fd >= 0
+            && SnapshotFile::Write(fname, run, "default", 0, assignments, error);
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+    for (auto& assignment : assignments)
+    {
+        delete assignment.second;
+    }
+
+    SnapshotFile snapshot;
+    ok = ok && snapshot.Open(fname) && !snapshot.GetTables().empty();
+    if (!ok)
+    {
+        cerr << "could not write the snapshot of " << directory << " "
+             << error << snapshot.GetErrorMessage() << "\n";
+        ::unlink(fname);
+        return 1;
+    }
+
+    bool same = true;
+    for (const auto& entry : snapshot.GetTables())
+    {
+        const SnapshotFile::Table& table = entry.second;
+        unique_ptr<Assignment> source(calib->GetProvider()->GetAssignmentShort(
+            run, table.Path, string("default")));
+        bool ok = source
+               && table.ValidRunMin == source->GetValidRunMin()
+               && table.ValidRunMax == source->GetValidRunMax();
+        cout << table.Path << " " << table.ValidRunMin << "-"
+             << table.ValidRunMax << ": " << (ok ? "same" : "different")
+             << "\n";
+        same = same && ok;
+    }
+
+    snapshot.Close();
+    ::unlink(fname);
+    return same ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "CCDB/CalibrationGenerator.h"
+#include "CCDB/Calibration.h"
+#include "CCDB/Helpers/SnapshotFile.h"
+#include "CCDB/Model/Assignment.h"
+
+#include "clas12/ccdb/parse_timestamp.hpp"
+
+using namespace std;
+
+using ::ccdb::Assignment;
+using ::ccdb::Calibration;
+using ::ccdb::CalibrationGenerator;
+using ::ccdb::SnapshotFile;
+
+/** writes the constants of one run, variation and time to a snapshot
+ *  file. Production jobs open it with ConnectionInfoSnapshot instead
+ *  of querying the database, the file is mapped to memory and shared
+ *  by all jobs of a node.
+ *
+ *  usage: clas12-ccdb-snapshot <connection> <run> <variation> <time>
+ *                              <output> [table or directory]...
+ *
+ *  time is 0 for the latest constants or a timestamp like
+ *  "2017-10-01 12:00:00". Without tables all tables are written.
+ **/
+int main(int argc, char** argv)
+{
+    if (argc < 6)
+    {
+        cerr << "usage: " << argv[0] << " <connection> <run> <variation>"
+             << " <time> <output> [table or directory]...\n"
+             << "example: " << argv[0] << " sqlite://clas12.sqlite"
+             << " 11 default 0 run11.snapshot /calibration/ftof\n";
+        return 1;
+    }
+
+    string connstr = argv[1];
+    int run = atoi(argv[2]);
+    string variation = argv[3];
+    string timestr = argv[4];
+    string output = argv[5];
+
+    map<string, Assignment*> assignments;
+    try
+    {
+        time_t timestamp = (timestr == "0") ? 0
+                         : clas12::ccdb::parse_timestamp(timestr);
+
+        unique_ptr<Calibration> calib(CalibrationGenerator::CreateCalibration(
+            connstr, run, variation, timestamp));
+
+        vector<string> paths(argv + 6, argv + argc);
+        if (paths.empty())
+        {
+            paths.push_back("/");
+        }
+
+        vector<string> tables;
+        calib->GetListOfNamepaths(tables);
+
+        bool ok = true;
+        for (const string& path : paths)
+        {
+            string abspath = path[0] == '/' ? path : "/" + path;
+            bool is_table = false;
+            for (const string& table : tables)
+            {
+                if ("/" + table == abspath)
+                {
+                    is_table = true;
+                    break;
+                }
+            }
+
+            if (is_table)
+            {
+                ok = calib->GetAssignments(assignments, {abspath}) && ok;
+            }
+            else
+            {
+                ok = calib->GetDirectoryAssignments(assignments, abspath) && ok;
+            }
+        }
+        if (!ok)
+        {
+            throw runtime_error("error loading the assignments");
+        }
+
+        string error;
+        if (!SnapshotFile::Write(output, run, variation, timestamp,
+                                 assignments, error))
+        {
+            throw runtime_error(error);
+        }
+        cout << "wrote " << assignments.size() << " tables to "
+             << output << "\n";
+    }
+    catch (std::exception& e)
+    {
+        cerr << argv[0] << ": " << e.what() << "\n";
+        for (auto& assignment : assignments)
+        {
+            delete assignment.second;
+        }
+        return 1;
+    }
+
+    for (auto& assignment : assignments)
+    {
+        delete assignment.second;
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "CCDB/Providers/SQLiteIndexAdvisor.h"
+
+using namespace std;
+
+using ::ccdb::SQLiteIndexAdvisor;
+
+namespace
+{
+
+void print_plans(const vector<SQLiteIndexAdvisor::QueryPlan>& plans)
+{
+    for (const SQLiteIndexAdvisor::QueryPlan& plan : plans)
+    {
+        cout << (plan.HasFullScan ? "[scan] " : "[ok]   ") << plan.Name << "\n";
+        for (const string& step : plan.Steps)
+        {
+            cout << "           " << step << "\n";
+        }
+    }
+}
+
+void print_index(const SQLiteIndexAdvisor::Index& index)
+{
+    cout << "    " << index.Name << " ON " << index.Table << " (";
+    for (size_t i = 0; i < index.Columns.size(); i++)
+    {
+        cout << (i > 0 ? ", " : "") << index.Columns[i];
+    }
+    cout << ")\n";
+}
+
+} // anonymous namespace
+
+/** shows how SQLite runs the queries of the CCDB provider on a local
+ *  copy of the database and the indexes it lacks. With --create the
+ *  missing indexes are added and ANALYZE is run, which is worth doing
+ *  once after every download of a new sqlite file. With statistics
+ *  SQLite may still scan tables it finds small enough.
+ *
+ *  usage: clas12-ccdb-sqlite-indexes <file.sqlite> [--create]
+ *
+ *  returns 2 if indexes are missing and were not created.
+ **/
+int main(int argc, char** argv)
+{
+    bool create = argc == 3 && strcmp(argv[2], "--create") == 0;
+    if (argc < 2 || argc > 3 || (argc == 3 && !create))
+    {
+        cerr << "usage: " << argv[0] << " <file.sqlite> [--create]\n"
+             << "example: " << argv[0] << " clas12.sqlite --create\n";
+        return 1;
+    }
+
+    SQLiteIndexAdvisor advisor;
+    if (!advisor.Open(argv[1], !create))
+    {
+        cerr << advisor.GetErrorMessage() << "\n";
+        return 1;
+    }
+
+    vector<SQLiteIndexAdvisor::QueryPlan> plans;
+    vector<SQLiteIndexAdvisor::Index> missing;
+    if (!advisor.ExplainQueries(plans) || !advisor.FindMissingIndexes(missing))
+    {
+        cerr << advisor.GetErrorMessage() << "\n";
+        return 1;
+    }
+
+    print_plans(plans);
+    if (missing.empty())
+    {
+        cout << "\nno indexes are missing\n";
+    }
+    else
+    {
+        cout << "\nmissing indexes:\n";
+        for (const SQLiteIndexAdvisor::Index& index : missing)
+        {
+            print_index(index);
+        }
+    }
+
+    if (!create)
+    {
+        return missing.empty() ? 0 : 2;
+    }
+
+    vector<SQLiteIndexAdvisor::Index> created;
+    if (!advisor.CreateMissingIndexes(created))
+    {
+        cerr << advisor.GetErrorMessage() << "\n";
+        return 1;
+    }
+
+    cout << "\ncreated " << created.size() << " indexes and analyzed "
+         << argv[1] << "\n\n";
+    if (!advisor.ExplainQueries(plans))
+    {
+        cerr << advisor.GetErrorMessage() << "\n";
+        return 1;
+    }
+    print_plans(plans);
+    return 0;
+}